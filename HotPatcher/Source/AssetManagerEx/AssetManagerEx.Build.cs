@@ -13,7 +13,9 @@ public class AssetManagerEx : ModuleRules
             new string[] {
 				// ... add public include paths required here ...
                 Path.Combine(ModuleDirectory,"Public/Flib"),
-                Path.Combine(ModuleDirectory,"Public/Struct")
+                Path.Combine(ModuleDirectory,"Public/Struct"),
+                Path.Combine(ModuleDirectory,"Public/Profiler"),
+                Path.Combine(ModuleDirectory,"Public/AssetRegistry")
 			}
 			);
 				
@@ -47,6 +49,12 @@ public class AssetManagerEx : ModuleRules
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
+
+		// the change tracker watches the content directories in editor
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("DirectoryWatcher");
+		}
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
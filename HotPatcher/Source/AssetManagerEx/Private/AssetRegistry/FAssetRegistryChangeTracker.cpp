@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FAssetRegistryChangeTracker.h"
+#include "FLibAssetManageHelperEx.h"
+#include "FHotPatcherProfiler.h"
+#include "IAssetRegistryQuery.h"
+
+// engine header
+#include "AssetRegistryModule.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#if WITH_EDITOR
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#endif
+
+FAssetRegistryChangeTracker& FAssetRegistryChangeTracker::Get()
+{
+	static FAssetRegistryChangeTracker Tracker;
+	return Tracker;
+}
+
+void FAssetRegistryChangeTracker::StartTracking()
+{
+	check(IsInGameThread());
+	if (bTracking)
+		return;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FAssetRegistryChangeTracker::OnAssetAdded);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FAssetRegistryChangeTracker::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FAssetRegistryChangeTracker::OnAssetRenamed);
+	PackageSavedHandle = UPackage::PackageSavedEvent.AddRaw(this, &FAssetRegistryChangeTracker::OnPackageSaved);
+	WatchContentDirectories();
+	bTracking = true;
+	// the changes before tracking are unknown
+	bDatabaseCurrent = false;
+}
+
+void FAssetRegistryChangeTracker::StopTracking()
+{
+	if (!bTracking)
+		return;
+
+	if (FModuleManager::Get().IsModuleLoaded(TEXT("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::GetModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+	UPackage::PackageSavedEvent.Remove(PackageSavedHandle);
+	UnwatchContentDirectories();
+	bTracking = false;
+	bDatabaseCurrent = false;
+	ChangedPackages.Empty();
+	PendingFiles.Empty();
+}
+
+void FAssetRegistryChangeTracker::WatchContentDirectories()
+{
+#if WITH_EDITOR
+	IDirectoryWatcher* DirectoryWatcher = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")).Get();
+	if (!DirectoryWatcher)
+		return;
+
+	// e.g. /Game/,/Engine/ and the content of plugins
+	TArray<FString> RootContentPaths;
+	FPackageName::QueryRootContentPaths(RootContentPaths);
+	for (const auto& RootContentPath : RootContentPaths)
+	{
+		FString ContentDir;
+		if (!FPackageName::TryConvertLongPackageNameToFilename(RootContentPath, ContentDir))
+			continue;
+		ContentDir = FPaths::ConvertRelativePathToFull(ContentDir);
+		if (!FPaths::DirectoryExists(ContentDir))
+			continue;
+		FDelegateHandle Handle;
+		if (DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(ContentDir, IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FAssetRegistryChangeTracker::OnDirectoryChanged), Handle))
+		{
+			WatchedDirectories.Add(TPair<FString, FDelegateHandle>(ContentDir, Handle));
+		}
+	}
+#endif
+}
+
+void FAssetRegistryChangeTracker::UnwatchContentDirectories()
+{
+#if WITH_EDITOR
+	if (FModuleManager::Get().IsModuleLoaded(TEXT("DirectoryWatcher")))
+	{
+		IDirectoryWatcher* DirectoryWatcher = FModuleManager::GetModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")).Get();
+		for (const auto& WatchedDirectory : WatchedDirectories)
+		{
+			DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedDirectory.Key, WatchedDirectory.Value);
+		}
+	}
+#endif
+	WatchedDirectories.Empty();
+}
+
+void FAssetRegistryChangeTracker::ScanPendingFiles()
+{
+	check(IsInGameThread());
+	if (!PendingFiles.Num())
+		return;
+
+	// the deleted files are removed by the asset registry itself
+	TArray<FString> ModifiedFiles;
+	for (const auto& PendingFile : PendingFiles)
+	{
+		if (FPaths::FileExists(PendingFile))
+		{
+			ModifiedFiles.Add(PendingFile);
+		}
+	}
+	PendingFiles.Empty();
+	if (ModifiedFiles.Num())
+	{
+		// rescan so the guid of package is updated
+		IAssetRegistryQuery::Get().ScanModifiedFiles(ModifiedFiles);
+	}
+}
+
+void FAssetRegistryChangeTracker::RefreshAssetManagerDatabase(bool InForceRefresh)
+{
+	check(IsInGameThread());
+	if (!InForceRefresh && bTracking && bDatabaseCurrent && !ChangedPackages.Num())
+	{
+		UE_LOG(LogTemp, Log, TEXT("No asset changed since the last refresh,skip refreshing the asset manager database."));
+		return;
+	}
+
+	HOTPATCHER_SCOPED_TIMER(TEXT("RefreshAssetManagerDatabase"));
+	ScanPendingFiles();
+	UE_LOG(LogTemp, Log, TEXT("Refresh the asset manager database,%d packages changed%s."), ChangedPackages.Num(), InForceRefresh ? TEXT(",force refresh") : TEXT(""));
+	UFLibAssetManageHelperEx::UpdateAssetMangerDatabase(true);
+	ChangedPackages.Reset();
+	bDatabaseCurrent = bTracking;
+}
+
+void FAssetRegistryChangeTracker::MarkPackageChanged(FName InPackageName)
+{
+	ChangedPackages.Add(InPackageName);
+	++ChangeSerial;
+	PackageChangedEvent.Broadcast(InPackageName);
+}
+
+void FAssetRegistryChangeTracker::OnAssetAdded(const FAssetData& InAssetData)
+{
+	MarkPackageChanged(InAssetData.PackageName);
+}
+
+void FAssetRegistryChangeTracker::OnAssetRemoved(const FAssetData& InAssetData)
+{
+	MarkPackageChanged(InAssetData.PackageName);
+}
+
+void FAssetRegistryChangeTracker::OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath)
+{
+	MarkPackageChanged(InAssetData.PackageName);
+	MarkPackageChanged(*FPackageName::ObjectPathToPackageName(InOldObjectPath));
+}
+
+void FAssetRegistryChangeTracker::OnPackageSaved(const FString& InPackageFilename, UObject* InOuter)
+{
+	if (UPackage* Package = Cast<UPackage>(InOuter))
+	{
+		MarkPackageChanged(Package->GetFName());
+		return;
+	}
+	FString LongPackageName;
+	if (FPackageName::TryConvertFilenameToLongPackageName(InPackageFilename, LongPackageName))
+	{
+		MarkPackageChanged(*LongPackageName);
+	}
+}
+
+void FAssetRegistryChangeTracker::OnDirectoryChanged(const TArray<FFileChangeData>& InFileChanges)
+{
+#if WITH_EDITOR
+	for (const auto& FileChange : InFileChanges)
+	{
+		FString Filename = FPaths::ConvertRelativePathToFull(FileChange.Filename);
+		if (!FPackageName::IsPackageFilename(Filename))
+			continue;
+		FString LongPackageName;
+		if (!FPackageName::TryConvertFilenameToLongPackageName(Filename, LongPackageName))
+			continue;
+		PendingFiles.Add(Filename);
+		MarkPackageChanged(*LongPackageName);
+	}
+#endif
+}
@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FInMemoryAssetRegistryQuery.h"
+
+// engine header
+#include "Misc/Paths.h"
+
+void FInMemoryAssetRegistryQuery::AddAsset(const FString& InLongPackageName, FName InAssetClass, const FGuid& InPackageGuid)
+{
+	FString AssetName = FPaths::GetBaseFilename(InLongPackageName);
+	AddAsset(FAssetData(*InLongPackageName, *FPaths::GetPath(InLongPackageName), *AssetName, InAssetClass), InPackageGuid);
+}
+
+void FInMemoryAssetRegistryQuery::AddAsset(const FAssetData& InAssetData, const FGuid& InPackageGuid)
+{
+	if (!InAssetData.IsValid() || ObjectPathIndexs.Contains(InAssetData.ObjectPath))
+		return;
+	int32 AssetIndex = Assets.Add(InAssetData);
+	ObjectPathIndexs.Add(InAssetData.ObjectPath, AssetIndex);
+	PackageAssetIndexs.FindOrAdd(InAssetData.PackageName).Add(AssetIndex);
+	if (!PackageDatas.Contains(InAssetData.PackageName))
+	{
+		PathPackages.FindOrAdd(InAssetData.PackagePath).Add(InAssetData.PackageName);
+	}
+	PackageDatas.FindOrAdd(InAssetData.PackageName).PackageGuid = InPackageGuid;
+}
+
+void FInMemoryAssetRegistryQuery::AddDependency(FName InPackageName, FName InDependency)
+{
+	TArray<FName>& PackageDependencies = Dependencies.FindOrAdd(InPackageName);
+	if (PackageDependencies.Contains(InDependency))
+		return;
+	PackageDependencies.Add(InDependency);
+	Referencers.FindOrAdd(InDependency).Add(InPackageName);
+}
+
+void FInMemoryAssetRegistryQuery::Reset()
+{
+	Assets.Reset();
+	PackageAssetIndexs.Reset();
+	ObjectPathIndexs.Reset();
+	PackageDatas.Reset();
+	PathPackages.Reset();
+	Dependencies.Reset();
+	Referencers.Reset();
+}
+
+bool FInMemoryAssetRegistryQuery::GetAllAssets(TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const
+{
+	OutAssetData.Append(Assets);
+	return true;
+}
+
+bool FInMemoryAssetRegistryQuery::GetAssets(const FARFilter& InFilter, TArray<FAssetData>& OutAssetData)const
+{
+	for (const auto& AssetData : Assets)
+	{
+		if (IsFilterMatched(InFilter, AssetData))
+		{
+			OutAssetData.Add(AssetData);
+		}
+	}
+	return true;
+}
+
+bool FInMemoryAssetRegistryQuery::GetAssetsByPackageName(FName InPackageName, TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const
+{
+	if (const TArray<int32>* AssetIndexs = PackageAssetIndexs.Find(InPackageName))
+	{
+		for (int32 AssetIndex : *AssetIndexs)
+		{
+			OutAssetData.Add(Assets[AssetIndex]);
+		}
+	}
+	return true;
+}
+
+bool FInMemoryAssetRegistryQuery::GetAssetByObjectPath(FName InObjectPath, FAssetData& OutAssetData)const
+{
+	const int32* AssetIndex = ObjectPathIndexs.Find(InObjectPath);
+	if (!AssetIndex)
+		return false;
+	OutAssetData = Assets[*AssetIndex];
+	return true;
+}
+
+bool FInMemoryAssetRegistryQuery::GetDependencies(FName InPackageName, TArray<FName>& OutDependencies)const
+{
+	if (const TArray<FName>* PackageDependencies = Dependencies.Find(InPackageName))
+	{
+		OutDependencies.Append(*PackageDependencies);
+		return true;
+	}
+	return PackageDatas.Contains(InPackageName);
+}
+
+bool FInMemoryAssetRegistryQuery::GetReferencers(FName InPackageName, TArray<FName>& OutReferencers)const
+{
+	if (const TArray<FName>* PackageReferencers = Referencers.Find(InPackageName))
+	{
+		OutReferencers.Append(*PackageReferencers);
+		return true;
+	}
+	return PackageDatas.Contains(InPackageName);
+}
+
+const FAssetPackageData* FInMemoryAssetRegistryQuery::GetAssetPackageData(FName InPackageName)const
+{
+	return PackageDatas.Find(InPackageName);
+}
+
+bool FInMemoryAssetRegistryQuery::DoesPackageExist(const FString& InLongPackageName)const
+{
+	return PackageDatas.Contains(FName(*InLongPackageName, FNAME_Find));
+}
+
+void FInMemoryAssetRegistryQuery::GetSubPaths(const FString& InBasePath, TArray<FString>& OutPathList, bool bInRecurse)const
+{
+	FString BasePath = InBasePath;
+	BasePath.RemoveFromEnd(TEXT("/"));
+	BasePath += TEXT("/");
+
+	TSet<FString> SubPaths;
+	for (const auto& PackageData : PackageDatas)
+	{
+		// all parent directories of the package under the base path
+		FString PackagePath = FPaths::GetPath(PackageData.Key.ToString());
+		while (PackagePath.StartsWith(BasePath))
+		{
+			if (bInRecurse || PackagePath.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, BasePath.Len()) == INDEX_NONE)
+			{
+				SubPaths.Add(PackagePath);
+			}
+			PackagePath = FPaths::GetPath(PackagePath);
+		}
+	}
+	OutPathList.Append(SubPaths.Array());
+}
+
+void FInMemoryAssetRegistryQuery::EnumeratePackagesInPath(FName InPackagePath, TFunctionRef<bool(FName)> InFunc)const
+{
+	if (const TArray<FName>* Packages = PathPackages.Find(InPackagePath))
+	{
+		for (const auto& PackageName : *Packages)
+		{
+			if (!InFunc(PackageName))
+				return;
+		}
+	}
+}
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "IAssetRegistryQuery.h"
+
+// engine header
+#include "AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "HAL/PlatformFilemanager.h"
+
+namespace AssetRegistryQuery
+{
+	static FAssetRegistryQuery DefaultQuery;
+	static TSharedPtr<IAssetRegistryQuery, ESPMode::ThreadSafe> ReplacedQuery;
+	static thread_local const IAssetRegistryQuery* ThreadQuery = nullptr;
+
+	IAssetRegistry& GetAssetRegistry()
+	{
+		return FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	}
+}
+
+const IAssetRegistryQuery& IAssetRegistryQuery::Get()
+{
+	if (AssetRegistryQuery::ThreadQuery)
+	{
+		return *AssetRegistryQuery::ThreadQuery;
+	}
+	if (AssetRegistryQuery::ReplacedQuery.IsValid())
+	{
+		return *AssetRegistryQuery::ReplacedQuery;
+	}
+	return AssetRegistryQuery::DefaultQuery;
+}
+
+void IAssetRegistryQuery::Set(TSharedPtr<IAssetRegistryQuery, ESPMode::ThreadSafe> InQuery)
+{
+	AssetRegistryQuery::ReplacedQuery = InQuery;
+}
+
+bool IAssetRegistryQuery::IsFilterMatched(const FARFilter& InFilter, const FAssetData& InAssetData)
+{
+	if (InFilter.PackageNames.Num() && !InFilter.PackageNames.Contains(InAssetData.PackageName))
+		return false;
+	if (InFilter.ObjectPaths.Num() && !InFilter.ObjectPaths.Contains(InAssetData.ObjectPath))
+		return false;
+	if (InFilter.ClassNames.Num() && !InFilter.ClassNames.Contains(InAssetData.AssetClass))
+		return false;
+	if (InFilter.PackagePaths.Num())
+	{
+		bool bMatched = InFilter.PackagePaths.Contains(InAssetData.PackagePath);
+		if (!bMatched && InFilter.bRecursivePaths)
+		{
+			FString AssetPackagePath = InAssetData.PackagePath.ToString();
+			for (const auto& PackagePath : InFilter.PackagePaths)
+			{
+				FString FilterPackagePath = PackagePath.ToString();
+				if (AssetPackagePath.StartsWith(FilterPackagePath) && (FilterPackagePath.EndsWith(TEXT("/")) || AssetPackagePath[FilterPackagePath.Len()] == TEXT('/')))
+				{
+					bMatched = true;
+					break;
+				}
+			}
+		}
+		if (!bMatched)
+			return false;
+	}
+	return true;
+}
+
+bool FAssetRegistryQuery::GetAllAssets(TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const
+{
+	return AssetRegistryQuery::GetAssetRegistry().GetAllAssets(OutAssetData, bIncludeOnlyOnDiskAssets);
+}
+
+bool FAssetRegistryQuery::GetAssets(const FARFilter& InFilter, TArray<FAssetData>& OutAssetData)const
+{
+	return AssetRegistryQuery::GetAssetRegistry().GetAssets(InFilter, OutAssetData);
+}
+
+bool FAssetRegistryQuery::GetAssetsByPackageName(FName InPackageName, TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const
+{
+	return AssetRegistryQuery::GetAssetRegistry().GetAssetsByPackageName(InPackageName, OutAssetData, bIncludeOnlyOnDiskAssets);
+}
+
+bool FAssetRegistryQuery::GetAssetByObjectPath(FName InObjectPath, FAssetData& OutAssetData)const
+{
+	OutAssetData = AssetRegistryQuery::GetAssetRegistry().GetAssetByObjectPath(InObjectPath);
+	return OutAssetData.IsValid();
+}
+
+bool FAssetRegistryQuery::GetDependencies(FName InPackageName, TArray<FName>& OutDependencies)const
+{
+	return AssetRegistryQuery::GetAssetRegistry().GetDependencies(InPackageName, OutDependencies, EAssetRegistryDependencyType::Packages);
+}
+
+bool FAssetRegistryQuery::GetReferencers(FName InPackageName, TArray<FName>& OutReferencers)const
+{
+	// all reference types,the managers(e.g. primary asset id) is counted as a referencer without package name
+	TArray<FAssetIdentifier> Referencers;
+	if (!AssetRegistryQuery::GetAssetRegistry().GetReferencers(FAssetIdentifier{ InPackageName }, Referencers))
+		return false;
+	for (const auto& Referencer : Referencers)
+	{
+		OutReferencers.Add(Referencer.PackageName);
+	}
+	return true;
+}
+
+const FAssetPackageData* FAssetRegistryQuery::GetAssetPackageData(FName InPackageName)const
+{
+	return AssetRegistryQuery::GetAssetRegistry().GetAssetPackageData(InPackageName);
+}
+
+bool FAssetRegistryQuery::DoesPackageExist(const FString& InLongPackageName)const
+{
+	return FPackageName::DoesPackageExist(InLongPackageName);
+}
+
+void FAssetRegistryQuery::GetSubPaths(const FString& InBasePath, TArray<FString>& OutPathList, bool bInRecurse)const
+{
+	AssetRegistryQuery::GetAssetRegistry().GetSubPaths(InBasePath, OutPathList, bInRecurse);
+}
+
+void FAssetRegistryQuery::EnumeratePackagesInPath(FName InPackagePath, TFunctionRef<bool(FName)> InFunc)const
+{
+	FString PackageDir;
+	if (!FPackageName::TryConvertLongPackageNameToFilename(InPackagePath.ToString() + TEXT("/"), PackageDir))
+		return;
+
+	// the files of directory are visited one by one,the list of directory isn't kept
+	FPlatformFileManager::Get().GetPlatformFile().IterateDirectory(*PackageDir, [&InFunc](const TCHAR* InFilenameOrDirectory, bool bIsDirectory)->bool
+	{
+		if (bIsDirectory || !FPackageName::IsPackageFilename(InFilenameOrDirectory))
+			return true;
+		FString LongPackageName;
+		if (!FPackageName::TryConvertFilenameToLongPackageName(InFilenameOrDirectory, LongPackageName))
+			return true;
+		return InFunc(*LongPackageName);
+	});
+}
+
+void FAssetRegistryQuery::ScanModifiedFiles(const TArray<FString>& InFiles)const
+{
+	AssetRegistryQuery::GetAssetRegistry().ScanFilesSynchronous(InFiles, true);
+}
+
+FScopedAssetRegistryQuery::FScopedAssetRegistryQuery(TSharedPtr<IAssetRegistryQuery, ESPMode::ThreadSafe> InQuery)
+	: PreviousQuery(AssetRegistryQuery::ReplacedQuery)
+{
+	IAssetRegistryQuery::Set(InQuery);
+}
+
+FScopedAssetRegistryQuery::~FScopedAssetRegistryQuery()
+{
+	IAssetRegistryQuery::Set(PreviousQuery);
+}
+
+FScopedThreadAssetRegistryQuery::FScopedThreadAssetRegistryQuery(const IAssetRegistryQuery& InQuery)
+	: PreviousQuery(AssetRegistryQuery::ThreadQuery)
+{
+	AssetRegistryQuery::ThreadQuery = &InQuery;
+}
+
+FScopedThreadAssetRegistryQuery::~FScopedThreadAssetRegistryQuery()
+{
+	AssetRegistryQuery::ThreadQuery = PreviousQuery;
+}
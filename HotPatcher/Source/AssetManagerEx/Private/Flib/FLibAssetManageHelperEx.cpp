@@ -5,6 +5,9 @@
 #include "AssetManager/FAssetDependenciesInfo.h"
 #include "AssetManager/FAssetDependenciesDetail.h"
 #include "AssetManager/FFileArrayDirectoryVisitor.hpp"
+#include "FHotPatcherProfiler.h"
+#include "HotPatcherTrace.h"
+#include "IAssetRegistryQuery.h"
 
 #include "ARFilter.h"
 #include "Kismet/KismetStringLibrary.h"
@@ -14,11 +17,23 @@
 #include "IPluginManager.h"
 #include "Engine/AssetManager.h"
 #include "AssetData.h"
+#include "Async/ParallelFor.h"
+#include "Misc/Compression.h"
+#include "HAL/FileManager.h"
+#include "Templates/UniquePtr.h"
 #ifdef __DEVELOPER_MODE__
 #include "Interfaces/ITargetPlatform.h"
 #include "Interfaces/ITargetPlatformManagerModule.h"
 #endif
 
+namespace CompressedFile
+{
+	// "HHPZ"
+	static const uint32 FileMagic = 0x5A504848;
+	static const int32 FileVersion = 1;
+	static const int32 ChunkSize = 4 * 1024 * 1024;
+}
+
 FString UFLibAssetManageHelperEx::ConvVirtualToAbsPath(const FString& InPackagePath)
 {
 	FString ResultAbsPath;
@@ -36,6 +51,7 @@ FString UFLibAssetManageHelperEx::ConvVirtualToAbsPath(const FString& InPackageP
 	}
 
 	TArray<FString> localFindFiles;
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	IFileManager::Get().FindFiles(localFindFiles, *SearchDir, nullptr);
 
 	for (const auto& Item : localFindFiles)
@@ -103,7 +119,7 @@ bool UFLibAssetManageHelperEx::ConvLongPackageNameToPackagePath(const FString& I
 {
 	OutPackagePath.Empty();
 	bool runState = false;
-	if (FPackageName::DoesPackageExist(InLongPackageName))
+	if (IAssetRegistryQuery::Get().DoesPackageExist(InLongPackageName))
 	{
 		FString AssetName;
 		{
@@ -152,6 +168,7 @@ bool UFLibAssetManageHelperEx::GetAssetPackageGUID(const FString& InPackagePath,
 
 FAssetDependenciesInfo UFLibAssetManageHelperEx::CombineAssetDependencies(const FAssetDependenciesInfo& A, const FAssetDependenciesInfo& B)
 {
+	HOTPATCHER_TRACE_SCOPE(CombineAssetDependencies);
 	FAssetDependenciesInfo resault;
 
 	auto CombineLambda = [&resault](const FAssetDependenciesInfo& InDependencies)
@@ -196,19 +213,21 @@ FAssetDependenciesInfo UFLibAssetManageHelperEx::CombineAssetDependencies(const
 
 void UFLibAssetManageHelperEx::GetAssetDependencies(const FString& InLongPackageName, FAssetDependenciesInfo& OutDependices)
 {
+	HOTPATCHER_TRACE_SCOPE(GetAssetDependencies);
 	if (InLongPackageName.IsEmpty())
 		return;
 
 	FStringAssetReference AssetRef = FStringAssetReference(InLongPackageName);
 	if (!AssetRef.IsValid())
 		return;
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+	const IAssetRegistryQuery& AssetRegistryQuery = IAssetRegistryQuery::Get();
 	
-	if (FPackageName::DoesPackageExist(InLongPackageName))
+	if (AssetRegistryQuery.DoesPackageExist(InLongPackageName))
 	{
 		{
 			TArray<FAssetData> AssetDataList;
-			bool bResault = AssetRegistryModule.Get().GetAssetsByPackageName(FName(*InLongPackageName), AssetDataList);
+			HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+			bool bResault = AssetRegistryQuery.GetAssetsByPackageName(FName(*InLongPackageName), AssetDataList, false);
 			if (!bResault || !AssetDataList.Num())
 			{
 				UE_LOG(LogTemp, Error, TEXT("Faild to Parser AssetData of %s, please check."), *InLongPackageName);
@@ -219,12 +238,13 @@ void UFLibAssetManageHelperEx::GetAssetDependencies(const FString& InLongPackage
 				UE_LOG(LogTemp, Warning, TEXT("Got mulitple AssetData of %s,please check."), *InLongPackageName);
 			}
 		}
-		UFLibAssetManageHelperEx::GatherAssetDependicesInfoRecursively(AssetRegistryModule, InLongPackageName, OutDependices);
+		UFLibAssetManageHelperEx::GatherAssetDependicesInfoRecursively(AssetRegistryQuery, InLongPackageName, OutDependices);
 	}
 }
 
 void UFLibAssetManageHelperEx::GetAssetListDependencies(const TArray<FString>& InLongPackageNameList, FAssetDependenciesInfo& OutDependices)
 {
+	HOTPATCHER_TRACE_SCOPE(GetAssetListDependencies);
 	FAssetDependenciesInfo result;
 
 	for (const auto& LongPackageItem : InLongPackageNameList)
@@ -276,63 +296,108 @@ void UFLibAssetManageHelperEx::GetAssetDetailsByAssetDependenciesInfo(const FAss
 		}
 }
 
+void UFLibAssetManageHelperEx::GetMapsLoadOrder(const FAssetDependenciesInfo& InAssets, TArray<FString>& OutLongPackageNames)
+{
+	const IAssetRegistryQuery& AssetRegistryQuery = IAssetRegistryQuery::Get();
+
+	TArray<FAssetDetail> AssetDetails;
+	UFLibAssetManageHelperEx::GetAssetDetailsByAssetDependenciesInfo(InAssets, AssetDetails);
+
+	TSet<FName> VisitedPackages;
+	for (const auto& AssetDetail : AssetDetails)
+	{
+		if (!AssetDetail.mAssetType.Equals(TEXT("World")))
+			continue;
+
+		FString MapLongPackageName;
+		if (!UFLibAssetManageHelperEx::ConvPackagePathToLongPackageName(AssetDetail.mPackagePath, MapLongPackageName))
+			continue;
+
+		TArray<FName> PendingPackages{ FName(*MapLongPackageName) };
+		for (int32 Index = 0; Index < PendingPackages.Num(); ++Index)
+		{
+			const FName PackageName = PendingPackages[Index];
+			if (VisitedPackages.Contains(PackageName))
+				continue;
+			VisitedPackages.Add(PackageName);
+
+			FString LongPackageName = PackageName.ToString();
+			if (LongPackageName.StartsWith(TEXT("/Script/")))
+				continue;
+			OutLongPackageNames.Add(LongPackageName);
+
+			TArray<FName> Dependencies;
+			HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+			if (AssetRegistryQuery.GetDependencies(PackageName, Dependencies))
+			{
+				PendingPackages.Append(Dependencies);
+			}
+		}
+	}
+}
+
 void UFLibAssetManageHelperEx::GatherAssetDependicesInfoRecursively(
-	FAssetRegistryModule& InAssetRegistryModule,
+	const IAssetRegistryQuery& InAssetRegistryQuery,
 	const FString& InTargetLongPackageName,
 	FAssetDependenciesInfo& OutDependencies
 )
 {
-	TArray<FName> local_Dependencies;
-	bool bGetDependenciesSuccess = InAssetRegistryModule.Get().GetDependencies(FName(*InTargetLongPackageName), local_Dependencies, EAssetRegistryDependencyType::Packages);
-	if (bGetDependenciesSuccess)
+	// the dependencies of a package and the next one to visit,same order as the recursion
+	struct FPendingDependencies
+	{
+		TArray<FName> Dependencies;
+		int32 NextIndex = 0;
+	};
+	TArray<FPendingDependencies> PendingStack;
+	auto PushDependencies = [&InAssetRegistryQuery, &PendingStack](const FString& InLongPackageName)
 	{
-		for (auto &DependItem : local_Dependencies)
+		TArray<FName> local_Dependencies;
+		HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+		if (InAssetRegistryQuery.GetDependencies(FName(*InLongPackageName), local_Dependencies))
 		{
-			FString LongDependentPackageName = DependItem.ToString();
-			FString BelongModuleName = UFLibAssetManageHelperEx::GetAssetBelongModuleName(LongDependentPackageName);
+			PendingStack[PendingStack.AddDefaulted()].Dependencies = MoveTemp(local_Dependencies);
+		}
+	};
 
-			// add a new asset to module category
-			auto AddNewAssetItemLambda = [&InAssetRegistryModule, &OutDependencies](
-				FAssetDependenciesDetail& InModuleAssetDependDetail,
-				const FString& InAssetPackageName
-				)
-			{
-				if (!InModuleAssetDependDetail.mDependAssetDetails.Contains(InAssetPackageName))
-				{
-				 	// FAssetData* AssetPackageData = InAssetRegistryModule.Get().GetAssetPackageData(*InAssetPackageName);
-					UAssetManager& AssetManager = UAssetManager::Get();
-					if (AssetManager.IsValid())
-					{
-						FString PackagePath;
-						UFLibAssetManageHelperEx::ConvLongPackageNameToPackagePath(InAssetPackageName,PackagePath);
-						FAssetData OutAssetData;
-						if (AssetManager.GetAssetDataForPath(FSoftObjectPath{ PackagePath }, OutAssetData) && OutAssetData.IsValid())
-						{
-							FAssetDetail AssetDetail;
-							AssetDetail.mPackagePath = PackagePath;
-							AssetDetail.mAssetType = OutAssetData.AssetClass.ToString();
-							UFLibAssetManageHelperEx::GetAssetPackageGUID(PackagePath, AssetDetail.mGuid);
-							InModuleAssetDependDetail.mDependAssetDetails.Add(InAssetPackageName,AssetDetail);
-						}
-					}
-					
-					GatherAssetDependicesInfoRecursively(InAssetRegistryModule, InAssetPackageName, OutDependencies);
-				}
-			};
+	PushDependencies(InTargetLongPackageName);
+	while (PendingStack.Num())
+	{
+		FPendingDependencies& Pending = PendingStack.Last();
+		if (Pending.NextIndex >= Pending.Dependencies.Num())
+		{
+			PendingStack.Pop(false);
+			continue;
+		}
+		FName DependItem = Pending.Dependencies[Pending.NextIndex++];
 
-			if (OutDependencies.mDependencies.Contains(BelongModuleName))
-			{
-				// UE_LOG(LogTemp, Log, TEXT("Belong Module is %s,Asset is %s"), *BelongModuleName, *LongDependentPackageName);
-				FAssetDependenciesDetail* ModuleCategory = OutDependencies.mDependencies.Find(BelongModuleName);
-				AddNewAssetItemLambda(*ModuleCategory, LongDependentPackageName);
-			}
-			else
+		FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::AssetsVisited);
+		FString LongDependentPackageName = DependItem.ToString();
+		FString BelongModuleName = UFLibAssetManageHelperEx::GetAssetBelongModuleName(LongDependentPackageName);
+
+		FAssetDependenciesDetail* ModuleCategory = OutDependencies.mDependencies.Find(BelongModuleName);
+		if (!ModuleCategory)
+		{
+			ModuleCategory = &OutDependencies.mDependencies.Add(BelongModuleName, FAssetDependenciesDetail{});
+			ModuleCategory->mModuleCategory = BelongModuleName;
+		}
+
+		// add a new asset to module category
+		if (!ModuleCategory->mDependAssetDetails.Contains(LongDependentPackageName))
+		{
+			FString PackagePath;
+			UFLibAssetManageHelperEx::ConvLongPackageNameToPackagePath(LongDependentPackageName, PackagePath);
+			FAssetData OutAssetData;
+			HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+			if (InAssetRegistryQuery.GetAssetByObjectPath(*PackagePath, OutAssetData) && OutAssetData.IsValid())
 			{
-				// UE_LOG(LogTemp, Log, TEXT("New Belong Module is %s,Asset is %s"), *BelongModuleName,*LongDependentPackageName);
-				FAssetDependenciesDetail& NewModuleCategory = OutDependencies.mDependencies.Add(BelongModuleName, FAssetDependenciesDetail{});
-				NewModuleCategory.mModuleCategory = BelongModuleName;
-				AddNewAssetItemLambda(NewModuleCategory, LongDependentPackageName);
+				FAssetDetail AssetDetail;
+				AssetDetail.mPackagePath = PackagePath;
+				AssetDetail.mAssetType = OutAssetData.AssetClass.ToString();
+				UFLibAssetManageHelperEx::GetAssetPackageGUID(PackagePath, AssetDetail.mGuid);
+				ModuleCategory->mDependAssetDetails.Add(LongDependentPackageName, AssetDetail);
 			}
+			// Pending is invalid after push
+			PushDependencies(LongDependentPackageName);
 		}
 	}
 }
@@ -340,6 +405,7 @@ void UFLibAssetManageHelperEx::GatherAssetDependicesInfoRecursively(
 
 bool UFLibAssetManageHelperEx::GetModuleAssetsList(const FString& InModuleName, const TArray<FString>& InExFilterPackagePaths, TArray<FAssetDetail>& OutAssetList)
 {
+	HOTPATCHER_TRACE_SCOPE(GetModuleAssetsList);
 	TArray<FString> AllEnableModule;
 	UFLibAssetManageHelperEx::GetAllEnabledModuleName(AllEnableModule);
 
@@ -356,6 +422,7 @@ bool UFLibAssetManageHelperEx::GetModuleAssetsList(const FString& InModuleName,
 
 bool UFLibAssetManageHelperEx::GetAssetsList(const TArray<FString>& InFilterPackagePaths, TArray<FAssetDetail>& OutAssetList)
 {
+	HOTPATCHER_TRACE_SCOPE(GetAssetsList);
 	TArray<FAssetData> AllAssetData;
 	if (UFLibAssetManageHelperEx::GetAssetsData(InFilterPackagePaths, AllAssetData))
 	{
@@ -394,12 +461,13 @@ bool UFLibAssetManageHelperEx::GetRedirectorList(const TArray<FString>& InFilter
 
 bool UFLibAssetManageHelperEx::GetSpecifyAssetData(const FString& InLongPackageName, TArray<FAssetData>& OutAssetData, bool InIncludeOnlyOnDiskAssets)
 {
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
-	return AssetRegistryModule.Get().GetAssetsByPackageName(*InLongPackageName, OutAssetData, InIncludeOnlyOnDiskAssets);
+	HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+	return IAssetRegistryQuery::Get().GetAssetsByPackageName(*InLongPackageName, OutAssetData, InIncludeOnlyOnDiskAssets);
 }
 
 bool UFLibAssetManageHelperEx::GetAssetsData(const TArray<FString>& InFilterPackagePaths, TArray<FAssetData>& OutAssetData)
 {
+	HOTPATCHER_TRACE_SCOPE(GetAssetsData);
 	OutAssetData.Reset();
 
 	FARFilter Filter;
@@ -415,17 +483,16 @@ bool UFLibAssetManageHelperEx::GetAssetsData(const TArray<FString>& InFilterPack
 		Filter.PackagePaths.AddUnique(*ValidFilterPackageName);
 	}
 
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
-	AssetRegistryModule.Get().GetAssets(Filter, OutAssetData);
+	HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+	IAssetRegistryQuery::Get().GetAssets(Filter, OutAssetData);
 	
 	return true;
 }
 
 bool UFLibAssetManageHelperEx::GetSingleAssetsData(const FString& InPackagePath, FAssetData& OutAssetData)
 {
-	UAssetManager& AssetManager = UAssetManager::Get();
-
-	return AssetManager.GetAssetDataForPath(FSoftObjectPath{ InPackagePath }, OutAssetData);
+	HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+	return IAssetRegistryQuery::Get().GetAssetByObjectPath(*FSoftObjectPath{ InPackagePath }.ToString(), OutAssetData);
 }
 
 bool UFLibAssetManageHelperEx::GetClassStringFromFAssetData(const FAssetData& InAssetData, FString& OutAssetType)
@@ -472,13 +539,14 @@ bool UFLibAssetManageHelperEx::GetSpecifyAssetDetail(const FString& InLongPackag
 
 void UFLibAssetManageHelperEx::FilterNoRefAssets(const TArray<FAssetDetail>& InAssetsDetail, TArray<FAssetDetail>& OutHasRefAssetsDetail, TArray<FAssetDetail>& OutDontHasRefAssetsDetail)
 {
+	HOTPATCHER_TRACE_SCOPE(FilterNoRefAssets);
 	OutHasRefAssetsDetail.Reset();
 	OutDontHasRefAssetsDetail.Reset();
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+	const IAssetRegistryQuery& AssetRegistryQuery = IAssetRegistryQuery::Get();
 	for (const auto& AssetDetail : InAssetsDetail)
 	{
 		FSoftObjectPath CurrentObjectSoftRef{ AssetDetail.mPackagePath };
-		FAssetIdentifier CurrentAssetId{ *CurrentObjectSoftRef.GetLongPackageName() };
+		FName CurrentPackageName{ *CurrentObjectSoftRef.GetLongPackageName() };
 		
 		// ignore scan Map Asset reference
 		{
@@ -496,9 +564,10 @@ void UFLibAssetManageHelperEx::FilterNoRefAssets(const TArray<FAssetDetail>& InA
 		}
 
 		
-		TArray<FAssetIdentifier> CurrentAssetRefList;
-		AssetRegistryModule.Get().GetReferencers(CurrentAssetId, CurrentAssetRefList);
-		if (CurrentAssetRefList.Num() > 1 || (CurrentAssetRefList.Num() > 0 && !(CurrentAssetRefList[0] == CurrentAssetId)))
+		TArray<FName> CurrentAssetRefList;
+		HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+		AssetRegistryQuery.GetReferencers(CurrentPackageName, CurrentAssetRefList);
+		if (CurrentAssetRefList.Num() > 1 || (CurrentAssetRefList.Num() > 0 && CurrentAssetRefList[0] != CurrentPackageName))
 		{
 			OutHasRefAssetsDetail.Add(AssetDetail);
 		}
@@ -510,13 +579,14 @@ void UFLibAssetManageHelperEx::FilterNoRefAssets(const TArray<FAssetDetail>& InA
 
 void UFLibAssetManageHelperEx::FilterNoRefAssetsWithIgnoreFilter(const TArray<FAssetDetail>& InAssetsDetail, const TArray<FString>& InIgnoreFilters, TArray<FAssetDetail>& OutHasRefAssetsDetail, TArray<FAssetDetail>& OutDontHasRefAssetsDetail)
 {
+	HOTPATCHER_TRACE_SCOPE(FilterNoRefAssetsWithIgnoreFilter);
 	OutHasRefAssetsDetail.Reset();
 	OutDontHasRefAssetsDetail.Reset();
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+	const IAssetRegistryQuery& AssetRegistryQuery = IAssetRegistryQuery::Get();
 	for (const auto& AssetDetail : InAssetsDetail)
 	{
 		FSoftObjectPath CurrentObjectSoftRef{ AssetDetail.mPackagePath };
-		FAssetIdentifier CurrentAssetId{ *CurrentObjectSoftRef.GetLongPackageName() };
+		FName CurrentPackageName{ *CurrentObjectSoftRef.GetLongPackageName() };
 
 		// ignore scan Map Asset reference
 		{
@@ -547,9 +617,10 @@ void UFLibAssetManageHelperEx::FilterNoRefAssetsWithIgnoreFilter(const TArray<FA
 		}
 
 
-		TArray<FAssetIdentifier> CurrentAssetRefList;
-		AssetRegistryModule.Get().GetReferencers(CurrentAssetId, CurrentAssetRefList);
-		if (CurrentAssetRefList.Num() > 1 || (CurrentAssetRefList.Num() > 0 && !(CurrentAssetRefList[0] == CurrentAssetId)))
+		TArray<FName> CurrentAssetRefList;
+		HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+		AssetRegistryQuery.GetReferencers(CurrentPackageName, CurrentAssetRefList);
+		if (CurrentAssetRefList.Num() > 1 || (CurrentAssetRefList.Num() > 0 && CurrentAssetRefList[0] != CurrentPackageName))
 		{
 			OutHasRefAssetsDetail.Add(AssetDetail);
 		}
@@ -588,33 +659,69 @@ bool UFLibAssetManageHelperEx::CombineAssetsDetailAsFAssetDepenInfo(const TArray
 	return true;
 }
 
-void UFLibAssetManageHelperEx::GetAllInValidAssetInProject(FAssetDependenciesInfo InAllDependencies, TArray<FString> &OutInValidAsset,TArray<FString> InIgnoreModules)
+void UFLibAssetManageHelperEx::GetAllInValidAssetInProject(const FAssetDependenciesInfo& InAllDependencies, TArray<FString> &OutInValidAsset,const TArray<FString>& InIgnoreModules)
 {
-	TArray<FString> Keys;
-	InAllDependencies.mDependencies.GetKeys(Keys);
-
-	for (const auto& ModuleItem : Keys)
+	HOTPATCHER_TRACE_SCOPE(GetAllInValidAssetInProject);
+	// collect all asset filename(not postfix) and the directory index it belong to
+	TArray<FString> AssetLongPackageNames;
+	TArray<FString> AssetCleanFilenames;
+	TArray<int32> AssetDirectoryIndexs;
+	TArray<FString> SearchDirs;
 	{
-		// ignore search /Script Asset
-		if (InIgnoreModules.Contains(ModuleItem))
-			continue;
-		FAssetDependenciesDetail ModuleDependencies = InAllDependencies.mDependencies[ModuleItem];
-
-		TArray<FString> ModuleAssetList;
-		ModuleDependencies.mDependAssetDetails.GetKeys(ModuleAssetList);
-		for (const auto& AssetLongPackageName : ModuleAssetList)
+		TMap<FString, int32> SearchDirIndexMap;
+		for (const auto& ModuleItem : InAllDependencies.mDependencies)
 		{
-			FString AssetPackagePath;
-			if(!UFLibAssetManageHelperEx::ConvLongPackageNameToPackagePath(AssetLongPackageName,AssetPackagePath))
+			// ignore search /Script Asset
+			if (InIgnoreModules.Contains(ModuleItem.Key))
 				continue;
-			// UE_LOG(LogTemp, Log, TEXT("Asset %s"), *AssetPackagePath);
-			FString AssetAbsPath = UFLibAssetManageHelperEx::ConvVirtualToAbsPath(AssetPackagePath);
-			if (!FPaths::FileExists(AssetAbsPath))
+			for (const auto& AssetItem : ModuleItem.Value.mDependAssetDetails)
 			{
-				OutInValidAsset.Add(AssetLongPackageName);
+				const FString& AssetLongPackageName = AssetItem.Key;
+				FString AssetFilename;
+				if (!FPackageName::TryConvertLongPackageNameToFilename(AssetLongPackageName, AssetFilename))
+					continue;
+				AssetFilename = FPaths::ConvertRelativePathToFull(AssetFilename);
+
+				FString AssetDir = FPaths::GetPath(AssetFilename);
+				int32* FoundDirIndex = SearchDirIndexMap.Find(AssetDir);
+				int32 DirIndex = FoundDirIndex ? *FoundDirIndex : SearchDirIndexMap.Add(AssetDir, SearchDirs.Add(AssetDir));
+
+				AssetLongPackageNames.Add(AssetLongPackageName);
+				AssetCleanFilenames.Add(FPaths::GetCleanFilename(AssetFilename));
+				AssetDirectoryIndexs.Add(DirIndex);
 			}
 		}
 	}
+
+	// enumerate every directory only once
+	TArray<TSet<FString>> DirectoryFiles;
+	DirectoryFiles.SetNum(SearchDirs.Num());
+	ParallelFor(SearchDirs.Num(), [&SearchDirs, &DirectoryFiles](int32 DirIndex)
+	{
+		TArray<FString> LocalFindFiles;
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
+		IFileManager::Get().FindFiles(LocalFindFiles, *(SearchDirs[DirIndex] / TEXT("*")), true, false);
+		DirectoryFiles[DirIndex].Append(LocalFindFiles);
+	});
+
+	TArray<bool> AssetExistStatus;
+	AssetExistStatus.SetNumZeroed(AssetLongPackageNames.Num());
+	ParallelFor(AssetLongPackageNames.Num(), [&](int32 AssetIndex)
+	{
+		const TSet<FString>& Files = DirectoryFiles[AssetDirectoryIndexs[AssetIndex]];
+		const FString& CleanFilename = AssetCleanFilenames[AssetIndex];
+		AssetExistStatus[AssetIndex] =
+			Files.Contains(CleanFilename + FPackageName::GetAssetPackageExtension()) ||
+			Files.Contains(CleanFilename + FPackageName::GetMapPackageExtension());
+	});
+
+	for (int32 AssetIndex = 0; AssetIndex < AssetLongPackageNames.Num(); ++AssetIndex)
+	{
+		if (!AssetExistStatus[AssetIndex])
+		{
+			OutInValidAsset.Add(AssetLongPackageNames[AssetIndex]);
+		}
+	}
 }
 const FAssetPackageData* UFLibAssetManageHelperEx::GetPackageDataByPackagePath(const FString& InPackagePath)
 {
@@ -623,12 +730,13 @@ const FAssetPackageData* UFLibAssetManageHelperEx::GetPackageDataByPackagePath(c
 		return NULL;
 	if (!InPackagePath.IsEmpty())
 	{
-		FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+		const IAssetRegistryQuery& AssetRegistryQuery = IAssetRegistryQuery::Get();
 		FString TargetLongPackageName = UFLibAssetManageHelperEx::GetLongPackageNameFromPackagePath(InPackagePath);
 
-		if(FPackageName::DoesPackageExist(TargetLongPackageName))
+		if(AssetRegistryQuery.DoesPackageExist(TargetLongPackageName))
 		{
-			FAssetPackageData* AssetPackageData = const_cast<FAssetPackageData*>(AssetRegistryModule.Get().GetAssetPackageData(*TargetLongPackageName));
+			HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+			FAssetPackageData* AssetPackageData = const_cast<FAssetPackageData*>(AssetRegistryQuery.GetAssetPackageData(*TargetLongPackageName));
 			if (AssetPackageData != nullptr)
 			{
 				return AssetPackageData;
@@ -639,16 +747,13 @@ const FAssetPackageData* UFLibAssetManageHelperEx::GetPackageDataByPackagePath(c
 	return NULL;
 }
 
-bool UFLibAssetManageHelperEx::ConvLongPackageNameToCookedPath(const FString& InProjectAbsDir, const FString& InPlatformName, const FString& InLongPackageName, TArray<FString>& OutCookedAssetPath, TArray<FString>& OutCookedAssetRelativePath)
+bool UFLibAssetManageHelperEx::ConvLongPackageNameToCookedRelativePath(const FString& InProjectAbsDir, const FString& InLongPackageName, FString& OutCookedRelativePath)
 {
-	if (!FPaths::DirectoryExists(InProjectAbsDir) || !IsValidPlatform(InPlatformName))
-		return false;
-
 	FString EngineAbsDir = FPaths::ConvertRelativePathToFull(FPaths::EngineDir());
-	FString CookedRootDir = FPaths::Combine(InProjectAbsDir, TEXT("Saved/Cooked"), InPlatformName);
 	FString ProjectName = FApp::GetProjectName();
 	FString AssetPackagePath;
-	UFLibAssetManageHelperEx::ConvLongPackageNameToPackagePath(InLongPackageName,AssetPackagePath);
+	if (!UFLibAssetManageHelperEx::ConvLongPackageNameToPackagePath(InLongPackageName, AssetPackagePath))
+		return false;
 	FString AssetAbsPath = UFLibAssetManageHelperEx::ConvVirtualToAbsPath(AssetPackagePath);
 
 	FString AssetModuleName;
@@ -656,32 +761,44 @@ bool UFLibAssetManageHelperEx::ConvLongPackageNameToCookedPath(const FString& In
 
 	bool bIsEngineModule = false;
 	FString AssetBelongModuleBaseDir;
-	FString AssetCookedNotPostfixPath;
+	if (UFLibAssetManageHelperEx::GetEnableModuleAbsDir(AssetModuleName, AssetBelongModuleBaseDir))
 	{
+		if (AssetBelongModuleBaseDir.Contains(EngineAbsDir))
+			bIsEngineModule = true;
+	}
 
-		if (UFLibAssetManageHelperEx::GetEnableModuleAbsDir(AssetModuleName, AssetBelongModuleBaseDir))
-		{
-			if (AssetBelongModuleBaseDir.Contains(EngineAbsDir))
-				bIsEngineModule = true;
-		}
+	if (bIsEngineModule)
+	{
+		OutCookedRelativePath = TEXT("Engine") / UKismetStringLibrary::GetSubstring(AssetAbsPath, EngineAbsDir.Len() - 1, AssetAbsPath.Len() - EngineAbsDir.Len());
+	}
+	else
+	{
+		OutCookedRelativePath = ProjectName / UKismetStringLibrary::GetSubstring(AssetAbsPath, InProjectAbsDir.Len() - 1, AssetAbsPath.Len() - InProjectAbsDir.Len());
+	}
 
-		FString AssetCookedRelativePath;
-		if (bIsEngineModule)
-		{
-			AssetCookedRelativePath = TEXT("Engine") / UKismetStringLibrary::GetSubstring(AssetAbsPath, EngineAbsDir.Len() - 1, AssetAbsPath.Len() - EngineAbsDir.Len());
-		}
-		else
+	// remove .uasset / .umap postfix
+	{
+		int32 lastDotIndex = 0;
+		if (OutCookedRelativePath.FindLastChar('.', lastDotIndex))
 		{
-			AssetCookedRelativePath = ProjectName / UKismetStringLibrary::GetSubstring(AssetAbsPath, InProjectAbsDir.Len() - 1, AssetAbsPath.Len() - InProjectAbsDir.Len());
+			OutCookedRelativePath.RemoveAt(lastDotIndex, OutCookedRelativePath.Len() - lastDotIndex);
 		}
+	}
+	return true;
+}
 
-		// remove .uasset / .umap postfix
-		{
-			int32 lastDotIndex = 0;
-			AssetCookedRelativePath.FindLastChar('.', lastDotIndex);
-			AssetCookedRelativePath.RemoveAt(lastDotIndex, AssetCookedRelativePath.Len() - lastDotIndex);
-		}
+bool UFLibAssetManageHelperEx::ConvLongPackageNameToCookedPath(const FString& InProjectAbsDir, const FString& InPlatformName, const FString& InLongPackageName, TArray<FString>& OutCookedAssetPath, TArray<FString>& OutCookedAssetRelativePath)
+{
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
+	if (!FPaths::DirectoryExists(InProjectAbsDir) || !IsValidPlatform(InPlatformName))
+		return false;
 
+	FString CookedRootDir = UFLibAssetManageHelperEx::GetCookedRootDir(InProjectAbsDir, InPlatformName);
+	FString AssetCookedNotPostfixPath;
+	{
+		FString AssetCookedRelativePath;
+		if (!UFLibAssetManageHelperEx::ConvLongPackageNameToCookedRelativePath(InProjectAbsDir, InLongPackageName, AssetCookedRelativePath))
+			return false;
 		AssetCookedNotPostfixPath = FPaths::Combine(CookedRootDir, AssetCookedRelativePath);
 	}
 
@@ -692,6 +809,7 @@ bool UFLibAssetManageHelperEx::ConvLongPackageNameToCookedPath(const FString& In
 		AssetCookedNotPostfixPath.FindLastChar('/', lastSlashIndex);
 		SearchDir = UKismetStringLibrary::GetSubstring(AssetCookedNotPostfixPath, 0, lastSlashIndex);
 	}
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	IFileManager::Get().IterateDirectory(*SearchDir, FileVisitor);
 	for (const auto& FileItem : FileVisitor.Files)
 	{
@@ -708,39 +826,96 @@ bool UFLibAssetManageHelperEx::ConvLongPackageNameToCookedPath(const FString& In
 }
 
 
-bool UFLibAssetManageHelperEx::GetCookCommandFromAssetDependencies(const FString& InProjectDir, const FString& InPlatformName, const FAssetDependenciesInfo& InAssetDependencies, const TArray<FString> &InCookParams, TArray<FString>& OutCookCommand)
+FString UFLibAssetManageHelperEx::GetCookedRootDir(const FString& InProjectAbsDir, const FString& InPlatformName)
 {
-	if (!FPaths::DirectoryExists(InProjectDir) || !UFLibAssetManageHelperEx::IsValidPlatform(InPlatformName))
+	return FPaths::Combine(InProjectAbsDir, TEXT("Saved/Cooked"), InPlatformName);
+}
+
+bool UFLibAssetManageHelperEx::IterateCookedAssetFiles(const FString& InProjectAbsDir, const FString& InPlatformName, const FAssetDependenciesInfo& InAssetDependencies, TFunctionRef<void(const FString&)> InVisitor)
+{
+	HOTPATCHER_TRACE_SCOPE(IterateCookedAssetFiles);
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
+	if (!FPaths::DirectoryExists(InProjectAbsDir) || !UFLibAssetManageHelperEx::IsValidPlatform(InPlatformName))
 		return false;
-	OutCookCommand.Empty();
-	// TArray<FString> resault;
-	TArray<FString> Keys;
-	InAssetDependencies.mDependencies.GetKeys(Keys);
 
-	for (const auto& Key : Keys)
+	HOTPATCHER_SCOPED_TIMER(FString::Printf(TEXT("ResolveCookedFiles %s"), *InPlatformName));
+	const FString CookedRootDir = UFLibAssetManageHelperEx::GetCookedRootDir(InProjectAbsDir, InPlatformName);
+
+	// the files of listed directories,grouped by the path without postfix,e.g. .../BP_Actor -> BP_Actor.uasset,BP_Actor.uexp
+	TSet<FString> ListedDirs;
+	TMap<FString, TArray<FString>> CookedFilesMap;
+
+	for (const auto& ModuleDependencies : InAssetDependencies.mDependencies)
 	{
-		if (Key.Equals(TEXT("Script")))
+		if (ModuleDependencies.Key.Equals(TEXT("Script")))
 			continue;
-		TArray<FString> AssetList;
-		InAssetDependencies.mDependencies.Find(Key)->mDependAssetDetails.GetKeys(AssetList);
-		for (const auto& AssetLongPackageName : AssetList)
+		for (const auto& AssetDetail : ModuleDependencies.Value.mDependAssetDetails)
 		{
-			TArray<FString> CookedAssetAbsPath;
-			TArray<FString> CookedAssetRelativePath;
-			TArray<FString> FinalCookedCommand;
-			if (UFLibAssetManageHelperEx::ConvLongPackageNameToCookedPath(InProjectDir, InPlatformName, AssetLongPackageName, CookedAssetAbsPath, CookedAssetRelativePath))
+			FString AssetCookedRelativePath;
+			if (!UFLibAssetManageHelperEx::ConvLongPackageNameToCookedRelativePath(InProjectAbsDir, AssetDetail.Key, AssetCookedRelativePath))
+				continue;
+			const FString AssetCookedNotPostfixPath = FPaths::Combine(CookedRootDir, AssetCookedRelativePath);
+
+			const FString SearchDir = FPaths::GetPath(AssetCookedNotPostfixPath);
+			if (!ListedDirs.Contains(SearchDir))
 			{
-				if (UFLibAssetManageHelperEx::CombineCookedAssetCommand(CookedAssetAbsPath, CookedAssetRelativePath, InCookParams, FinalCookedCommand))
+				ListedDirs.Add(SearchDir);
+				FFillArrayDirectoryVisitor FileVisitor;
+				HOTPATCHER_TRACE_COUNT(FileSystemProbes);
+				IFileManager::Get().IterateDirectory(*SearchDir, FileVisitor);
+				for (auto& FileItem : FileVisitor.Files)
 				{
-					OutCookCommand.Append(FinalCookedCommand);
+					int32 SlashIndex = INDEX_NONE;
+					FileItem.FindLastChar('/', SlashIndex);
+					int32 DotIndex = FileItem.Find(TEXT("."), ESearchCase::CaseSensitive, ESearchDir::FromStart, SlashIndex);
+					if (DotIndex != INDEX_NONE)
+					{
+						CookedFilesMap.FindOrAdd(FileItem.Left(DotIndex)).Add(MoveTemp(FileItem));
+					}
 				}
 			}
 
+			if (const TArray<FString>* CookedFiles = CookedFilesMap.Find(AssetCookedNotPostfixPath))
+			{
+				for (const auto& CookedFile : *CookedFiles)
+				{
+					InVisitor(CookedFile.Mid(CookedRootDir.Len() + 1));
+				}
+			}
 		}
 	}
 	return true;
 }
 
+bool UFLibAssetManageHelperEx::GetCookCommandFromAssetDependencies(const FString& InProjectDir, const FString& InPlatformName, const FAssetDependenciesInfo& InAssetDependencies, const TArray<FString> &InCookParams, TArray<FString>& OutCookCommand)
+{
+	HOTPATCHER_TRACE_SCOPE(GetCookCommandFromAssetDependencies);
+	OutCookCommand.Empty();
+
+	// "CookedRootDir/RelativeFile" "../../../RelativeFile" Params
+	const FString AbsPathPrefix = TEXT("\"") + UFLibAssetManageHelperEx::GetCookedRootDir(InProjectDir, InPlatformName) + TEXT("/");
+	const FString MountPathPrefix = TEXT("\" \"../../../");
+	FString CommandPostfix = TEXT("\"");
+	for (const auto& Param : InCookParams)
+	{
+		CommandPostfix.Append(TEXT(" ") + Param);
+	}
+
+	return UFLibAssetManageHelperEx::IterateCookedAssetFiles(InProjectDir, InPlatformName, InAssetDependencies,
+		[&](const FString& InCookedRelativeFile)
+		{
+			FString CookCommand;
+			CookCommand.Reserve(AbsPathPrefix.Len() + MountPathPrefix.Len() + CommandPostfix.Len() + InCookedRelativeFile.Len() * 2);
+			CookCommand.Append(AbsPathPrefix);
+			CookCommand.Append(InCookedRelativeFile);
+			CookCommand.Append(MountPathPrefix);
+			CookCommand.Append(InCookedRelativeFile);
+			CookCommand.Append(CommandPostfix);
+			OutCookCommand.Add(MoveTemp(CookCommand));
+		}
+	);
+}
+
 bool UFLibAssetManageHelperEx::CombineCookedAssetCommand(const TArray<FString> &InAbsPath, const TArray<FString>& InRelativePath, const TArray<FString>& InParams, TArray<FString>& OutCommand)
 {
 	OutCommand.Empty();
@@ -785,11 +960,15 @@ bool UFLibAssetManageHelperEx::SerializeAssetDependenciesToJson(const FAssetDepe
 }
 
 
-bool UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(const FAssetDependenciesInfo& InAssetDependencies, TSharedPtr<FJsonObject>& OutJsonObject, TArray<FString> InIgnoreModules)
+bool UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(const FAssetDependenciesInfo& InAssetDependencies, TSharedPtr<FJsonObject>& OutJsonObject)
 {
+	HOTPATCHER_TRACE_SCOPE(SerializeAssetDependenciesToJsonObject);
 	bool bRunStatus = false;
 	if(!OutJsonObject.IsValid())
+	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
+	}
 
 	{
 		// collect all module name
@@ -799,6 +978,7 @@ bool UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(const FAss
 			TArray<TSharedPtr<FJsonValue>> JsonCategoryList;
 			for (const auto& AssetCategoryItem : AssetCategoryList)
 			{
+				HOTPATCHER_TRACE_COUNT(JsonAllocations);
 				JsonCategoryList.Add(MakeShareable(new FJsonValueString(AssetCategoryItem)));
 			}
 			OutJsonObject->SetArrayField(JSON_MODULE_LIST_SECTION_NAME, JsonCategoryList);
@@ -806,6 +986,7 @@ bool UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(const FAss
 
 
 		// serialize asset list
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		TSharedPtr<FJsonObject> AssetListJsonObject = MakeShareable(new FJsonObject);
 		for (const auto& AssetCategoryItem : AssetCategoryList)
 		{
@@ -820,6 +1001,7 @@ bool UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(const FAss
 
 			for (const auto& AssetItem : CategoryAssetList)
 			{
+				HOTPATCHER_TRACE_COUNT(JsonAllocations);
 				CategoryAssetListJsonEntity.Add(MakeShareable(new FJsonValueString(AssetItem)));
 
 			}
@@ -828,27 +1010,14 @@ bool UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(const FAss
 
 		}
 
-		// collect all invalid asset
-		{
-			TArray<FString> AllInValidAssetList;
-			UFLibAssetManageHelperEx::GetAllInValidAssetInProject(InAssetDependencies, AllInValidAssetList,InIgnoreModules);
-			if (AllInValidAssetList.Num() > 0)
-			{
-				TArray<TSharedPtr<FJsonValue>> JsonInvalidAssetList;
-				for (const auto& InValidAssetItem : AllInValidAssetList)
-				{
-					JsonInvalidAssetList.Add(MakeShareable(new FJsonValueString(InValidAssetItem)));
-				}
-				AssetListJsonObject->SetArrayField(JSON_ALL_INVALID_ASSET_SECTION_NAME, JsonInvalidAssetList);
-			}
-		}
-
 		OutJsonObject->SetObjectField(JSON_ALL_ASSETS_LIST_SECTION_NAME, AssetListJsonObject);
 
 		// serilize asset detail
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		TSharedPtr<FJsonObject> AssetDetailsListJsonObject = MakeShareable(new FJsonObject);
 		for (const auto& AssetCategoryItem : AssetCategoryList)
 		{
+			HOTPATCHER_TRACE_COUNT(JsonAllocations);
 			TSharedPtr<FJsonObject> CurrentCategoryJsonObject = MakeShareable(new FJsonObject);
 			const FAssetDependenciesDetail& CategortItem = InAssetDependencies.mDependencies[AssetCategoryItem];
 			TArray<FString> AssetList;
@@ -885,6 +1054,7 @@ bool UFLibAssetManageHelperEx::DeserializeAssetDependencies(const FString& InStr
   
 bool UFLibAssetManageHelperEx::DeserializeAssetDependenciesForJsonObject(const TSharedPtr<FJsonObject>& InJsonObject, FAssetDependenciesInfo& OutAssetDependencies)
 {
+	HOTPATCHER_TRACE_SCOPE(DeserializeAssetDependenciesForJsonObject);
 	bool bRunStatus = false;
 	if (InJsonObject.IsValid())
 	{
@@ -935,6 +1105,7 @@ bool UFLibAssetManageHelperEx::DeserializeAssetDependenciesForJsonObject(const T
 
 TSharedPtr<FJsonObject> UFLibAssetManageHelperEx::SerilizeAssetDetial(const FAssetDetail& InAssetDetail)
 {
+	HOTPATCHER_TRACE_COUNT(JsonAllocations);
 	TSharedPtr<FJsonObject> RootJsonObject = MakeShareable(new FJsonObject);
 	{
 		RootJsonObject->SetStringField("PackagePath", InAssetDetail.mPackagePath);
@@ -960,6 +1131,7 @@ bool UFLibAssetManageHelperEx::DeserilizeAssetDetial(TSharedPtr<FJsonObject>& In
 
 FString UFLibAssetManageHelperEx::SerializeAssetDetialArrayToString(const TArray<FAssetDetail>& InAssetDetialList)
 {
+	HOTPATCHER_TRACE_COUNT(JsonAllocations);
 	TSharedPtr<FJsonObject> RootJsonObject=MakeShareable(new FJsonObject);
 
 	for (const auto& AssetDetial : InAssetDetialList)
@@ -975,12 +1147,228 @@ FString UFLibAssetManageHelperEx::SerializeAssetDetialArrayToString(const TArray
 
 bool UFLibAssetManageHelperEx::SaveStringToFile(const FString& InFile, const FString& InString)
 {
+	HOTPATCHER_TRACE_SCOPE(SaveStringToFile);
+	FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesWritten, InString.Len());
 	return FFileHelper::SaveStringToFile(InString, *InFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
 }
 
 bool UFLibAssetManageHelperEx::LoadFileToString(const FString& InFile, FString& OutString)
 {
-	return FFileHelper::LoadFileToString(OutString, *InFile);
+	HOTPATCHER_TRACE_SCOPE(LoadFileToString);
+	if (!UFLibAssetManageHelperEx::IsCompressedFile(InFile))
+	{
+		return FFileHelper::LoadFileToString(OutString, *InFile);
+	}
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InFile));
+	if (!Reader)
+		return false;
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	FString FormatName;
+	int64 UncompressedSize = 0;
+	int32 ChunkNum = 0;
+	*Reader << Magic << Version << FormatName << UncompressedSize << ChunkNum;
+	if (Version != CompressedFile::FileVersion || ChunkNum < 0 || UncompressedSize < 0 || Reader->IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a valid compressed file."), *InFile);
+		return false;
+	}
+	FName CompressionFormat(*FormatName);
+
+	TArray<int32> CompressedSizes;
+	TArray<int32> UncompressedSizes;
+	TArray<int64> CompressedOffsets;
+	TArray<int64> UncompressedOffsets;
+	int64 TotalCompressedSize = 0;
+	int64 TotalUncompressedSize = 0;
+	for (int32 ChunkIndex = 0; ChunkIndex < ChunkNum; ++ChunkIndex)
+	{
+		int32 CompressedSize = 0;
+		int32 ChunkUncompressedSize = 0;
+		*Reader << CompressedSize << ChunkUncompressedSize;
+		CompressedSizes.Add(CompressedSize);
+		UncompressedSizes.Add(ChunkUncompressedSize);
+		CompressedOffsets.Add(TotalCompressedSize);
+		UncompressedOffsets.Add(TotalUncompressedSize);
+		TotalCompressedSize += CompressedSize;
+		TotalUncompressedSize += ChunkUncompressedSize;
+	}
+	if (TotalUncompressedSize != UncompressedSize || Reader->IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s chunk table is corrupted."), *InFile);
+		return false;
+	}
+
+	TArray<uint8> CompressedData;
+	CompressedData.SetNumUninitialized(TotalCompressedSize);
+	Reader->Serialize(CompressedData.GetData(), TotalCompressedSize);
+	if (Reader->IsError())
+		return false;
+	Reader.Reset();
+
+	TArray<uint8> UncompressedData;
+	UncompressedData.SetNumUninitialized(UncompressedSize);
+	TArray<bool> ChunkStatus;
+	ChunkStatus.SetNumZeroed(ChunkNum);
+	ParallelFor(ChunkNum, [&](int32 ChunkIndex)
+	{
+		ChunkStatus[ChunkIndex] = FCompression::UncompressMemory(
+			CompressionFormat,
+			UncompressedData.GetData() + UncompressedOffsets[ChunkIndex],
+			UncompressedSizes[ChunkIndex],
+			CompressedData.GetData() + CompressedOffsets[ChunkIndex],
+			CompressedSizes[ChunkIndex]
+		);
+	});
+	if (ChunkStatus.Contains(false))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Uncompress %s faild,format is %s."), *InFile, *FormatName);
+		return false;
+	}
+
+	FUTF8ToTCHAR Converted((const ANSICHAR*)UncompressedData.GetData(), UncompressedData.Num());
+	OutString = FString(Converted.Length(), Converted.Get());
+	return true;
+}
+
+bool UFLibAssetManageHelperEx::SaveStringToCompressedFile(const FString& InFile, const FString& InString, FName InCompressionFormat)
+{
+	HOTPATCHER_TRACE_SCOPE(SaveStringToCompressedFile);
+	FName CompressionFormat = InCompressionFormat;
+	if (!FCompression::IsFormatValid(CompressionFormat))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Compression format %s is not available,use Zlib."), *CompressionFormat.ToString());
+		CompressionFormat = NAME_Zlib;
+	}
+
+	FTCHARToUTF8 UTF8String(*InString);
+	const uint8* UncompressedData = (const uint8*)UTF8String.Get();
+	const int64 UncompressedSize = UTF8String.Length();
+	const int32 ChunkNum = (int32)FMath::DivideAndRoundUp<int64>(UncompressedSize, CompressedFile::ChunkSize);
+
+	TArray<TArray<uint8>> CompressedChunks;
+	CompressedChunks.SetNum(ChunkNum);
+	TArray<int32> UncompressedSizes;
+	UncompressedSizes.SetNumZeroed(ChunkNum);
+	TArray<bool> ChunkStatus;
+	ChunkStatus.SetNumZeroed(ChunkNum);
+	ParallelFor(ChunkNum, [&](int32 ChunkIndex)
+	{
+		const int64 ChunkOffset = (int64)ChunkIndex * CompressedFile::ChunkSize;
+		const int32 ChunkSize = (int32)FMath::Min<int64>(CompressedFile::ChunkSize, UncompressedSize - ChunkOffset);
+		TArray<uint8>& CompressedChunk = CompressedChunks[ChunkIndex];
+
+		int32 CompressedSize = FCompression::CompressMemoryBound(CompressionFormat, ChunkSize);
+		CompressedChunk.SetNumUninitialized(CompressedSize);
+		ChunkStatus[ChunkIndex] = FCompression::CompressMemory(CompressionFormat, CompressedChunk.GetData(), CompressedSize, UncompressedData + ChunkOffset, ChunkSize);
+		CompressedChunk.SetNum(CompressedSize, false);
+		UncompressedSizes[ChunkIndex] = ChunkSize;
+	});
+	if (ChunkStatus.Contains(false))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Compress %s faild,format is %s."), *InFile, *CompressionFormat.ToString());
+		return false;
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*InFile));
+	if (!Writer)
+		return false;
+
+	uint32 Magic = CompressedFile::FileMagic;
+	int32 Version = CompressedFile::FileVersion;
+	FString FormatName = CompressionFormat.ToString();
+	int64 TotalSize = UncompressedSize;
+	int32 TotalChunkNum = ChunkNum;
+	*Writer << Magic << Version << FormatName << TotalSize << TotalChunkNum;
+	for (int32 ChunkIndex = 0; ChunkIndex < ChunkNum; ++ChunkIndex)
+	{
+		int32 CompressedSize = CompressedChunks[ChunkIndex].Num();
+		*Writer << CompressedSize << UncompressedSizes[ChunkIndex];
+	}
+	for (auto& CompressedChunk : CompressedChunks)
+	{
+		Writer->Serialize(CompressedChunk.GetData(), CompressedChunk.Num());
+	}
+	FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesWritten, Writer->Tell());
+	return Writer->Close();
+}
+
+bool UFLibAssetManageHelperEx::SaveFileToCompressedFile(const FString& InFile, const FString& InSourceFile, FName InCompressionFormat)
+{
+	HOTPATCHER_TRACE_SCOPE(SaveFileToCompressedFile);
+	FName CompressionFormat = InCompressionFormat;
+	if (!FCompression::IsFormatValid(CompressionFormat))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Compression format %s is not available,use Zlib."), *CompressionFormat.ToString());
+		CompressionFormat = NAME_Zlib;
+	}
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InSourceFile));
+	if (!Reader)
+		return false;
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*InFile));
+	if (!Writer)
+		return false;
+
+	uint32 Magic = CompressedFile::FileMagic;
+	int32 Version = CompressedFile::FileVersion;
+	FString FormatName = CompressionFormat.ToString();
+	int64 TotalSize = Reader->TotalSize();
+	int32 TotalChunkNum = (int32)FMath::DivideAndRoundUp<int64>(TotalSize, CompressedFile::ChunkSize);
+	*Writer << Magic << Version << FormatName << TotalSize << TotalChunkNum;
+
+	// the chunk table is written after all chunks are compressed
+	const int64 ChunkTableOffset = Writer->Tell();
+	TArray<int32> CompressedSizes;
+	TArray<int32> UncompressedSizes;
+	CompressedSizes.SetNumZeroed(TotalChunkNum);
+	UncompressedSizes.SetNumZeroed(TotalChunkNum);
+	for (int32 ChunkIndex = 0; ChunkIndex < TotalChunkNum; ++ChunkIndex)
+	{
+		*Writer << CompressedSizes[ChunkIndex] << UncompressedSizes[ChunkIndex];
+	}
+
+	TArray<uint8> UncompressedChunk;
+	TArray<uint8> CompressedChunk;
+	for (int32 ChunkIndex = 0; ChunkIndex < TotalChunkNum; ++ChunkIndex)
+	{
+		const int32 ChunkSize = (int32)FMath::Min<int64>(CompressedFile::ChunkSize, TotalSize - (int64)ChunkIndex * CompressedFile::ChunkSize);
+		UncompressedChunk.SetNumUninitialized(ChunkSize, false);
+		Reader->Serialize(UncompressedChunk.GetData(), ChunkSize);
+
+		int32 CompressedSize = FCompression::CompressMemoryBound(CompressionFormat, ChunkSize);
+		CompressedChunk.SetNumUninitialized(CompressedSize, false);
+		if (Reader->IsError() || !FCompression::CompressMemory(CompressionFormat, CompressedChunk.GetData(), CompressedSize, UncompressedChunk.GetData(), ChunkSize))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Compress %s faild,format is %s."), *InSourceFile, *CompressionFormat.ToString());
+			return false;
+		}
+		Writer->Serialize(CompressedChunk.GetData(), CompressedSize);
+		CompressedSizes[ChunkIndex] = CompressedSize;
+		UncompressedSizes[ChunkIndex] = ChunkSize;
+	}
+
+	const int64 EndOffset = Writer->Tell();
+	Writer->Seek(ChunkTableOffset);
+	for (int32 ChunkIndex = 0; ChunkIndex < TotalChunkNum; ++ChunkIndex)
+	{
+		*Writer << CompressedSizes[ChunkIndex] << UncompressedSizes[ChunkIndex];
+	}
+	Writer->Seek(EndOffset);
+	FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesWritten, EndOffset);
+	return Writer->Close();
+}
+
+bool UFLibAssetManageHelperEx::IsCompressedFile(const FString& InFile)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InFile));
+	if (!Reader || Reader->TotalSize() < (int64)sizeof(uint32))
+		return false;
+	uint32 Magic = 0;
+	*Reader << Magic;
+	return Magic == CompressedFile::FileMagic;
 }
 
 bool UFLibAssetManageHelperEx::GetPluginModuleAbsDir(const FString& InPluginModuleName, FString& OutPath)
@@ -1074,6 +1462,7 @@ bool UFLibAssetManageHelperEx::ConvRelativeDirToAbsDir(const FString& InRelative
 			FString RelativeToModule = InRelativePath.Replace(*BelongModuleName, TEXT("Content"));
 		
 			FString FinalFilterPath = FPaths::Combine(ModuleAbsPath, RelativeToModule);
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 			if (FPaths::DirectoryExists(FinalFilterPath))
 			{
 				OutAbsPath = FinalFilterPath;
@@ -1156,11 +1545,14 @@ TArray<FString> UFLibAssetManageHelperEx::GetAllTargetPlatform()
 
 bool UFLibAssetManageHelperEx::FindFilesRecursive(const FString& InStartDir, TArray<FString>& OutFileList, bool InRecursive)
 {
+	HOTPATCHER_TRACE_SCOPE(FindFilesRecursive);
 	TArray<FString> CurrentFolderFileList;
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if (!FPaths::DirectoryExists(InStartDir))
 		return false;
 
 	FFillArrayDirectoryVisitor FileVisitor;
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	IFileManager::Get().IterateDirectoryRecursively(*InStartDir, FileVisitor);
 
 	OutFileList.Append(FileVisitor.Files);
@@ -0,0 +1,243 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FHotPatcherProfiler.h"
+
+// engine header
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/ThreadingBase.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+namespace HotPatcherProfiler
+{
+	struct FProfileEvent
+	{
+		FString Name;
+		FString Track;
+		double BeginTime;
+		double EndTime;
+		TArray<TPair<FString, int64>> Args;
+	};
+
+	struct FProfileSession
+	{
+		FString Name;
+		double BeginTime;
+		FHotPatcherProfiler::FCounterValues BeginCounters;
+	};
+
+	static FCriticalSection CriticalSection;
+	static TArray<FProfileEvent> Events;
+	static TMap<int32, FProfileSession> Sessions;
+	static int32 NextProfileHandle = 0;
+	static FThreadSafeCounter ActiveProfileNum;
+	static FThreadSafeCounter64 Counters[(int32)EHotPatcherCounter::Num];
+
+	static FString GetCurrentThreadTrack()
+	{
+		if (IsInGameThread())
+			return TEXT("GameThread");
+		uint32 ThreadId = FPlatformTLS::GetCurrentThreadId();
+		FString ThreadName = FThreadManager::Get().GetThreadName(ThreadId);
+		return ThreadName.IsEmpty() ? FString::Printf(TEXT("Thread %u"), ThreadId) : ThreadName;
+	}
+}
+
+int32 FHotPatcherProfiler::BeginProfile(const FString& InName)
+{
+	using namespace HotPatcherProfiler;
+	FProfileSession Session;
+	Session.Name = InName;
+	Session.BeginTime = FPlatformTime::Seconds();
+	GetCounterValues(Session.BeginCounters);
+
+	FScopeLock Lock(&CriticalSection);
+	int32 ProfileHandle = ++NextProfileHandle;
+	Sessions.Add(ProfileHandle, Session);
+	ActiveProfileNum.Increment();
+	return ProfileHandle;
+}
+
+bool FHotPatcherProfiler::EndProfile(int32 InProfileHandle, const FString& InSaveFile)
+{
+	using namespace HotPatcherProfiler;
+	const double EndTime = FPlatformTime::Seconds();
+	FCounterValues EndCounters;
+	GetCounterValues(EndCounters);
+
+	FProfileSession Session;
+	TArray<FProfileEvent> SessionEvents;
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (!Sessions.RemoveAndCopyValue(InProfileHandle, Session))
+			return false;
+		if (!InSaveFile.IsEmpty())
+		{
+			for (const auto& Event : Events)
+			{
+				if (Event.BeginTime >= Session.BeginTime && Event.EndTime <= EndTime)
+				{
+					SessionEvents.Add(Event);
+				}
+			}
+		}
+		if (!ActiveProfileNum.Decrement())
+		{
+			Events.Empty();
+		}
+	}
+	if (InSaveFile.IsEmpty())
+		return true;
+
+	// the thread and other tracks are the tid of events
+	TMap<FString, int32> TrackIds;
+	for (const auto& Event : SessionEvents)
+	{
+		if (!TrackIds.Contains(Event.Track))
+		{
+			TrackIds.Add(Event.Track, TrackIds.Num() + 1);
+		}
+	}
+
+	FString TraceContent;
+	auto JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&TraceContent);
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteArrayStart(TEXT("traceEvents"));
+	for (const auto& TrackId : TrackIds)
+	{
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("name"), TEXT("thread_name"));
+		JsonWriter->WriteValue(TEXT("ph"), TEXT("M"));
+		JsonWriter->WriteValue(TEXT("pid"), 1);
+		JsonWriter->WriteValue(TEXT("tid"), TrackId.Value);
+		JsonWriter->WriteObjectStart(TEXT("args"));
+		JsonWriter->WriteValue(TEXT("name"), TrackId.Key);
+		JsonWriter->WriteObjectEnd();
+		JsonWriter->WriteObjectEnd();
+	}
+	for (const auto& Event : SessionEvents)
+	{
+		// the time unit of trace event is microsecond
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("name"), Event.Name);
+		JsonWriter->WriteValue(TEXT("cat"), TEXT("HotPatcher"));
+		JsonWriter->WriteValue(TEXT("ph"), TEXT("X"));
+		JsonWriter->WriteValue(TEXT("pid"), 1);
+		JsonWriter->WriteValue(TEXT("tid"), TrackIds[Event.Track]);
+		JsonWriter->WriteValue(TEXT("ts"), (Event.BeginTime - Session.BeginTime) * 1000000.0);
+		JsonWriter->WriteValue(TEXT("dur"), (Event.EndTime - Event.BeginTime) * 1000000.0);
+		JsonWriter->WriteObjectStart(TEXT("args"));
+		for (const auto& Arg : Event.Args)
+		{
+			JsonWriter->WriteValue(Arg.Key, Arg.Value);
+		}
+		JsonWriter->WriteObjectEnd();
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+	JsonWriter->WriteValue(TEXT("displayTimeUnit"), TEXT("ms"));
+	JsonWriter->WriteObjectStart(TEXT("otherData"));
+	JsonWriter->WriteValue(TEXT("name"), Session.Name);
+	JsonWriter->WriteValue(TEXT("duration"), EndTime - Session.BeginTime);
+	for (int32 CounterIndex = 0; CounterIndex < (int32)EHotPatcherCounter::Num; ++CounterIndex)
+	{
+		JsonWriter->WriteValue(GetCounterName((EHotPatcherCounter)CounterIndex), EndCounters.Values[CounterIndex] - Session.BeginCounters.Values[CounterIndex]);
+	}
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	bool bSaved = FFileHelper::SaveStringToFile(TraceContent, *InSaveFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	UE_LOG(LogTemp, Log, TEXT("Save build profile %s %s."), *InSaveFile, bSaved ? TEXT("Successd") : TEXT("FAILD"));
+	return bSaved;
+}
+
+bool FHotPatcherProfiler::IsProfiling()
+{
+	return HotPatcherProfiler::ActiveProfileNum.GetValue() > 0;
+}
+
+void FHotPatcherProfiler::AddEvent(const FString& InName, const FString& InTrack, double InBeginTime, double InEndTime, const TArray<TPair<FString, int64>>& InArgs)
+{
+	using namespace HotPatcherProfiler;
+	if (!IsProfiling())
+		return;
+	FProfileEvent Event;
+	Event.Name = InName;
+	Event.Track = InTrack.IsEmpty() ? GetCurrentThreadTrack() : InTrack;
+	Event.BeginTime = InBeginTime;
+	Event.EndTime = InEndTime;
+	Event.Args = InArgs;
+
+	FScopeLock Lock(&CriticalSection);
+	Events.Add(MoveTemp(Event));
+}
+
+void FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter InCounter, int64 InValue)
+{
+	if (IsProfiling())
+	{
+		HotPatcherProfiler::Counters[(int32)InCounter].Add(InValue);
+	}
+}
+
+void FHotPatcherProfiler::GetCounterValues(FCounterValues& OutValues)
+{
+	for (int32 CounterIndex = 0; CounterIndex < (int32)EHotPatcherCounter::Num; ++CounterIndex)
+	{
+		OutValues.Values[CounterIndex] = HotPatcherProfiler::Counters[CounterIndex].GetValue();
+	}
+}
+
+const TCHAR* FHotPatcherProfiler::GetCounterName(EHotPatcherCounter InCounter)
+{
+	switch (InCounter)
+	{
+	case EHotPatcherCounter::AssetsVisited: return TEXT("AssetsVisited");
+	case EHotPatcherCounter::FilesHashed: return TEXT("FilesHashed");
+	case EHotPatcherCounter::BytesRead: return TEXT("BytesRead");
+	case EHotPatcherCounter::BytesWritten: return TEXT("BytesWritten");
+	default: return TEXT("Unknown");
+	}
+}
+
+FHotPatcherScopedTimer::FHotPatcherScopedTimer(const FString& InName)
+	: bEnabled(FHotPatcherProfiler::IsProfiling()), BeginTime(0.0)
+{
+	if (bEnabled)
+	{
+		Name = InName;
+		BeginTime = FPlatformTime::Seconds();
+		FHotPatcherProfiler::GetCounterValues(BeginCounters);
+	}
+}
+
+FHotPatcherScopedTimer::~FHotPatcherScopedTimer()
+{
+	if (!bEnabled)
+		return;
+	const double EndTime = FPlatformTime::Seconds();
+	FHotPatcherProfiler::FCounterValues EndCounters;
+	FHotPatcherProfiler::GetCounterValues(EndCounters);
+	for (int32 CounterIndex = 0; CounterIndex < (int32)EHotPatcherCounter::Num; ++CounterIndex)
+	{
+		int64 Increment = EndCounters.Values[CounterIndex] - BeginCounters.Values[CounterIndex];
+		if (Increment)
+		{
+			Args.Emplace(FHotPatcherProfiler::GetCounterName((EHotPatcherCounter)CounterIndex), Increment);
+		}
+	}
+	FHotPatcherProfiler::AddEvent(Name, FString{}, BeginTime, EndTime, Args);
+}
+
+void FHotPatcherScopedTimer::AddArg(const FString& InKey, int64 InValue)
+{
+	if (bEnabled)
+	{
+		Args.Emplace(InKey, InValue);
+	}
+}
@@ -0,0 +1,11 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HotPatcherTrace.h"
+
+#if ENGINE_MAJOR_VERSION >= 5
+UE_TRACE_CHANNEL_DEFINE(HotPatcherChannel);
+#endif
+
+DEFINE_STAT(STAT_HotPatcher_AssetRegistryQueries);
+DEFINE_STAT(STAT_HotPatcher_FileSystemProbes);
+DEFINE_STAT(STAT_HotPatcher_JsonAllocations);
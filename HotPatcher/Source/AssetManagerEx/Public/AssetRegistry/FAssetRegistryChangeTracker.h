@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "AssetData.h"
+#include "Delegates/IDelegateInstance.h"
+#include "Delegates/DelegateCombinations.h"
+
+struct FFileChangeData;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTrackedPackageChanged, FName);
+
+/**
+ * Track the asset registry changes(add,remove,rename and save) between the exports.
+ * The package files changed outside the editor(e.g. source control sync) are watched by the directory watcher,
+ * they are rescanned by the asset registry before the refresh or ScanPendingFiles.
+ * The asset manager database is only rebuilt when something changed since the last refresh,
+ * the asset manager has no partial update,the unchanged exports skip the rebuild.
+ * Not tracking(e.g. commandlet) always refresh.
+ */
+class ASSETMANAGEREX_API FAssetRegistryChangeTracker
+{
+public:
+	static FAssetRegistryChangeTracker& Get();
+
+	// subscribe the events in the game thread,called by the editor module
+	void StartTracking();
+	void StopTracking();
+	FORCEINLINE bool IsTracking()const { return bTracking; }
+	// rescan the package files changed on disk,the changed packages are already marked,must be called in the game thread
+	void ScanPendingFiles();
+
+	// refresh if any asset changed since the last refresh,InForceRefresh rebuild the database anyway,must be called in the game thread
+	void RefreshAssetManagerDatabase(bool InForceRefresh = false);
+	// the packages changed since the last refresh
+	FORCEINLINE const TSet<FName>& GetChangedPackages()const { return ChangedPackages; }
+	// increased by every change,used to check whether the cached analysis is outdated
+	FORCEINLINE uint64 GetChangeSerial()const { return ChangeSerial; }
+	// broadcast in the game thread for every changed package,e.g. the pending patch update incrementally
+	FORCEINLINE FOnTrackedPackageChanged& OnPackageChanged() { return PackageChangedEvent; }
+
+protected:
+	void MarkPackageChanged(FName InPackageName);
+	void OnAssetAdded(const FAssetData& InAssetData);
+	void OnAssetRemoved(const FAssetData& InAssetData);
+	void OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath);
+	void OnPackageSaved(const FString& InPackageFilename, UObject* InOuter);
+	void OnDirectoryChanged(const TArray<FFileChangeData>& InFileChanges);
+	void WatchContentDirectories();
+	void UnwatchContentDirectories();
+
+private:
+	bool bTracking = false;
+	// the database is up to date if no asset changed after it
+	bool bDatabaseCurrent = false;
+	TSet<FName> ChangedPackages;
+	uint64 ChangeSerial = 0;
+	FOnTrackedPackageChanged PackageChangedEvent;
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle PackageSavedHandle;
+	// the absolute package files changed on disk,not rescanned yet
+	TSet<FString> PendingFiles;
+	// the content directory and the handle of directory watcher
+	TArray<TPair<FString, FDelegateHandle>> WatchedDirectories;
+};
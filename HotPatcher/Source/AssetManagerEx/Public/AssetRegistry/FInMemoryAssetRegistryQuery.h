@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "IAssetRegistryQuery.h"
+
+// engine header
+#include "CoreMinimal.h"
+
+/**
+ * The asset registry in memory,all packages are added by AddAsset and AddDependency.
+ * FARFilter supports PackageNames,PackagePaths(and bRecursivePaths),ObjectPaths and ClassNames,the tags and the recursive classes are ignored.
+ * Read only after built,the queries are thread safe.
+ */
+class ASSETMANAGEREX_API FInMemoryAssetRegistryQuery : public IAssetRegistryQuery
+{
+public:
+	// the asset is named by the package,e.g. /Game/TEST/BP_Actor.BP_Actor
+	void AddAsset(const FString& InLongPackageName, FName InAssetClass, const FGuid& InPackageGuid);
+	void AddAsset(const FAssetData& InAssetData, const FGuid& InPackageGuid);
+	// add a dependency edge,InPackageName depends on InDependency
+	void AddDependency(FName InPackageName, FName InDependency);
+	void Reset();
+
+	FORCEINLINE int32 GetPackageNum()const { return PackageDatas.Num(); }
+
+	virtual bool GetAllAssets(TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const override;
+	virtual bool GetAssets(const FARFilter& InFilter, TArray<FAssetData>& OutAssetData)const override;
+	virtual bool GetAssetsByPackageName(FName InPackageName, TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const override;
+	virtual bool GetAssetByObjectPath(FName InObjectPath, FAssetData& OutAssetData)const override;
+	virtual bool GetDependencies(FName InPackageName, TArray<FName>& OutDependencies)const override;
+	virtual bool GetReferencers(FName InPackageName, TArray<FName>& OutReferencers)const override;
+	virtual const FAssetPackageData* GetAssetPackageData(FName InPackageName)const override;
+	virtual bool DoesPackageExist(const FString& InLongPackageName)const override;
+	virtual void GetSubPaths(const FString& InBasePath, TArray<FString>& OutPathList, bool bInRecurse)const override;
+	virtual void EnumeratePackagesInPath(FName InPackagePath, TFunctionRef<bool(FName)> InFunc)const override;
+	// the packages are added by AddAsset,nothing on disk
+	virtual void ScanModifiedFiles(const TArray<FString>& InFiles)const override {}
+
+private:
+	TArray<FAssetData> Assets;
+	TMap<FName, TArray<int32>> PackageAssetIndexs;
+	TMap<FName, int32> ObjectPathIndexs;
+	TMap<FName, FAssetPackageData> PackageDatas;
+	// key is the package path,e.g. /Game/TEST
+	TMap<FName, TArray<FName>> PathPackages;
+	TMap<FName, TArray<FName>> Dependencies;
+	TMap<FName, TArray<FName>> Referencers;
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "AssetData.h"
+#include "ARFilter.h"
+#include "AssetRegistryState.h"
+#include "Templates/SharedPointer.h"
+
+/**
+ * The asset registry queries used by the analysis of UFLibAssetManageHelperEx.
+ * The asset registry of the loaded project is used by default,replace it by FInMemoryAssetRegistryQuery to run the analysis without a project,
+ * e.g. the benchmark and the headless tests,or by the captured snapshot of the batch export.
+ * The packages are long package names,e.g. /Game/TEST/BP_Actor.
+ */
+class ASSETMANAGEREX_API IAssetRegistryQuery
+{
+public:
+	virtual ~IAssetRegistryQuery() {}
+
+	virtual bool GetAllAssets(TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const = 0;
+	virtual bool GetAssets(const FARFilter& InFilter, TArray<FAssetData>& OutAssetData)const = 0;
+	virtual bool GetAssetsByPackageName(FName InPackageName, TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const = 0;
+	// e.g. /Game/TEST/BP_Actor.BP_Actor,return false if the asset is not found
+	virtual bool GetAssetByObjectPath(FName InObjectPath, FAssetData& OutAssetData)const = 0;
+	// the package dependencies
+	virtual bool GetDependencies(FName InPackageName, TArray<FName>& OutDependencies)const = 0;
+	// the packages depend on InPackageName
+	virtual bool GetReferencers(FName InPackageName, TArray<FName>& OutReferencers)const = 0;
+	virtual const FAssetPackageData* GetAssetPackageData(FName InPackageName)const = 0;
+	virtual bool DoesPackageExist(const FString& InLongPackageName)const = 0;
+	// e.g. /Game/Maps of /Game
+	virtual void GetSubPaths(const FString& InBasePath, TArray<FString>& OutPathList, bool bInRecurse)const = 0;
+	// the packages in the path one by one,not recursive,the assets are got by pages of them.return false in InFunc to stop
+	virtual void EnumeratePackagesInPath(FName InPackagePath, TFunctionRef<bool(FName)> InFunc)const = 0;
+	// rescan the package files changed on disk,e.g. synced by source control
+	virtual void ScanModifiedFiles(const TArray<FString>& InFiles)const = 0;
+
+	// the query used by UFLibAssetManageHelperEx,the query of current thread,the replaced query or the asset registry
+	static const IAssetRegistryQuery& Get();
+	// replace the query,nullptr restore the asset registry.don't replace it while analysing
+	static void Set(TSharedPtr<IAssetRegistryQuery, ESPMode::ThreadSafe> InQuery);
+
+protected:
+	// FARFilter of PackageNames,PackagePaths(and bRecursivePaths),ObjectPaths and ClassNames,the tags and the recursive classes are ignored
+	static bool IsFilterMatched(const FARFilter& InFilter, const FAssetData& InAssetData);
+};
+
+// the adapter of the asset registry module
+class ASSETMANAGEREX_API FAssetRegistryQuery : public IAssetRegistryQuery
+{
+public:
+	virtual bool GetAllAssets(TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const override;
+	virtual bool GetAssets(const FARFilter& InFilter, TArray<FAssetData>& OutAssetData)const override;
+	virtual bool GetAssetsByPackageName(FName InPackageName, TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const override;
+	virtual bool GetAssetByObjectPath(FName InObjectPath, FAssetData& OutAssetData)const override;
+	virtual bool GetDependencies(FName InPackageName, TArray<FName>& OutDependencies)const override;
+	virtual bool GetReferencers(FName InPackageName, TArray<FName>& OutReferencers)const override;
+	virtual const FAssetPackageData* GetAssetPackageData(FName InPackageName)const override;
+	virtual bool DoesPackageExist(const FString& InLongPackageName)const override;
+	virtual void GetSubPaths(const FString& InBasePath, TArray<FString>& OutPathList, bool bInRecurse)const override;
+	// the package files on disk
+	virtual void EnumeratePackagesInPath(FName InPackagePath, TFunctionRef<bool(FName)> InFunc)const override;
+	virtual void ScanModifiedFiles(const TArray<FString>& InFiles)const override;
+};
+
+// replace the query in the scope,restore the previous query when leaving
+class ASSETMANAGEREX_API FScopedAssetRegistryQuery
+{
+public:
+	explicit FScopedAssetRegistryQuery(TSharedPtr<IAssetRegistryQuery, ESPMode::ThreadSafe> InQuery);
+	~FScopedAssetRegistryQuery();
+
+private:
+	TSharedPtr<IAssetRegistryQuery, ESPMode::ThreadSafe> PreviousQuery;
+};
+
+// replace the query of the current thread in the scope,e.g. the concurrent analyses of a snapshot,the query must outlive the scope
+class ASSETMANAGEREX_API FScopedThreadAssetRegistryQuery
+{
+public:
+	explicit FScopedThreadAssetRegistryQuery(const IAssetRegistryQuery& InQuery);
+	~FScopedThreadAssetRegistryQuery();
+
+private:
+	const IAssetRegistryQuery* PreviousQuery;
+};
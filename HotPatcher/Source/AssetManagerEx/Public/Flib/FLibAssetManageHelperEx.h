@@ -4,6 +4,7 @@
 
 #include "AssetManager/FAssetDependenciesInfo.h"
 #include "AssetManager/FAssetDetail.h"
+#include "IAssetRegistryQuery.h"
 
 #include "Templates/SharedPointer.h"
 #include "AssetRegistryModule.h"
@@ -65,7 +66,8 @@ public:
 		static FAssetDependenciesInfo CombineAssetDependencies(const FAssetDependenciesInfo& A, const FAssetDependenciesInfo& B);
 
 	// Get All invalid reference asset
-	static void GetAllInValidAssetInProject(FAssetDependenciesInfo InAllDependencies, TArray<FString> &OutInValidAsset, TArray<FString> InIgnoreModules = {});
+	// each asset directory is enumerated once and the existence check runs in parallel
+	static void GetAllInValidAssetInProject(const FAssetDependenciesInfo& InAllDependencies, TArray<FString> &OutInValidAsset, const TArray<FString>& InIgnoreModules = {});
 
 	/*
 	 @Param InLongPackageName: e.g /Game/TEST/BP_Actor don't pass /Game/TEST/BP_Actor.BP_Actor
@@ -84,9 +86,12 @@ public:
 	// 获取FAssetDependenciesInfo中所有的FAssetDetail
 	static void GetAssetDetailsByAssetDependenciesInfo(const FAssetDependenciesInfo& InAssetDependencies,TArray<FAssetDetail>& OutAssetDetails);
 
-	// recursive scan assets
+	// the maps in InAssets and their dependencies,in the breadth-first order of loading
+	static void GetMapsLoadOrder(const FAssetDependenciesInfo& InAssets, TArray<FString>& OutLongPackageNames);
+
+	// scan the dependencies recursively,the packages are walked by an explicit stack,the deep dependency chain doesn't overflow the call stack
 	static void GatherAssetDependicesInfoRecursively(
-		FAssetRegistryModule& InAssetRegistryModule,
+		const IAssetRegistryQuery& InAssetRegistryQuery,
 		const FString& InTargetLongPackageName,
 		FAssetDependenciesInfo& OutDependencies
 	);
@@ -119,8 +124,16 @@ public:
 	UFUNCTION(BlueprintPure, BlueprintCallable, Category = "GWorld|Flib|AssetManager")
 		static bool CombineAssetsDetailAsFAssetDepenInfo(const TArray<FAssetDetail>& InAssetsDetailList,FAssetDependenciesInfo& OutAssetInfo);
 
+	// e.g. /Game/Maps/Login to PROJECT_NAME/Content/Maps/Login,without postfix
+	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManager")
+		static bool ConvLongPackageNameToCookedRelativePath(const FString& InProjectAbsDir, const FString& InLongPackageName, FString& OutCookedRelativePath);
 	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManager")
 		static bool ConvLongPackageNameToCookedPath(const FString& InProjectAbsDir, const FString& InPlatformName, const FString& InLongPackageName, TArray<FString>& OutCookedAssetPath, TArray<FString>& OutCookedAssetRelativePath);
+	// PROJECT_DIR/Saved/Cooked/PLATFORM
+	static FString GetCookedRootDir(const FString& InProjectAbsDir, const FString& InPlatformName);
+	// visit the cooked files of all assets,InVisitor receive the path relative to the cooked root dir,e.g. PROJECT_NAME/Content/BP_Actor.uasset
+	// every cooked directory is listed only once
+	static bool IterateCookedAssetFiles(const FString& InProjectAbsDir, const FString& InPlatformName, const FAssetDependenciesInfo& InAssetDependencies, TFunctionRef<void(const FString&)> InVisitor);
 	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManager")
 		static bool GetCookCommandFromAssetDependencies(const FString& InProjectDir, const FString& InPlatformName, const FAssetDependenciesInfo& InAssetDependencies, const TArray<FString> &InCookParams, TArray<FString>& OutCookCommand);
 	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManager")
@@ -136,7 +149,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManager")
 		static bool SerializeAssetDependenciesToJson(const FAssetDependenciesInfo& InAssetDependencies, FString& OutJsonStr);
 	// UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManager")
-	static bool SerializeAssetDependenciesToJsonObject(const FAssetDependenciesInfo& InAssetDependencies, TSharedPtr<FJsonObject>& OutJsonObject, TArray<FString> InIgnoreModules={});
+	static bool SerializeAssetDependenciesToJsonObject(const FAssetDependenciesInfo& InAssetDependencies, TSharedPtr<FJsonObject>& OutJsonObject);
 	// deserialize asset dependencies to FAssetDependenciesIndo from string.
 	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManager")
 		static bool DeserializeAssetDependencies(const FString& InStream, FAssetDependenciesInfo& OutAssetDependencies);
@@ -151,8 +164,14 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManagerEx")
 		static bool SaveStringToFile(const FString& InFile, const FString& InString);
+	// compressed file is transparently decompressed
 	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|AssetManagerEx")
 		static bool LoadFileToString(const FString& InFile, FString& OutString);
+	// save string as UTF8 and compress it by chunks,e.g. Zlib/Oodle
+		static bool SaveStringToCompressedFile(const FString& InFile, const FString& InString, FName InCompressionFormat = NAME_Zlib);
+	// same format as SaveStringToCompressedFile,the source file is read and compressed chunk by chunk
+		static bool SaveFileToCompressedFile(const FString& InFile, const FString& InSourceFile, FName InCompressionFormat = NAME_Zlib);
+		static bool IsCompressedFile(const FString& InFile);
 
 
 	static FString GetAssetBelongModuleName(const FString& InAssetRelativePath);
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
+
+// accumulated by all threads,the timed scopes record the increments while they are running
+enum class EHotPatcherCounter : uint8
+{
+	AssetsVisited,
+	FilesHashed,
+	BytesRead,
+	BytesWritten,
+	Num
+};
+
+/**
+ * Collect the timed scopes of exports and save them as Chrome Trace Event format,open it in chrome://tracing or Perfetto.
+ * Scopes are recorded only while a profile is running,the concurrent profiles(e.g. batch export) share the recorded events,
+ * every profile saves the events in its own time range.
+ */
+class ASSETMANAGEREX_API FHotPatcherProfiler
+{
+public:
+	struct FCounterValues
+	{
+		int64 Values[(int32)EHotPatcherCounter::Num];
+	};
+
+	// return the handle passed to EndProfile
+	static int32 BeginProfile(const FString& InName);
+	// save the profile to InSaveFile,discard it if InSaveFile is empty
+	static bool EndProfile(int32 InProfileHandle, const FString& InSaveFile);
+	static bool IsProfiling();
+
+	// record a finished scope,the track is the name of calling thread if it's empty
+	static void AddEvent(const FString& InName, const FString& InTrack, double InBeginTime, double InEndTime, const TArray<TPair<FString, int64>>& InArgs = TArray<TPair<FString, int64>>{});
+
+	static void IncrementCounter(EHotPatcherCounter InCounter, int64 InValue = 1);
+	static void GetCounterValues(FCounterValues& OutValues);
+	static const TCHAR* GetCounterName(EHotPatcherCounter InCounter);
+};
+
+// time the scope and record the counter increments in it as the event args
+class ASSETMANAGEREX_API FHotPatcherScopedTimer
+{
+public:
+	explicit FHotPatcherScopedTimer(const FString& InName);
+	~FHotPatcherScopedTimer();
+
+	// extra args of the event,e.g. the num of pak commands
+	void AddArg(const FString& InKey, int64 InValue);
+
+private:
+	FString Name;
+	bool bEnabled;
+	double BeginTime;
+	FHotPatcherProfiler::FCounterValues BeginCounters;
+	TArray<TPair<FString, int64>> Args;
+};
+
+#define HOTPATCHER_SCOPED_TIMER(Name) FHotPatcherScopedTimer ANONYMOUS_VARIABLE(HotPatcherScopedTimer_)(Name)
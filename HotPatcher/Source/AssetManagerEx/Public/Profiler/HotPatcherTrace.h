@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+/**
+ * The hot paths of HotPatcher are traced next to the engine scopes.
+ * UE5 traces them on HotPatcherChannel(-trace=cpu,HotPatcher),4.25+ traces them as cpu scopes of Unreal Insights,
+ * the older engines have no Insights,they are cycle stats of STATGROUP_HotPatcher(stat HotPatcher,stat startfile).
+ * The per-call counters are accumulator stats,they are traced by the stats channel of Insights.
+ */
+#if ENGINE_MAJOR_VERSION >= 5
+	#include "Trace/Trace.h"
+	#include "ProfilingDebugging/CpuProfilerTrace.h"
+	UE_TRACE_CHANNEL_EXTERN(HotPatcherChannel, ASSETMANAGEREX_API);
+	#define HOTPATCHER_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(HotPatcher_##Name, HotPatcherChannel)
+#elif ENGINE_MINOR_VERSION >= 25
+	#include "ProfilingDebugging/CpuProfilerTrace.h"
+	#define HOTPATCHER_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE(HotPatcher_##Name)
+#else
+	#define HOTPATCHER_TRACE_SCOPE(Name) QUICK_SCOPE_CYCLE_COUNTER(STAT_HotPatcher_##Name)
+#endif
+
+DECLARE_STATS_GROUP(TEXT("HotPatcher"), STATGROUP_HotPatcher, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Asset Registry Queries"), STAT_HotPatcher_AssetRegistryQueries, STATGROUP_HotPatcher, ASSETMANAGEREX_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("File System Probes"), STAT_HotPatcher_FileSystemProbes, STATGROUP_HotPatcher, ASSETMANAGEREX_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Json Allocations"), STAT_HotPatcher_JsonAllocations, STATGROUP_HotPatcher, ASSETMANAGEREX_API);
+
+// Counter is AssetRegistryQueries,FileSystemProbes or JsonAllocations
+#define HOTPATCHER_TRACE_COUNT(Counter) INC_DWORD_STAT(STAT_HotPatcher_##Counter)
+#define HOTPATCHER_TRACE_COUNT_BY(Counter, Num) INC_DWORD_STAT_BY(STAT_HotPatcher_##Counter, Num)
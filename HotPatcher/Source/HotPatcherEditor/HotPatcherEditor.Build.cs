@@ -49,7 +49,9 @@ public class HotPatcherEditor : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
-				"HotPatcherRuntime"
+				"HotPatcherRuntime",
+				"Sockets",
+				"Networking"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,160 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "FHotPatcherSyntheticAssets.h"
+#include "FLibAssetManageHelperEx.h"
+
+// engine header
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+
+void FHotPatcherSyntheticAssets::GenerateSnapshot(const FSyntheticAssetGraphOptions& InOptions, FHotPatcherAssetSnapshot& OutSnapshot)
+{
+	const int32 NodeNum = FMath::Max(InOptions.NodeNum, 1);
+	FRandomStream Stream(InOptions.Seed);
+
+	TArray<FName> PackageNames;
+	TArray<FHotPatcherAssetSnapshot::FSnapshotPackage> Packages;
+	PackageNames.Reserve(NodeNum);
+	Packages.SetNum(NodeNum);
+	for (int32 NodeIndex = 0; NodeIndex < NodeNum; ++NodeIndex)
+	{
+		FString LongPackageName = FHotPatcherSyntheticAssets::GetLongPackageName(NodeIndex, InOptions);
+		FHotPatcherAssetSnapshot::FSnapshotPackage& Package = Packages[NodeIndex];
+		FAssetDetail AssetDetail = FHotPatcherSyntheticAssets::MakeAssetDetail(NodeIndex, InOptions, Stream);
+		Package.AssetData = FAssetData(*LongPackageName, *FPaths::GetPath(LongPackageName), *FPaths::GetBaseFilename(LongPackageName), *AssetDetail.mAssetType);
+		FGuid::Parse(AssetDetail.mGuid, Package.PackageData.PackageGuid);
+		Package.bHasPackageData = true;
+		Package.bIsOnDisk = true;
+		PackageNames.Add(*LongPackageName);
+	}
+
+	// the dependencies point to the later packages,the graph has cycles only by the CycleRatio
+	for (int32 NodeIndex = 0; NodeIndex < NodeNum; ++NodeIndex)
+	{
+		TArray<FName>& Dependencies = Packages[NodeIndex].Dependencies;
+		auto AddDependency = [&](int32 InDependencyIndex)
+		{
+			if (!Dependencies.Contains(PackageNames[InDependencyIndex]))
+			{
+				Dependencies.Add(PackageNames[InDependencyIndex]);
+				Packages[InDependencyIndex].Referencers.Add(PackageNames[NodeIndex]);
+			}
+		};
+		for (int32 Index = 0; Index < InOptions.FanOut && NodeIndex + 1 < NodeNum; ++Index)
+		{
+			AddDependency(Stream.RandRange(NodeIndex + 1, NodeNum - 1));
+		}
+		if (NodeIndex > 0 && Stream.FRand() < InOptions.CycleRatio)
+		{
+			AddDependency(Stream.RandRange(0, NodeIndex - 1));
+		}
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < NodeNum; ++NodeIndex)
+	{
+		OutSnapshot.AddPackage(PackageNames[NodeIndex], Packages[NodeIndex]);
+	}
+}
+
+void FHotPatcherSyntheticAssets::GenerateAssetRegistry(const FSyntheticAssetGraphOptions& InOptions, FInMemoryAssetRegistryQuery& OutAssetRegistry)
+{
+	FHotPatcherAssetSnapshot Snapshot;
+	FHotPatcherSyntheticAssets::GenerateSnapshot(InOptions, Snapshot);
+
+	OutAssetRegistry.Reset();
+	Snapshot.ForEachPackage([&OutAssetRegistry](FName InPackageName, const FHotPatcherAssetSnapshot::FSnapshotPackage& InPackage)
+	{
+		OutAssetRegistry.AddAsset(InPackage.AssetData, InPackage.PackageData.PackageGuid);
+		for (const auto& Dependency : InPackage.Dependencies)
+		{
+			OutAssetRegistry.AddDependency(InPackageName, Dependency);
+		}
+	});
+}
+
+void FHotPatcherSyntheticAssets::GenerateVersionPair(const FSyntheticAssetGraphOptions& InGraphOptions, const FSyntheticVersionOptions& InVersionOptions, FHotPatcherVersion& OutBaseVersion, FHotPatcherVersion& OutCurrentVersion)
+{
+	const int32 NodeNum = FMath::Max(InGraphOptions.NodeNum, 1);
+	FRandomStream AssetStream(InGraphOptions.Seed);
+	FRandomStream ChurnStream(InVersionOptions.Seed);
+
+	TArray<FAssetDetail> BaseAssets;
+	TArray<FAssetDetail> CurrentAssets;
+	BaseAssets.Reserve(NodeNum);
+	CurrentAssets.Reserve(NodeNum);
+	for (int32 NodeIndex = 0; NodeIndex < NodeNum; ++NodeIndex)
+	{
+		FAssetDetail AssetDetail = FHotPatcherSyntheticAssets::MakeAssetDetail(NodeIndex, InGraphOptions, AssetStream);
+		BaseAssets.Add(AssetDetail);
+
+		float Churn = ChurnStream.FRand();
+		if (Churn < InVersionOptions.DeleteRatio)
+			continue;
+		if (Churn < InVersionOptions.DeleteRatio + InVersionOptions.ModifyRatio)
+		{
+			AssetDetail.mGuid = FGuid(ChurnStream.GetUnsignedInt(), ChurnStream.GetUnsignedInt(), ChurnStream.GetUnsignedInt(), ChurnStream.GetUnsignedInt()).ToString();
+		}
+		CurrentAssets.Add(AssetDetail);
+	}
+	const int32 AddNum = FMath::RoundToInt(NodeNum * InVersionOptions.AddRatio);
+	for (int32 NodeIndex = NodeNum; NodeIndex < NodeNum + AddNum; ++NodeIndex)
+	{
+		CurrentAssets.Add(FHotPatcherSyntheticAssets::MakeAssetDetail(NodeIndex, InGraphOptions, ChurnStream));
+	}
+
+	const TArray<FString> ModuleRootPaths = FHotPatcherSyntheticAssets::GetModuleRootPaths(InGraphOptions.ModuleNum);
+	OutBaseVersion = FHotPatcherVersion{};
+	OutBaseVersion.VersionId = TEXT("SyntheticBase");
+	OutBaseVersion.IncludeFilter = ModuleRootPaths;
+	UFLibAssetManageHelperEx::CombineAssetsDetailAsFAssetDepenInfo(BaseAssets, OutBaseVersion.AssetInfo);
+
+	OutCurrentVersion = FHotPatcherVersion{};
+	OutCurrentVersion.VersionId = TEXT("SyntheticCurrent");
+	OutCurrentVersion.BaseVersionId = OutBaseVersion.VersionId;
+	OutCurrentVersion.IncludeFilter = ModuleRootPaths;
+	UFLibAssetManageHelperEx::CombineAssetsDetailAsFAssetDepenInfo(CurrentAssets, OutCurrentVersion.AssetInfo);
+}
+
+TArray<FString> FHotPatcherSyntheticAssets::GetModuleRootPaths(int32 InModuleNum)
+{
+	TArray<FString> ModuleRootPaths;
+	ModuleRootPaths.Add(TEXT("/Game"));
+	for (int32 ModuleIndex = 1; ModuleIndex < InModuleNum; ++ModuleIndex)
+	{
+		ModuleRootPaths.Add(FString::Printf(TEXT("/SyntheticModule%d"), ModuleIndex));
+	}
+	return ModuleRootPaths;
+}
+
+FString FHotPatcherSyntheticAssets::GetLongPackageName(int32 InNodeIndex, const FSyntheticAssetGraphOptions& InOptions)
+{
+	const int32 ModuleIndex = InNodeIndex % FMath::Max(InOptions.ModuleNum, 1);
+	const int32 DirectoryIndex = InNodeIndex / FMath::Max(InOptions.DirectorySize, 1);
+	return FString::Printf(TEXT("%s/Dir%d/Asset_%d"),
+		ModuleIndex ? *FString::Printf(TEXT("/SyntheticModule%d"), ModuleIndex) : TEXT("/Game"),
+		DirectoryIndex,
+		InNodeIndex
+	);
+}
+
+int32 FHotPatcherSyntheticAssets::GetAssetNum(const FAssetDependenciesInfo& InAssetInfo)
+{
+	int32 AssetNum = 0;
+	for (const auto& ModuleDependencies : InAssetInfo.mDependencies)
+	{
+		AssetNum += ModuleDependencies.Value.mDependAssetDetails.Num();
+	}
+	return AssetNum;
+}
+
+FAssetDetail FHotPatcherSyntheticAssets::MakeAssetDetail(int32 InNodeIndex, const FSyntheticAssetGraphOptions& InOptions, FRandomStream& InStream)
+{
+	static const TCHAR* AssetTypes[] = { TEXT("Blueprint"), TEXT("Texture2D"), TEXT("StaticMesh"), TEXT("Material"), TEXT("SoundWave") };
+
+	FString LongPackageName = FHotPatcherSyntheticAssets::GetLongPackageName(InNodeIndex, InOptions);
+	FString PackagePath = LongPackageName + TEXT(".") + FPaths::GetBaseFilename(LongPackageName);
+	// a few maps,they are kept by the has ref assets only filter
+	FString AssetType = InStream.FRand() < 0.01f ? TEXT("World") : AssetTypes[InStream.RandHelper(ARRAY_COUNT(AssetTypes))];
+	FGuid Guid(InStream.GetUnsignedInt(), InStream.GetUnsignedInt(), InStream.GetUnsignedInt(), InStream.GetUnsignedInt());
+	return FAssetDetail(PackagePath, AssetType, Guid.ToString());
+}
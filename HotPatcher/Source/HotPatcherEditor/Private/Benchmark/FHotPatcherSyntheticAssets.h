@@ -0,0 +1,58 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+#include "CreatePatch/FHotPatcherAssetSnapshot.h"
+#include "FHotPatcherVersion.h"
+#include "AssetManager/FAssetDetail.h"
+#include "FInMemoryAssetRegistryQuery.h"
+
+// engine header
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+struct FSyntheticAssetGraphOptions
+{
+	// the dependencies of every asset are gathered one by one in the normal export,the time grows with the square of it
+	int32 NodeNum = 2000;
+	// the dependencies of every package
+	int32 FanOut = 4;
+	// the first module is /Game,the others are mounted as /SyntheticModuleN
+	int32 ModuleNum = 4;
+	// the ratio of packages depend on an earlier package,they make cycles in the graph
+	float CycleRatio = 0.05f;
+	// the packages of a directory
+	int32 DirectorySize = 100;
+	int32 Seed = 0;
+};
+
+struct FSyntheticVersionOptions
+{
+	// the ratio to the packages of base version
+	float AddRatio = 0.01f;
+	float ModifyRatio = 0.05f;
+	float DeleteRatio = 0.01f;
+	int32 Seed = 0;
+};
+
+/**
+ * Generate the asset registry graph and versions without a real project,used to measure the analysis,diff and serialization.
+ * The same options always generate the same assets.
+ */
+class FHotPatcherSyntheticAssets
+{
+public:
+	static void GenerateSnapshot(const FSyntheticAssetGraphOptions& InOptions, FHotPatcherAssetSnapshot& OutSnapshot);
+	// the same graph as GenerateSnapshot,queried by UFLibAssetManageHelperEx
+	static void GenerateAssetRegistry(const FSyntheticAssetGraphOptions& InOptions, FInMemoryAssetRegistryQuery& OutAssetRegistry);
+	// the base version contains all packages of the graph,the current version is the base version with churn
+	static void GenerateVersionPair(const FSyntheticAssetGraphOptions& InGraphOptions, const FSyntheticVersionOptions& InVersionOptions, FHotPatcherVersion& OutBaseVersion, FHotPatcherVersion& OutCurrentVersion);
+
+	// the root paths of all modules,e.g. /Game,/SyntheticModule1
+	static TArray<FString> GetModuleRootPaths(int32 InModuleNum);
+	// e.g. /SyntheticModule1/Dir0/Asset_1
+	static FString GetLongPackageName(int32 InNodeIndex, const FSyntheticAssetGraphOptions& InOptions);
+	static int32 GetAssetNum(const FAssetDependenciesInfo& InAssetInfo);
+
+protected:
+	static FAssetDetail MakeAssetDetail(int32 InNodeIndex, const FSyntheticAssetGraphOptions& InOptions, FRandomStream& InStream);
+};
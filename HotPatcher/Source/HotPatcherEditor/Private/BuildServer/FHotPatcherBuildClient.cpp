@@ -0,0 +1,85 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "FHotPatcherBuildClient.h"
+#include "FHotPatcherBuildServer.h"
+
+// engine header
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Serialization/JsonSerializer.h"
+
+bool FHotPatcherBuildClient::SendRequest(const FString& InServerAddress, const TSharedRef<FJsonObject>& InRequest, FString& OutErrorMsg)
+{
+	FIPv4Endpoint Endpoint;
+	if (!FIPv4Endpoint::Parse(InServerAddress, Endpoint))
+	{
+		OutErrorMsg = FString::Printf(TEXT("Invalid server address %s."), *InServerAddress);
+		return false;
+	}
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	FSocket* Socket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("HotPatcherBuildClient"), false);
+	if (!Socket || !Socket->Connect(*Endpoint.ToInternetAddr()))
+	{
+		OutErrorMsg = FString::Printf(TEXT("Connect to %s faild."), *InServerAddress);
+		if (Socket)
+		{
+			SocketSubsystem->DestroySocket(Socket);
+		}
+		return false;
+	}
+
+	bool bFinished = false;
+	bool bSuccessed = false;
+	if (FHotPatcherBuildServer::SendLine(Socket, FHotPatcherBuildServer::SerializeLine(InRequest)))
+	{
+		TArray<uint8> ReceivedData;
+		int32 ScannedSize = 0;
+		TArray<uint8> Buffer;
+		Buffer.SetNumUninitialized(64 * 1024);
+		while (!bFinished)
+		{
+			if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(1.0)))
+				continue;
+			int32 BytesRead = 0;
+			if (!Socket->Recv(Buffer.GetData(), Buffer.Num(), BytesRead) || !BytesRead)
+			{
+				OutErrorMsg = TEXT("The connection is closed by server.");
+				break;
+			}
+			ReceivedData.Append(Buffer.GetData(), BytesRead);
+
+			TArray<FString> Lines;
+			FHotPatcherBuildServer::PopLines(ReceivedData, ScannedSize, Lines);
+			for (const auto& Line : Lines)
+			{
+				TSharedPtr<FJsonObject> Response;
+				TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(Line);
+				if (!FJsonSerializer::Deserialize(JsonReader, Response) || !Response.IsValid())
+					continue;
+
+				double Progress = 0.0;
+				FString Message;
+				if (Response->TryGetNumberField(TEXT("Progress"), Progress) && Response->TryGetStringField(TEXT("Message"), Message))
+				{
+					UE_LOG(LogTemp, Display, TEXT("%3d%% %s"), FMath::RoundToInt(Progress * 100.0), *Message);
+				}
+				if (Response->TryGetBoolField(TEXT("Finished"), bFinished) && bFinished)
+				{
+					Response->TryGetBoolField(TEXT("Successed"), bSuccessed);
+					Response->TryGetStringField(TEXT("Error"), OutErrorMsg);
+					break;
+				}
+			}
+		}
+	}
+	else
+	{
+		OutErrorMsg = TEXT("Send request faild.");
+	}
+
+	Socket->Close();
+	SocketSubsystem->DestroySocket(Socket);
+	return bFinished && bSuccessed;
+}
@@ -0,0 +1,20 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+/**
+ * Send a request to FHotPatcherBuildServer and wait the job finished,the progress is printed to log.
+ */
+class FHotPatcherBuildClient
+{
+public:
+	/**
+	 * @param InServerAddress e.g. 127.0.0.1:8910
+	 * @param InRequest {"Command":"ExportPatch","Config":{...}},see FHotPatcherBuildServer
+	 */
+	static bool SendRequest(const FString& InServerAddress, const TSharedRef<FJsonObject>& InRequest, FString& OutErrorMsg);
+};
@@ -0,0 +1,405 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "FHotPatcherBuildServer.h"
+#include "CreatePatch/ExportPatchSettings.h"
+#include "CreatePatch/ExportReleaseSettings.h"
+#include "CreatePatch/FExportPatchPipeline.h"
+#include "CreatePatch/FExportReleasePipeline.h"
+#include "FlibHotPatcherEditorHelper.h"
+
+// engine header
+#include "AssetRegistryModule.h"
+#include "Common/TcpListener.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "UObject/Package.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "HAL/PlatformProcess.h"
+
+FHotPatcherBuildServer::FHotPatcherBuildServer()
+	: RunningSettings(nullptr), bSnapshotDirty(true), bStopRequested(false)
+{
+}
+
+FHotPatcherBuildServer::~FHotPatcherBuildServer()
+{
+	Stop();
+}
+
+bool FHotPatcherBuildServer::Start(int32 InPort)
+{
+	check(IsInGameThread());
+	if (IsRunning())
+		return true;
+
+	FIPv4Endpoint Endpoint(FIPv4Address::InternalLoopback, InPort);
+	Listener = MakeShareable(new FTcpListener(Endpoint, FTimespan::FromMilliseconds(100)));
+	if (!Listener->IsActive())
+	{
+		UE_LOG(LogTemp, Error, TEXT("HotPatcher build server listen on %s faild."), *Endpoint.ToString());
+		Listener.Reset();
+		return false;
+	}
+	Listener->OnConnectionAccepted().BindRaw(this, &FHotPatcherBuildServer::OnConnectionAccepted);
+
+	// the snapshot is captured again if any asset changed
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddLambda([this](const FAssetData&) { MarkSnapshotDirty(); });
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddLambda([this](const FAssetData&) { MarkSnapshotDirty(); });
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FHotPatcherBuildServer::OnAssetRenamed);
+	PackageSavedHandle = UPackage::PackageSavedEvent.AddLambda([this](const FString&, UObject*) { MarkSnapshotDirty(); });
+
+	// warm up before the first job
+	AssetSnapshot = MakeShareable(new FHotPatcherAssetSnapshot);
+	AssetSnapshot->Capture();
+	bSnapshotDirty = false;
+
+	UE_LOG(LogTemp, Display, TEXT("HotPatcher build server is listening on %s."), *Endpoint.ToString());
+	return true;
+}
+
+void FHotPatcherBuildServer::Stop()
+{
+	if (!IsRunning())
+		return;
+
+	Listener.Reset();
+	if (RunningPipeline.IsValid())
+	{
+		RunningPipeline->Cancel();
+		FHotPatcherPipeline::WaitForPipelines({ RunningPipeline.ToSharedRef() });
+	}
+
+	if (FModuleManager::Get().IsModuleLoaded(TEXT("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::GetModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+	UPackage::PackageSavedEvent.Remove(PackageSavedHandle);
+
+	TSharedPtr<FConnection> Accepted;
+	while (AcceptedConnections.Dequeue(Accepted))
+	{
+		Connections.Add(Accepted);
+	}
+	for (const auto& Connection : Connections)
+	{
+		CloseConnection(Connection);
+	}
+	Connections.Empty();
+	PendingJobs.Empty();
+	AssetSnapshot.Reset();
+	UE_LOG(LogTemp, Display, TEXT("HotPatcher build server is stopped."));
+}
+
+bool FHotPatcherBuildServer::OnConnectionAccepted(FSocket* InSocket, const FIPv4Endpoint& InEndpoint)
+{
+	InSocket->SetNonBlocking(true);
+	TSharedPtr<FConnection> Connection = MakeShareable(new FConnection);
+	Connection->Socket = InSocket;
+	Connection->Endpoint = InEndpoint;
+	AcceptedConnections.Enqueue(Connection);
+	return true;
+}
+
+void FHotPatcherBuildServer::Tick()
+{
+	check(IsInGameThread());
+	if (!IsRunning())
+		return;
+
+	TSharedPtr<FConnection> Accepted;
+	while (AcceptedConnections.Dequeue(Accepted))
+	{
+		UE_LOG(LogTemp, Log, TEXT("HotPatcher build server accept %s."), *Accepted->Endpoint.ToString());
+		Connections.Add(Accepted);
+	}
+
+	for (int32 Index = Connections.Num() - 1; Index >= 0; --Index)
+	{
+		TSharedPtr<FConnection> Connection = Connections[Index];
+		ReceiveRequests(Connection);
+		if (Connection->bClosed)
+		{
+			CloseConnection(Connection);
+			Connections.RemoveAt(Index);
+		}
+	}
+
+	if (!RunningPipeline.IsValid())
+	{
+		StartNextJob();
+	}
+}
+
+void FHotPatcherBuildServer::ReceiveRequests(const TSharedPtr<FConnection>& InConnection)
+{
+	if (InConnection->bClosed)
+		return;
+
+	TArray<FString> Lines;
+	uint32 PendingSize = 0;
+	while (InConnection->Socket->HasPendingData(PendingSize) && PendingSize > 0)
+	{
+		int32 Offset = InConnection->ReceivedData.Num();
+		int32 BytesRead = 0;
+		int32 ReadSize = FMath::Min<int32>(PendingSize, 64 * 1024);
+		InConnection->ReceivedData.AddUninitialized(ReadSize);
+		bool bReceived = InConnection->Socket->Recv(InConnection->ReceivedData.GetData() + Offset, ReadSize, BytesRead);
+		InConnection->ReceivedData.SetNum(Offset + (bReceived ? BytesRead : 0), false);
+		if (!bReceived)
+			break;
+		PopLines(InConnection->ReceivedData, InConnection->ScannedSize, Lines);
+
+		// the incomplete line is kept in memory,drop the client never sends the line break
+		if (InConnection->ReceivedData.Num() > MaxRequestLineSize)
+		{
+			UE_LOG(LogTemp, Error, TEXT("HotPatcher build server receive a request larger than %d bytes from %s,close the connection."), MaxRequestLineSize, *InConnection->Endpoint.ToString());
+			TSharedRef<FJsonObject> Response = MakeShareable(new FJsonObject);
+			Response->SetBoolField(TEXT("Finished"), true);
+			Response->SetBoolField(TEXT("Successed"), false);
+			Response->SetStringField(TEXT("Error"), FString::Printf(TEXT("The request is larger than %d bytes."), MaxRequestLineSize));
+			SendResponse(InConnection, Response);
+			InConnection->ReceivedData.Empty();
+			InConnection->ScannedSize = 0;
+			InConnection->bClosed = true;
+			return;
+		}
+	}
+
+	for (const auto& Line : Lines)
+	{
+		HandleRequest(InConnection, Line);
+	}
+
+	// recv return 0 byte if the connection is closed by client
+	uint8 Peek = 0;
+	int32 BytesRead = 0;
+	if (InConnection->Socket->Recv(&Peek, 1, BytesRead, ESocketReceiveFlags::Peek))
+	{
+		InConnection->bClosed = !BytesRead;
+	}
+	else
+	{
+		InConnection->bClosed = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() != SE_EWOULDBLOCK;
+	}
+}
+
+void FHotPatcherBuildServer::HandleRequest(const TSharedPtr<FConnection>& InConnection, const FString& InLine)
+{
+	if (InLine.IsEmpty())
+		return;
+
+	TSharedRef<FJsonObject> Response = MakeShareable(new FJsonObject);
+	Response->SetBoolField(TEXT("Finished"), true);
+	Response->SetBoolField(TEXT("Successed"), true);
+	Response->SetStringField(TEXT("Error"), TEXT(""));
+
+	TSharedPtr<FJsonObject> Request;
+	TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(InLine);
+	FString Command;
+	if (!FJsonSerializer::Deserialize(JsonReader, Request) || !Request.IsValid() || !Request->TryGetStringField(TEXT("Command"), Command))
+	{
+		Response->SetBoolField(TEXT("Successed"), false);
+		Response->SetStringField(TEXT("Error"), TEXT("Invalid request."));
+		SendResponse(InConnection, Response);
+		return;
+	}
+	UE_LOG(LogTemp, Log, TEXT("HotPatcher build server receive %s from %s."), *Command, *InConnection->Endpoint.ToString());
+
+	if (Command == TEXT("Ping"))
+	{
+		SendResponse(InConnection, Response);
+		return;
+	}
+	if (Command == TEXT("Stop"))
+	{
+		bStopRequested = true;
+		SendResponse(InConnection, Response);
+		return;
+	}
+
+	const TSharedPtr<FJsonObject>* Config = nullptr;
+	if ((Command != TEXT("ExportPatch") && Command != TEXT("ExportRelease")) || !Request->TryGetObjectField(TEXT("Config"), Config))
+	{
+		Response->SetBoolField(TEXT("Successed"), false);
+		Response->SetStringField(TEXT("Error"), FString::Printf(TEXT("Unknown command %s or no config."), *Command));
+		SendResponse(InConnection, Response);
+		return;
+	}
+
+	FBuildJob Job;
+	Job.Connection = InConnection;
+	Job.Command = Command;
+	Job.Config = *Config;
+	Request->TryGetBoolField(TEXT("Refresh"), Job.bRefresh);
+	PendingJobs.Add(Job);
+
+	TSharedRef<FJsonObject> Queued = MakeShareable(new FJsonObject);
+	Queued->SetNumberField(TEXT("Progress"), 0.0);
+	Queued->SetStringField(TEXT("Message"), FString::Printf(TEXT("Queued,%d jobs ahead."), PendingJobs.Num() - 1 + (RunningPipeline.IsValid() ? 1 : 0)));
+	SendResponse(InConnection, Queued);
+}
+
+void FHotPatcherBuildServer::StartNextJob()
+{
+	while (PendingJobs.Num() && !RunningPipeline.IsValid())
+	{
+		FBuildJob Job = PendingJobs[0];
+		PendingJobs.RemoveAt(0);
+		if (Job.Connection->bClosed)
+			continue;
+
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		if (Job.bRefresh)
+		{
+			AssetRegistry.SearchAllAssets(true);
+			bSnapshotDirty = true;
+		}
+
+		FString ConfigContent;
+		auto JsonWriter = TJsonWriterFactory<TCHAR>::Create(&ConfigContent);
+		FJsonSerializer::Serialize(Job.Config.ToSharedRef(), JsonWriter);
+
+		if (Job.Command == TEXT("ExportPatch"))
+		{
+			if (!AssetSnapshot.IsValid() || bSnapshotDirty)
+			{
+				// the running pipeline keep the old snapshot
+				AssetSnapshot = MakeShareable(new FHotPatcherAssetSnapshot);
+				AssetSnapshot->Capture();
+				bSnapshotDirty = false;
+			}
+			UExportPatchSettings* PatchSettings = NewObject<UExportPatchSettings>();
+			PatchSettings->AddToRoot();
+			UFlibHotPatcherEditorHelper::DeserializePatchConfig(MakeShareable(PatchSettings, [](UExportPatchSettings*) {}), ConfigContent);
+			RunningSettings = PatchSettings;
+			RunningPipeline = MakeShareable(new FExportPatchPipeline(PatchSettings, AssetSnapshot));
+		}
+		else
+		{
+			UExportReleaseSettings* ReleaseSettings = NewObject<UExportReleaseSettings>();
+			ReleaseSettings->AddToRoot();
+			UFlibHotPatcherEditorHelper::DeserializeReleaseConfig(MakeShareable(ReleaseSettings, [](UExportReleaseSettings*) {}), ConfigContent);
+			RunningSettings = ReleaseSettings;
+			RunningPipeline = MakeShareable(new FExportReleasePipeline(ReleaseSettings));
+		}
+
+		RunningConnection = Job.Connection;
+		RunningPipeline->ProgressDelegate.AddRaw(this, &FHotPatcherBuildServer::OnPipelineProgress);
+		RunningPipeline->FinishedDelegate.AddRaw(this, &FHotPatcherBuildServer::OnPipelineFinished);
+		RunningPipeline->Start();
+	}
+}
+
+void FHotPatcherBuildServer::OnPipelineProgress(const FText& InMsg, float InPercent)
+{
+	TSharedRef<FJsonObject> Response = MakeShareable(new FJsonObject);
+	Response->SetNumberField(TEXT("Progress"), InPercent);
+	Response->SetStringField(TEXT("Message"), InMsg.ToString());
+	SendResponse(RunningConnection, Response);
+}
+
+void FHotPatcherBuildServer::OnPipelineFinished(bool bInSuccessed, const FString& InErrorMsg)
+{
+	TSharedRef<FJsonObject> Response = MakeShareable(new FJsonObject);
+	Response->SetBoolField(TEXT("Finished"), true);
+	Response->SetBoolField(TEXT("Successed"), bInSuccessed);
+	Response->SetStringField(TEXT("Error"), InErrorMsg);
+	SendResponse(RunningConnection, Response);
+
+	// the pipeline is kept alive by the finishing task
+	RunningPipeline->ProgressDelegate.RemoveAll(this);
+	RunningPipeline->FinishedDelegate.RemoveAll(this);
+	RunningPipeline.Reset();
+	RunningConnection.Reset();
+	if (RunningSettings)
+	{
+		RunningSettings->RemoveFromRoot();
+		RunningSettings = nullptr;
+	}
+}
+
+void FHotPatcherBuildServer::SendResponse(const TSharedPtr<FConnection>& InConnection, const TSharedRef<FJsonObject>& InResponse)
+{
+	if (!InConnection.IsValid() || InConnection->bClosed)
+		return;
+	if (!SendLine(InConnection->Socket, SerializeLine(InResponse)))
+	{
+		InConnection->bClosed = true;
+	}
+}
+
+void FHotPatcherBuildServer::CloseConnection(const TSharedPtr<FConnection>& InConnection)
+{
+	if (!InConnection->Socket)
+		return;
+	UE_LOG(LogTemp, Log, TEXT("HotPatcher build server close %s."), *InConnection->Endpoint.ToString());
+	InConnection->bClosed = true;
+	InConnection->Socket->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(InConnection->Socket);
+	InConnection->Socket = nullptr;
+}
+
+void FHotPatcherBuildServer::MarkSnapshotDirty()
+{
+	bSnapshotDirty = true;
+}
+
+void FHotPatcherBuildServer::OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath)
+{
+	MarkSnapshotDirty();
+}
+
+FString FHotPatcherBuildServer::SerializeLine(const TSharedRef<FJsonObject>& InJsonObject)
+{
+	FString Line;
+	auto JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+	FJsonSerializer::Serialize(InJsonObject, JsonWriter);
+	return Line;
+}
+
+bool FHotPatcherBuildServer::SendLine(FSocket* InSocket, const FString& InLine)
+{
+	if (!InSocket)
+		return false;
+	FTCHARToUTF8 Converter(*(InLine + TEXT("\n")));
+	const uint8* Data = (const uint8*)Converter.Get();
+	int32 RemainingSize = Converter.Length();
+	while (RemainingSize > 0)
+	{
+		int32 BytesSent = 0;
+		if (!InSocket->Send(Data, RemainingSize, BytesSent))
+		{
+			if (ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() != SE_EWOULDBLOCK)
+				return false;
+			FPlatformProcess::Sleep(0.001f);
+			continue;
+		}
+		Data += BytesSent;
+		RemainingSize -= BytesSent;
+	}
+	return true;
+}
+
+void FHotPatcherBuildServer::PopLines(TArray<uint8>& InOutReceivedData, int32& InOutScannedSize, TArray<FString>& OutLines)
+{
+	// the popped lines are removed once,the incomplete line isn't scanned again by the next read
+	int32 LineBegin = 0;
+	for (int32 Index = FMath::Clamp(InOutScannedSize, 0, InOutReceivedData.Num()); Index < InOutReceivedData.Num(); ++Index)
+	{
+		if (InOutReceivedData[Index] != (uint8)'\n')
+			continue;
+		FUTF8ToTCHAR Converter((const ANSICHAR*)InOutReceivedData.GetData() + LineBegin, Index - LineBegin);
+		OutLines.Add(FString(Converter.Length(), Converter.Get()).TrimStartAndEnd());
+		LineBegin = Index + 1;
+	}
+	if (LineBegin > 0)
+	{
+		InOutReceivedData.RemoveAt(0, LineBegin, false);
+	}
+	InOutScannedSize = InOutReceivedData.Num();
+}
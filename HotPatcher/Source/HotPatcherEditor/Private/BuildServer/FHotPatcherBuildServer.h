@@ -0,0 +1,100 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+#include "CreatePatch/FHotPatcherAssetSnapshot.h"
+#include "ThreadUtils/FHotPatcherPipeline.hpp"
+
+// engine header
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Dom/JsonObject.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+
+class FSocket;
+class FTcpListener;
+
+/**
+ * Keep the asset registry and the asset snapshot warm in a long-lived process,export the patch or release requested by local tcp connection.
+ * The request and the response are json in a line,utf-8 encoding:
+ * request:  {"Command":"ExportPatch","Config":{...*_PatchConfig.json...},"Refresh":false}
+ *           Command is ExportPatch,ExportRelease,Ping or Stop,Refresh to rescan the assets changed on disk
+ * response: {"Progress":0.5,"Message":"..."}
+ *           {"Finished":true,"Successed":true,"Error":""}
+ * The jobs are run one by one in the order of received.
+ */
+class FHotPatcherBuildServer
+{
+public:
+	FHotPatcherBuildServer();
+	~FHotPatcherBuildServer();
+
+	// listen on the loopback address only
+	bool Start(int32 InPort);
+	void Stop();
+	// receive requests and run the jobs,must be called in the game thread
+	void Tick();
+
+	FORCEINLINE bool IsRunning()const { return Listener.IsValid(); }
+	// a Stop request is received
+	FORCEINLINE bool IsStopRequested()const { return bStopRequested; }
+
+	static int32 GetDefaultPort() { return 8910; }
+	// the json in a line,the line break is appended by SendLine
+	static FString SerializeLine(const TSharedRef<FJsonObject>& InJsonObject);
+	// block until all bytes are sent,the socket may be non-blocking
+	static bool SendLine(FSocket* InSocket, const FString& InLine);
+	// pop the received lines from the buffer,the last incomplete line is kept
+	// the bytes before InOutScannedSize have no line break,the search continues from it
+	static void PopLines(TArray<uint8>& InOutReceivedData, int32& InOutScannedSize, TArray<FString>& OutLines);
+	// the max bytes of a request line,the config is inlined in the request
+	static const int32 MaxRequestLineSize = 16 * 1024 * 1024;
+
+protected:
+	struct FConnection
+	{
+		FSocket* Socket = nullptr;
+		FIPv4Endpoint Endpoint;
+		TArray<uint8> ReceivedData;
+		int32 ScannedSize = 0;
+		bool bClosed = false;
+	};
+	struct FBuildJob
+	{
+		TSharedPtr<FConnection> Connection;
+		FString Command;
+		TSharedPtr<FJsonObject> Config;
+		bool bRefresh = false;
+	};
+
+	// called in the listener thread
+	bool OnConnectionAccepted(FSocket* InSocket, const FIPv4Endpoint& InEndpoint);
+	void ReceiveRequests(const TSharedPtr<FConnection>& InConnection);
+	void HandleRequest(const TSharedPtr<FConnection>& InConnection, const FString& InLine);
+	void StartNextJob();
+	void OnPipelineProgress(const FText& InMsg, float InPercent);
+	void OnPipelineFinished(bool bInSuccessed, const FString& InErrorMsg);
+	void SendResponse(const TSharedPtr<FConnection>& InConnection, const TSharedRef<FJsonObject>& InResponse);
+	void CloseConnection(const TSharedPtr<FConnection>& InConnection);
+
+	void MarkSnapshotDirty();
+	void OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath);
+
+private:
+	TSharedPtr<FTcpListener> Listener;
+	TQueue<TSharedPtr<FConnection>, EQueueMode::Mpsc> AcceptedConnections;
+	TArray<TSharedPtr<FConnection>> Connections;
+
+	TArray<FBuildJob> PendingJobs;
+	TSharedPtr<FConnection> RunningConnection;
+	TSharedPtr<FHotPatcherPipeline, ESPMode::ThreadSafe> RunningPipeline;
+	// the settings of the running job,rooted until the job finished
+	UObject* RunningSettings;
+
+	TSharedPtr<FHotPatcherAssetSnapshot, ESPMode::ThreadSafe> AssetSnapshot;
+	bool bSnapshotDirty;
+	bool bStopRequested;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle PackageSavedHandle;
+};
@@ -0,0 +1,274 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "HotPatcherBenchmarkCommandlet.h"
+#include "Benchmark/FHotPatcherSyntheticAssets.h"
+#include "CreatePatch/FHotPatcherAssetSnapshot.h"
+#include "FlibHotPatcherEditorHelper.h"
+#include "FlibPatchParserHelper.h"
+#include "FLibAssetManageHelperEx.h"
+#include "FInMemoryAssetRegistryQuery.h"
+
+// engine header
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/EngineVersion.h"
+#include "HAL/PlatformTime.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	struct FBenchmarkResult
+	{
+		FString Name;
+		int32 Iterations = 0;
+		double MinMs = 0.0;
+		double MeanMs = 0.0;
+		double MaxMs = 0.0;
+		// the num of assets,packages or bytes processed by one iteration
+		int64 ItemNum = 0;
+	};
+
+	// the first run warms up the allocator and is not recorded
+	FBenchmarkResult RunBenchmark(const FString& InName, int32 InIterations, TFunctionRef<int64()> InFunc)
+	{
+		FBenchmarkResult Result;
+		Result.Name = InName;
+		Result.Iterations = FMath::Max(InIterations, 1);
+		Result.MinMs = MAX_dbl;
+		InFunc();
+
+		double TotalMs = 0.0;
+		for (int32 Iteration = 0; Iteration < Result.Iterations; ++Iteration)
+		{
+			double BeginTime = FPlatformTime::Seconds();
+			Result.ItemNum = InFunc();
+			double UsedMs = (FPlatformTime::Seconds() - BeginTime) * 1000.0;
+			TotalMs += UsedMs;
+			Result.MinMs = FMath::Min(Result.MinMs, UsedMs);
+			Result.MaxMs = FMath::Max(Result.MaxMs, UsedMs);
+		}
+		Result.MeanMs = TotalMs / Result.Iterations;
+		UE_LOG(LogTemp, Display, TEXT("%-28s min %10.3fms mean %10.3fms max %10.3fms items %lld"), *Result.Name, Result.MinMs, Result.MeanMs, Result.MaxMs, Result.ItemNum);
+		return Result;
+	}
+
+	// compare the mean time with the baseline,return the num of regressions
+	int32 CompareWithBaseline(const TArray<FBenchmarkResult>& InResults, const FString& InBaselineFile, float InThreshold)
+	{
+		FString BaselineContent;
+		TSharedPtr<FJsonObject> BaselineJsonObject;
+		if (!UFLibAssetManageHelperEx::LoadFileToString(InBaselineFile, BaselineContent) ||
+			!FJsonSerializer::Deserialize(TJsonReaderFactory<TCHAR>::Create(BaselineContent), BaselineJsonObject) || !BaselineJsonObject.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Load benchmark baseline %s faild."), *InBaselineFile);
+			return 1;
+		}
+
+		TMap<FString, double> BaselineMeanMs;
+		for (const auto& BenchmarkJsonValue : BaselineJsonObject->GetArrayField(TEXT("benchmarks")))
+		{
+			const TSharedPtr<FJsonObject>& BenchmarkJsonObject = BenchmarkJsonValue->AsObject();
+			if (BenchmarkJsonObject.IsValid())
+			{
+				BaselineMeanMs.Add(BenchmarkJsonObject->GetStringField(TEXT("name")), BenchmarkJsonObject->GetNumberField(TEXT("mean_ms")));
+			}
+		}
+
+		int32 RegressionNum = 0;
+		for (const auto& Result : InResults)
+		{
+			const double* MeanMs = BaselineMeanMs.Find(Result.Name);
+			if (!MeanMs)
+				continue;
+			if (Result.MeanMs > *MeanMs * (1.0 + InThreshold))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s is regressed,mean %.3fms,baseline %.3fms."), *Result.Name, Result.MeanMs, *MeanMs);
+				++RegressionNum;
+			}
+		}
+		return RegressionNum;
+	}
+}
+
+UHotPatcherBenchmarkCommandlet::UHotPatcherBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	HelpDescription = TEXT("Benchmark the analysis,diff and serialization of HotPatcher on a synthetic asset graph.");
+	HelpUsage = TEXT("-run=HotPatcherBenchmark [-nodes=2000] [-fanout=4] [-modules=4] [-cycles=0.05] [-churn=0.05] [-seed=0] [-iterations=5] [-output=<file>] [-baseline=<file> -threshold=0.2]");
+	HelpParamNames.Add(TEXT("nodes"));
+	HelpParamDescriptions.Add(TEXT("the num of packages in the synthetic asset graph"));
+	HelpParamNames.Add(TEXT("fanout"));
+	HelpParamDescriptions.Add(TEXT("the dependencies of every package"));
+	HelpParamNames.Add(TEXT("modules"));
+	HelpParamDescriptions.Add(TEXT("the num of modules,the first is /Game"));
+	HelpParamNames.Add(TEXT("cycles"));
+	HelpParamDescriptions.Add(TEXT("the ratio of packages depend on an earlier package"));
+	HelpParamNames.Add(TEXT("churn"));
+	HelpParamDescriptions.Add(TEXT("the ratio of modified packages between the versions,the added and deleted are a fifth of it"));
+	HelpParamNames.Add(TEXT("baseline"));
+	HelpParamDescriptions.Add(TEXT("fail if the mean time is slower than the baseline results by the threshold"));
+}
+
+int32 UHotPatcherBenchmarkCommandlet::Main(const FString& Params)
+{
+	FSyntheticAssetGraphOptions GraphOptions;
+	FParse::Value(*Params, TEXT("nodes="), GraphOptions.NodeNum);
+	FParse::Value(*Params, TEXT("fanout="), GraphOptions.FanOut);
+	FParse::Value(*Params, TEXT("modules="), GraphOptions.ModuleNum);
+	FParse::Value(*Params, TEXT("cycles="), GraphOptions.CycleRatio);
+	FParse::Value(*Params, TEXT("seed="), GraphOptions.Seed);
+
+	FSyntheticVersionOptions VersionOptions;
+	float Churn = VersionOptions.ModifyRatio;
+	FParse::Value(*Params, TEXT("churn="), Churn);
+	VersionOptions.ModifyRatio = Churn;
+	VersionOptions.AddRatio = Churn / 5.f;
+	VersionOptions.DeleteRatio = Churn / 5.f;
+	VersionOptions.Seed = GraphOptions.Seed + 1;
+
+	int32 Iterations = 5;
+	FParse::Value(*Params, TEXT("iterations="), Iterations);
+	FString OutputFile = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HotPatcher/Benchmark.json"));
+	FParse::Value(*Params, TEXT("output="), OutputFile);
+
+	// generate the inputs
+	double GenerateBeginTime = FPlatformTime::Seconds();
+	FHotPatcherAssetSnapshot Snapshot;
+	FHotPatcherSyntheticAssets::GenerateSnapshot(GraphOptions, Snapshot);
+	FHotPatcherVersion BaseVersion;
+	FHotPatcherVersion CurrentVersion;
+	FHotPatcherSyntheticAssets::GenerateVersionPair(GraphOptions, VersionOptions, BaseVersion, CurrentVersion);
+	const TArray<FString> ModuleRootPaths = FHotPatcherSyntheticAssets::GetModuleRootPaths(GraphOptions.ModuleNum);
+	UE_LOG(LogTemp, Display, TEXT("Generate %d packages,%d modules,take %.2fs."), Snapshot.GetPackageNum(), ModuleRootPaths.Num(), FPlatformTime::Seconds() - GenerateBeginTime);
+
+	// the assets of base version are split to two halves
+	FAssetDependenciesInfo FirstHalfAssets;
+	FAssetDependenciesInfo SecondHalfAssets;
+	for (const auto& ModuleDependencies : BaseVersion.AssetInfo.mDependencies)
+	{
+		int32 AssetIndex = 0;
+		for (const auto& AssetDetail : ModuleDependencies.Value.mDependAssetDetails)
+		{
+			FAssetDependenciesInfo& HalfAssets = (AssetIndex++ % 2) ? SecondHalfAssets : FirstHalfAssets;
+			FAssetDependenciesDetail& ModuleCategory = HalfAssets.mDependencies.FindOrAdd(ModuleDependencies.Key);
+			ModuleCategory.mModuleCategory = ModuleDependencies.Key;
+			ModuleCategory.mDependAssetDetails.Add(AssetDetail.Key, AssetDetail.Value);
+		}
+	}
+
+	// the analysis of normal export queries the synthetic graph instead of the asset registry
+	TSharedPtr<FInMemoryAssetRegistryQuery, ESPMode::ThreadSafe> AssetRegistry = MakeShared<FInMemoryAssetRegistryQuery, ESPMode::ThreadSafe>();
+	FHotPatcherSyntheticAssets::GenerateAssetRegistry(GraphOptions, *AssetRegistry);
+	FScopedAssetRegistryQuery ScopedAssetRegistryQuery(AssetRegistry);
+	TArray<FAssetDetail> RegistryAssets;
+	UFLibAssetManageHelperEx::GetAssetsList(ModuleRootPaths, RegistryAssets);
+
+	FString SerializedVersion;
+	UFlibPatchParserHelper::SerializeHotPatcherVersionToString(CurrentVersion, SerializedVersion);
+
+	TArray<FBenchmarkResult> Results;
+	Results.Add(RunBenchmark(TEXT("FilterEvaluation"), Iterations, [&]()->int64
+	{
+		TArray<FAssetDetail> FilterAssets;
+		UFLibAssetManageHelperEx::GetAssetsList(ModuleRootPaths, FilterAssets);
+		TArray<FAssetDetail> HasRefAssets;
+		TArray<FAssetDetail> DontHasRefAssets;
+		UFLibAssetManageHelperEx::FilterNoRefAssetsWithIgnoreFilter(FilterAssets, TArray<FString>{}, HasRefAssets, DontHasRefAssets);
+		return HasRefAssets.Num() + DontHasRefAssets.Num();
+	}));
+	Results.Add(RunBenchmark(TEXT("DependencyClosure"), Iterations, [&]()->int64
+	{
+		FAssetDependenciesInfo AssetDependencies;
+		UFLibAssetManageHelperEx::GetAssetListDependenciesForAssetDetail(RegistryAssets, AssetDependencies);
+		return FHotPatcherSyntheticAssets::GetAssetNum(AssetDependencies);
+	}));
+	Results.Add(RunBenchmark(TEXT("ExportReleaseVersionInfo"), Iterations, [&]()->int64
+	{
+		FHotPatcherVersion Version = UFlibHotPatcherEditorHelper::ExportReleaseVersionInfo(TEXT("Benchmark"), TEXT(""), TEXT(""), ModuleRootPaths, TArray<FString>{}, TArray<FPatcherSpecifyAsset>{}, TArray<FExternAssetFileInfo>{}, false);
+		return FHotPatcherSyntheticAssets::GetAssetNum(Version.AssetInfo);
+	}));
+	Results.Add(RunBenchmark(TEXT("CombineAssetDependencies"), Iterations, [&]()->int64
+	{
+		return FHotPatcherSyntheticAssets::GetAssetNum(UFLibAssetManageHelperEx::CombineAssetDependencies(FirstHalfAssets, SecondHalfAssets));
+	}));
+	Results.Add(RunBenchmark(TEXT("DiffVersionAssets"), Iterations, [&]()->int64
+	{
+		FAssetDependenciesInfo AddAssets;
+		FAssetDependenciesInfo ModifyAssets;
+		FAssetDependenciesInfo DeleteAssets;
+		UFlibPatchParserHelper::DiffVersionAssets(CurrentVersion.AssetInfo, BaseVersion.AssetInfo, AddAssets, ModifyAssets, DeleteAssets);
+		return FHotPatcherSyntheticAssets::GetAssetNum(AddAssets) + FHotPatcherSyntheticAssets::GetAssetNum(ModifyAssets) + FHotPatcherSyntheticAssets::GetAssetNum(DeleteAssets);
+	}));
+	Results.Add(RunBenchmark(TEXT("SerializeVersion"), Iterations, [&]()->int64
+	{
+		FString Content;
+		UFlibPatchParserHelper::SerializeHotPatcherVersionToString(CurrentVersion, Content);
+		return Content.Len();
+	}));
+	Results.Add(RunBenchmark(TEXT("DeserializeVersion"), Iterations, [&]()->int64
+	{
+		FHotPatcherVersion Version;
+		UFlibPatchParserHelper::DeserializeHotPatcherVersionFromString(SerializedVersion, Version);
+		return FHotPatcherSyntheticAssets::GetAssetNum(Version.AssetInfo);
+	}));
+	// the batch export analyses on the captured snapshot instead of the asset registry
+	Results.Add(RunBenchmark(TEXT("SnapshotExportReleaseVersionInfo"), Iterations, [&]()->int64
+	{
+		FHotPatcherVersion Version = Snapshot.ExportReleaseVersionInfo(TEXT("Benchmark"), TEXT(""), TEXT(""), ModuleRootPaths, TArray<FString>{}, TArray<FPatcherSpecifyAsset>{}, TArray<FExternAssetFileInfo>{}, false);
+		return FHotPatcherSyntheticAssets::GetAssetNum(Version.AssetInfo);
+	}));
+
+	// save the results
+	FString ResultContent;
+	auto JsonWriter = TJsonWriterFactory<>::Create(&ResultContent);
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("engine"), FEngineVersion::Current().ToString());
+	JsonWriter->WriteValue(TEXT("date"), FDateTime::UtcNow().ToString());
+	JsonWriter->WriteObjectStart(TEXT("options"));
+	JsonWriter->WriteValue(TEXT("nodes"), GraphOptions.NodeNum);
+	JsonWriter->WriteValue(TEXT("fanout"), GraphOptions.FanOut);
+	JsonWriter->WriteValue(TEXT("modules"), GraphOptions.ModuleNum);
+	JsonWriter->WriteValue(TEXT("cycles"), GraphOptions.CycleRatio);
+	JsonWriter->WriteValue(TEXT("churn"), Churn);
+	JsonWriter->WriteValue(TEXT("seed"), GraphOptions.Seed);
+	JsonWriter->WriteValue(TEXT("iterations"), Iterations);
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->WriteArrayStart(TEXT("benchmarks"));
+	for (const auto& Result : Results)
+	{
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("name"), Result.Name);
+		JsonWriter->WriteValue(TEXT("iterations"), Result.Iterations);
+		JsonWriter->WriteValue(TEXT("min_ms"), Result.MinMs);
+		JsonWriter->WriteValue(TEXT("mean_ms"), Result.MeanMs);
+		JsonWriter->WriteValue(TEXT("max_ms"), Result.MaxMs);
+		JsonWriter->WriteValue(TEXT("items"), Result.ItemNum);
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+	if (!UFLibAssetManageHelperEx::SaveStringToFile(OutputFile, ResultContent))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Save benchmark results to %s faild."), *OutputFile);
+		return -1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("Save benchmark results to %s."), *OutputFile);
+
+	FString BaselineFile;
+	if (FParse::Value(*Params, TEXT("baseline="), BaselineFile))
+	{
+		float Threshold = 0.2f;
+		FParse::Value(*Params, TEXT("threshold="), Threshold);
+		if (CompareWithBaseline(Results, FPaths::ConvertRelativePathToFull(BaselineFile), Threshold))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
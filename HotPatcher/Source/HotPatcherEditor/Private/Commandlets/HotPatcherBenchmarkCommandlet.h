@@ -0,0 +1,25 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HotPatcherBenchmarkCommandlet.generated.h"
+
+/**
+ * Measure the analysis,diff and serialization on a synthetic asset graph,a real project is not needed.
+ * the analysis runs the functions of normal export on the graph through IAssetRegistryQuery,the Snapshot* benchmarks are the batch export.
+ * UE4Editor-Cmd.exe PROJECT.uproject -run=HotPatcherBenchmark -nodes=5000 -fanout=4 -modules=8 -cycles=0.05 -iterations=5
+ * the results are saved as json,compare them with a baseline in CI,the exit code is 1 if a benchmark is slower than the threshold:
+ * UE4Editor-Cmd.exe PROJECT.uproject -run=HotPatcherBenchmark -output=D:/Benchmark.json -baseline=D:/BaselineBenchmark.json -threshold=0.2
+ */
+UCLASS()
+class UHotPatcherBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UHotPatcherBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,237 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "HotPatcherCommandlet.h"
+#include "CreatePatch/FExportPatchPipeline.h"
+#include "CreatePatch/FExportReleasePipeline.h"
+#include "CreatePatch/FExportPatchBatch.h"
+#include "BuildServer/FHotPatcherBuildServer.h"
+#include "BuildServer/FHotPatcherBuildClient.h"
+#include "FlibHotPatcherEditorHelper.h"
+#include "FLibAssetManageHelperEx.h"
+
+// engine header
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "AssetRegistryModule.h"
+#include "Serialization/JsonSerializer.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformProcess.h"
+
+namespace
+{
+	bool RunPipeline(TSharedPtr<FHotPatcherPipeline, ESPMode::ThreadSafe> InPipeline, const FString& InName)
+	{
+		InPipeline->ProgressDelegate.AddLambda([InName](const FText& InMsg, float InPercent)
+		{
+			UE_LOG(LogTemp, Display, TEXT("[%s] %3d%% %s"), *InName, FMath::RoundToInt(InPercent * 100.f), *InMsg.ToString());
+		});
+		InPipeline->FinishedDelegate.AddLambda([InName](bool bInSuccessed, const FString& InErrorMsg)
+		{
+			if (!bInSuccessed)
+			{
+				UE_LOG(LogTemp, Error, TEXT("[%s] FAILD:\n%s"), *InName, *InErrorMsg);
+			}
+		});
+		bool bSuccessed = InPipeline->RunSynchronously();
+		UE_LOG(LogTemp, Display, TEXT("%s is %s."), *InName, bSuccessed ? TEXT("Success") : TEXT("FAILD"));
+		return bSuccessed;
+	}
+
+	// the settings object is kept rooted while exporting,it's collected by gc after the pointer released
+	template<typename T>
+	TSharedPtr<T> NewRootedSettings()
+	{
+		T* Settings = NewObject<T>();
+		Settings->AddToRoot();
+		return MakeShareable(Settings, [](T* InSettings) { InSettings->RemoveFromRoot(); });
+	}
+}
+
+UHotPatcherCommandlet::UHotPatcherCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	HelpDescription = TEXT("Export the patch or release by the config exported from HotPatcher.");
+	HelpUsage = TEXT("-run=HotPatcher -patchconfig=<*_PatchConfig.json>[+<*_PatchConfig.json>...] -releaseconfig=<*_ReleaseConfig.json>");
+	HelpParamNames.Add(TEXT("patchconfig"));
+	HelpParamDescriptions.Add(TEXT("export the patch by the patch config,the configs separated by + are exported as a batch"));
+	HelpParamNames.Add(TEXT("releaseconfig"));
+	HelpParamDescriptions.Add(TEXT("export the release by the release config"));
+	HelpParamNames.Add(TEXT("startbuildserver"));
+	HelpParamDescriptions.Add(TEXT("keep running and export by the requests on -buildport,default is 8910"));
+	HelpParamNames.Add(TEXT("connect"));
+	HelpParamDescriptions.Add(TEXT("send the configs to the build server,-refresh to rescan the changed assets,-stop to stop the server"));
+}
+
+int32 UHotPatcherCommandlet::Main(const FString& Params)
+{
+	FString ServerAddress;
+	if (FParse::Value(*Params, TEXT("connect="), ServerAddress))
+	{
+		return RunBuildClient(ServerAddress, Params);
+	}
+	if (FParse::Param(*Params, TEXT("startbuildserver")))
+	{
+		return RunBuildServer(Params);
+	}
+
+	FString PatchConfigFile;
+	FString ReleaseConfigFile;
+	FParse::Value(*Params, TEXT("patchconfig="), PatchConfigFile);
+	FParse::Value(*Params, TEXT("releaseconfig="), ReleaseConfigFile);
+	if (PatchConfigFile.IsEmpty() && ReleaseConfigFile.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Usage: %s"), *HelpUsage);
+		return -1;
+	}
+
+	// the asset registry is scanned asynchronously in the editor,the commandlet need all assets before analysis
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	AssetRegistryModule.Get().SearchAllAssets(true);
+
+	int32 Result = 0;
+	// the release is exported first,the patch may be based on it
+	if (!ReleaseConfigFile.IsEmpty())
+	{
+		FString JsonContent;
+		if (!UFLibAssetManageHelperEx::LoadFileToString(FPaths::ConvertRelativePathToFull(ReleaseConfigFile), JsonContent))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Load release config %s faild."), *ReleaseConfigFile);
+			return -1;
+		}
+		TSharedPtr<UExportReleaseSettings> ReleaseSetting = NewRootedSettings<UExportReleaseSettings>();
+		UFlibHotPatcherEditorHelper::DeserializeReleaseConfig(ReleaseSetting, JsonContent);
+		if (!RunPipeline(MakeShareable(new FExportReleasePipeline(ReleaseSetting.Get())), TEXT("Export Release")))
+		{
+			Result = -1;
+		}
+	}
+
+	if (!PatchConfigFile.IsEmpty() && !Result)
+	{
+		TArray<FString> PatchConfigFiles;
+		PatchConfigFile.ParseIntoArray(PatchConfigFiles, TEXT("+"), true);
+
+		TArray<TSharedPtr<UExportPatchSettings>> PatchSettings;
+		for (const auto& ConfigFile : PatchConfigFiles)
+		{
+			FString JsonContent;
+			if (!UFLibAssetManageHelperEx::LoadFileToString(FPaths::ConvertRelativePathToFull(ConfigFile), JsonContent))
+			{
+				UE_LOG(LogTemp, Error, TEXT("Load patch config %s faild."), *ConfigFile);
+				return -1;
+			}
+			TSharedPtr<UExportPatchSettings> PatchSetting = NewRootedSettings<UExportPatchSettings>();
+			UFlibHotPatcherEditorHelper::DeserializePatchConfig(PatchSetting, JsonContent);
+			PatchSettings.Add(PatchSetting);
+		}
+
+		if (PatchSettings.Num() == 1)
+		{
+			if (!RunPipeline(MakeShareable(new FExportPatchPipeline(PatchSettings[0].Get())), TEXT("Export Patch")))
+			{
+				Result = -1;
+			}
+		}
+		else
+		{
+			FExportPatchBatch PatchBatch;
+			for (const auto& PatchSetting : PatchSettings)
+			{
+				PatchBatch.AddPatchSetting(PatchSetting.Get());
+			}
+			if (PatchBatch.RunSynchronously())
+			{
+				Result = -1;
+			}
+		}
+	}
+	return Result;
+}
+
+int32 UHotPatcherCommandlet::RunBuildServer(const FString& Params)
+{
+	int32 Port = FHotPatcherBuildServer::GetDefaultPort();
+	FParse::Value(*Params, TEXT("buildport="), Port);
+
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	AssetRegistryModule.Get().SearchAllAssets(true);
+
+	FHotPatcherBuildServer BuildServer;
+	if (!BuildServer.Start(Port))
+	{
+		return -1;
+	}
+	// there is no engine loop in the commandlet,tick the server and the game thread tasks of pipeline here
+	while (!BuildServer.IsStopRequested() && !GIsRequestingExit)
+	{
+		BuildServer.Tick();
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FPlatformProcess::Sleep(0.01f);
+	}
+	BuildServer.Stop();
+	return 0;
+}
+
+int32 UHotPatcherCommandlet::RunBuildClient(const FString& InServerAddress, const FString& Params)
+{
+	TArray<TSharedRef<FJsonObject>> Requests;
+	auto AddConfigRequest = [&Requests, &Params](const FString& InCommand, const FString& InConfigFile)->bool
+	{
+		FString JsonContent;
+		TSharedPtr<FJsonObject> Config;
+		if (!UFLibAssetManageHelperEx::LoadFileToString(FPaths::ConvertRelativePathToFull(InConfigFile), JsonContent) ||
+			!FJsonSerializer::Deserialize(TJsonReaderFactory<TCHAR>::Create(JsonContent), Config) || !Config.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Load config %s faild."), *InConfigFile);
+			return false;
+		}
+		TSharedRef<FJsonObject> Request = MakeShareable(new FJsonObject);
+		Request->SetStringField(TEXT("Command"), InCommand);
+		Request->SetObjectField(TEXT("Config"), Config);
+		Request->SetBoolField(TEXT("Refresh"), FParse::Param(*Params, TEXT("refresh")));
+		Requests.Add(Request);
+		return true;
+	};
+
+	FString ReleaseConfigFile;
+	if (FParse::Value(*Params, TEXT("releaseconfig="), ReleaseConfigFile) && !AddConfigRequest(TEXT("ExportRelease"), ReleaseConfigFile))
+	{
+		return -1;
+	}
+	FString PatchConfigFile;
+	if (FParse::Value(*Params, TEXT("patchconfig="), PatchConfigFile))
+	{
+		TArray<FString> PatchConfigFiles;
+		PatchConfigFile.ParseIntoArray(PatchConfigFiles, TEXT("+"), true);
+		for (const auto& ConfigFile : PatchConfigFiles)
+		{
+			if (!AddConfigRequest(TEXT("ExportPatch"), ConfigFile))
+			{
+				return -1;
+			}
+		}
+	}
+	if (FParse::Param(*Params, TEXT("stop")))
+	{
+		TSharedRef<FJsonObject> Request = MakeShareable(new FJsonObject);
+		Request->SetStringField(TEXT("Command"), TEXT("Stop"));
+		Requests.Add(Request);
+	}
+
+	for (const auto& Request : Requests)
+	{
+		FString ErrorMsg;
+		if (!FHotPatcherBuildClient::SendRequest(InServerAddress, Request, ErrorMsg))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s FAILD:\n%s"), *Request->GetStringField(TEXT("Command")), *ErrorMsg);
+			return -1;
+		}
+		UE_LOG(LogTemp, Display, TEXT("%s is Success."), *Request->GetStringField(TEXT("Command")));
+	}
+	return 0;
+}
@@ -0,0 +1,32 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HotPatcherCommandlet.generated.h"
+
+/**
+ * Export the patch or release by the exported config,without the editor ui.
+ * UE4Editor-Cmd.exe PROJECT.uproject -run=HotPatcher -patchconfig=D:/1.0.1_PatchConfig.json
+ * UE4Editor-Cmd.exe PROJECT.uproject -run=HotPatcher -releaseconfig=D:/1.0.0_ReleaseConfig.json
+ * the patch configs separated by + are exported as a batch on the same asset registry snapshot:
+ * UE4Editor-Cmd.exe PROJECT.uproject -run=HotPatcher -patchconfig=D:/1.0.1_PatchConfig.json+D:/1.0.1_DLC_PatchConfig.json
+ * keep the editor warm and export by the requests of local client:
+ * UE4Editor-Cmd.exe PROJECT.uproject -run=HotPatcher -startbuildserver -buildport=8910
+ * UE4Editor-Cmd.exe PROJECT.uproject -run=HotPatcher -connect=127.0.0.1:8910 -patchconfig=D:/1.0.1_PatchConfig.json [-refresh] [-stop]
+ */
+UCLASS()
+class UHotPatcherCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UHotPatcherCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	int32 RunBuildServer(const FString& Params);
+	int32 RunBuildClient(const FString& InServerAddress, const FString& Params);
+};
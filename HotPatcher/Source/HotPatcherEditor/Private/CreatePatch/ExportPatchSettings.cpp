@@ -1,5 +1,8 @@
 #include "ExportPatchSettings.h"
 #include "FLibAssetManageHelperEx.h"
+#include "FHotPatcherPakWriter.h"
+#include "FHotPatcherPakListWriter.h"
+#include "FHotPatcherProfiler.h"
 
 // engine header
 #include "Dom/JsonValue.h"
@@ -52,6 +55,23 @@ FString UExportPatchSettings::GetSaveAbsPath()const
 	return TEXT("");
 }
 
+FString UExportPatchSettings::GetPakBlockCacheDir()const
+{
+	if (!IsUsePakBlockCache())
+		return TEXT("");
+	if (!PakBlockCacheDir.Path.IsEmpty())
+		return FPaths::ConvertRelativePathToFull(PakBlockCacheDir.Path);
+	return FHotPatcherPakWriter::GetDefaultBlockCacheDir();
+}
+
+FString UExportPatchSettings::GetDeltaBasePaksDir(const FString& InBaseVersionId)const
+{
+	if (!DeltaBasePaksDir.Path.IsEmpty())
+	{
+		return FPaths::ConvertRelativePathToFull(DeltaBasePaksDir.Path);
+	}
+	return FPaths::Combine(GetSaveAbsPath(), InBaseVersionId);
+}
 
 FPakVersion UExportPatchSettings::GetPakVersion(const FHotPatcherVersion& InHotPatcherVersion, const FString& InUtcTime)
 {
@@ -139,72 +159,124 @@ TArray<FString> UExportPatchSettings::CombineAllExternDirectoryCookCommand() con
 	return CookCommandResault;
 }
 
-TArray<FString> UExportPatchSettings::CombineAllCookCommandsInTheSetting(const FString& InPlatformName,const FAssetDependenciesInfo& AllChangedAssetInfo,const TArray<FExternAssetFileInfo>& AllChangedExFiles, bool bDiffExFiles) const
+bool UExportPatchSettings::GetPakOrderMap(const FAssetDependenciesInfo& InAllChangedAssetInfo, TMap<FString, int32>& OutOrderMap)const
 {
-	// combine all cook commands
+	FString OrderFile = FPaths::ConvertRelativePathToFull(GetPakOrderFile());
+	if (!GetPakOrderFile().IsEmpty() && FPaths::FileExists(OrderFile))
 	{
-		FString ProjectDir = UKismetSystemLibrary::GetProjectDirectory();
-		
-		// generated cook command form asset list
-		TArray<FString> OutPakCommand;
-		UFLibAssetManageHelperEx::GetCookCommandFromAssetDependencies(ProjectDir, InPlatformName, AllChangedAssetInfo, TArray<FString>{}, OutPakCommand);
+		return UFlibPatchParserHelper::LoadPakOrderFile(OrderFile, OutOrderMap);
+	}
 
-		// generated cook command form project ini/AssetRegistry.bin/GlobalShaderCache*.bin
-		// and all extern file
+	if (IsOrderByMapDependencies())
+	{
+		FString ProjectDir = UKismetSystemLibrary::GetProjectDirectory();
+		TArray<FString> LoadOrderPackages;
+		UFLibAssetManageHelperEx::GetMapsLoadOrder(InAllChangedAssetInfo, LoadOrderPackages);
+		for (const auto& LongPackageName : LoadOrderPackages)
 		{
-			TArray<FString> AllExternCookCommand;
-
-			this->GetAllExternAssetCookCommands(ProjectDir, InPlatformName, AllExternCookCommand);
-
-			if (!!AllExternCookCommand.Num())
+			FString CookedRelativePath;
+			if (UFLibAssetManageHelperEx::ConvLongPackageNameToCookedRelativePath(ProjectDir, LongPackageName, CookedRelativePath))
 			{
-				OutPakCommand.Append(AllExternCookCommand);
+				OutOrderMap.Add(FPaths::Combine(TEXT("../../../"), CookedRelativePath).ToLower(), OutOrderMap.Num());
 			}
+		}
+		return !!OutOrderMap.Num();
+	}
+	return false;
+}
 
-			// external not-asset files
-			{
-				TArray<FExternAssetFileInfo> ExFiles;
-				if (bDiffExFiles)
-				{
-					ExFiles = AllChangedExFiles;
-				}
-				else
-				{
-					ExFiles = GetAllExternFiles();
-				
-				}
-				for (const auto& File : ExFiles)
-				{
-					// UE_LOG(LogTemp, Warning, TEXT("CookCommand %s"), *FString::Printf(TEXT("\"%s\" \"%s\""), *File.FilePath.FilePath, *File.MountPath));
-					OutPakCommand.Add(FString::Printf(TEXT("\"%s\" \"%s\""), *File.FilePath.FilePath, *File.MountPath));
-				}
-			}
+TArray<FString> UExportPatchSettings::CombineAllCookCommandsInTheSetting(const FString& InPlatformName,const FAssetDependenciesInfo& AllChangedAssetInfo,const TArray<FExternAssetFileInfo>& AllChangedExFiles, bool bDiffExFiles) const
+{
+	// combine all cook commands
+	FString ProjectDir = UKismetSystemLibrary::GetProjectDirectory();
 
-		}
+	// generated cook command form asset list
+	TArray<FString> OutPakCommand;
+	UFLibAssetManageHelperEx::GetCookCommandFromAssetDependencies(ProjectDir, InPlatformName, AllChangedAssetInfo, TArray<FString>{}, OutPakCommand);
+
+	OutPakCommand.Append(CombineNotAssetCookCommandsInTheSetting(InPlatformName, AllChangedExFiles, bDiffExFiles));
+	return OutPakCommand;
+}
 
-		// add PakVersion.json to cook commands
+bool UExportPatchSettings::SavePakListInTheSetting(const FString& InPlatformName, const FAssetDependenciesInfo& AllChangedAssetInfo, const TArray<FExternAssetFileInfo>& AllChangedExFiles, bool bDiffExFiles, const FString& InPakListFile, int32& OutCommandNum)const
+{
+	HOTPATCHER_SCOPED_TIMER(FString::Printf(TEXT("SavePakList %s"), *InPlatformName));
+	OutCommandNum = 0;
+	FString ProjectDir = UKismetSystemLibrary::GetProjectDirectory();
+
+	FHotPatcherPakListWriter PakListWriter(InPakListFile);
+	if (!PakListWriter.IsValid())
+		return false;
+
+	// the cooked asset files are written when they are found
+	PakListWriter.SetCookedRootDir(UFLibAssetManageHelperEx::GetCookedRootDir(ProjectDir, InPlatformName));
+	UFLibAssetManageHelperEx::IterateCookedAssetFiles(ProjectDir, InPlatformName, AllChangedAssetInfo,
+		[&PakListWriter](const FString& InCookedRelativeFile)
 		{
-			FHotPatcherVersion CurrentNewPatchVersion = GetNewPatchVersionInfo();
-			FString CurrentVersionSavePath = FPaths::Combine(this->GetSaveAbsPath(), CurrentNewPatchVersion.VersionId);
+			PakListWriter.AddCookedFile(InCookedRelativeFile);
+		}
+	);
 
-			FString SavedPakVersionFilePath = UExportPatchSettings::GetSavePakVersionPath(CurrentVersionSavePath, CurrentNewPatchVersion);
+	for (const auto& PakCommand : CombineNotAssetCookCommandsInTheSetting(InPlatformName, AllChangedExFiles, bDiffExFiles))
+	{
+		PakListWriter.AddLine(PakCommand);
+	}
 
-			if (this->IsIncludePakVersion() && FPaths::FileExists(SavedPakVersionFilePath))
-			{
-				FString FileNameWithExtension = FPaths::GetCleanFilename(SavedPakVersionFilePath);
+	OutCommandNum = PakListWriter.GetLineNum();
+	return PakListWriter.Close();
+}
 
-				FString CommbinedCookCommand = FString::Printf(
-					TEXT("\"%s\" \"%s\""),
-					*SavedPakVersionFilePath,
-					*FPaths::Combine(this->GetPakVersionFileMountPoint(), FileNameWithExtension)
-				);
+TArray<FString> UExportPatchSettings::CombineNotAssetCookCommandsInTheSetting(const FString& InPlatformName, const TArray<FExternAssetFileInfo>& AllChangedExFiles, bool bDiffExFiles)const
+{
+	FString ProjectDir = UKismetSystemLibrary::GetProjectDirectory();
+	TArray<FString> OutPakCommand;
+
+	// generated cook command form project ini/AssetRegistry.bin/GlobalShaderCache*.bin
+	// and all extern file
+	{
+		TArray<FString> AllExternCookCommand;
+
+		this->GetAllExternAssetCookCommands(ProjectDir, InPlatformName, AllExternCookCommand);
+
+		if (!!AllExternCookCommand.Num())
+		{
+			OutPakCommand.Append(AllExternCookCommand);
+		}
 
-				OutPakCommand.Add(CommbinedCookCommand);
+		// external not-asset files
+		{
+			const TArray<FExternAssetFileInfo>& ExFiles = bDiffExFiles ? AllChangedExFiles : GetAllExternFiles();
+			for (const auto& File : ExFiles)
+			{
+				OutPakCommand.Add(FString::Printf(TEXT("\"%s\" \"%s\""), *File.FilePath.FilePath, *File.MountPath));
 			}
 		}
+	}
+
+	// add PakVersion.json to cook commands
+	{
+		// only the version id is used,don't export the whole release version info again
+		FHotPatcherVersion CurrentNewPatchVersion;
+		CurrentNewPatchVersion.VersionId = GetVersionId();
+		FString CurrentVersionSavePath = GetCurrentVersionSavePath();
+
+		FString SavedPakVersionFilePath = UExportPatchSettings::GetSavePakVersionPath(CurrentVersionSavePath, CurrentNewPatchVersion);
 
-		return OutPakCommand;
+		if (this->IsIncludePakVersion() && FPaths::FileExists(SavedPakVersionFilePath))
+		{
+			FString FileNameWithExtension = FPaths::GetCleanFilename(SavedPakVersionFilePath);
+
+			FString CommbinedCookCommand = FString::Printf(
+				TEXT("\"%s\" \"%s\""),
+				*SavedPakVersionFilePath,
+				*FPaths::Combine(this->GetPakVersionFileMountPoint(), FileNameWithExtension)
+			);
+
+			OutPakCommand.Add(CommbinedCookCommand);
+		}
 	}
+
+	return OutPakCommand;
 }
 
 FHotPatcherVersion UExportPatchSettings::GetNewPatchVersionInfo() const
@@ -245,7 +317,7 @@ bool UExportPatchSettings::GetBaseVersionInfo(FHotPatcherVersion& OutBaseVersion
 
 FString UExportPatchSettings::GetCurrentVersionSavePath() const
 {
-	FString CurrentVersionSavePath = FPaths::Combine(this->GetSaveAbsPath(), GetNewPatchVersionInfo().VersionId);
+	FString CurrentVersionSavePath = FPaths::Combine(this->GetSaveAbsPath(), GetVersionId());
 	return CurrentVersionSavePath;
 }
 
@@ -81,12 +81,31 @@ public:
 	FORCEINLINE FString GetBaseVersion()const { return BaseVersion.FilePath; }
 	FORCEINLINE TArray<FString> GetUnrealPakOptions()const { return UnrealPakOptions; }
 	FORCEINLINE TArray<ETargetPlatform> GetPakTargetPlatforms()const { return PakTargetPlatforms; }
+	FORCEINLINE int32 GetMaxPakProcessNum()const { return MaxPakProcessNum; }
+	FORCEINLINE int32 GetPakProcessMemoryMB()const { return PakProcessMemoryMB; }
+	FORCEINLINE bool IsUseInProcessPakWriter()const { return bUseInProcessPakWriter; }
+	FORCEINLINE bool IsSkipUnchangedPaks()const { return bSkipUnchangedPaks; }
+	FORCEINLINE FString GetPakBuildCacheDir()const { return PakBuildCacheDir.Path.IsEmpty() ? TEXT("") : FPaths::ConvertRelativePathToFull(PakBuildCacheDir.Path); }
+	FORCEINLINE bool IsUsePakBlockCache()const { return bUseInProcessPakWriter && bUsePakBlockCache; }
+	FString GetPakBlockCacheDir()const;
+	FORCEINLINE int64 GetMaxPakChunkSize()const { return (int64)MaxPakChunkSizeMB * 1024 * 1024; }
+	FORCEINLINE int32 GetMaxPakChunkSizeMB()const { return MaxPakChunkSizeMB; }
+	FORCEINLINE FString GetPakOrderFile()const { return PakOrderFile.FilePath; }
+	FORCEINLINE bool IsOrderByMapDependencies()const { return bOrderByMapDependencies; }
+	FORCEINLINE bool IsCreateDeltaFromBasePaks()const { return IsByBaseVersion() && bCreateDeltaFromBasePaks; }
+	// default is SAVE_PATH/BASE_VERSION_ID
+	FString GetDeltaBasePaksDir(const FString& InBaseVersionId)const;
+	// order of the files in pak,key is the lower mount path,empty if no order specified
+	bool GetPakOrderMap(const FAssetDependenciesInfo& InAllChangedAssetInfo, TMap<FString, int32>& OutOrderMap)const;
+	FORCEINLINE bool IsSharedPakForIdenticalContent()const { return bSharedPakForIdenticalContent && PakTargetPlatforms.Num() > 1; }
 	TArray<FString> GetPakTargetPlatformNames()const;
 
 	FORCEINLINE bool IsSavePakList()const { return bSavePakList; }
 	FORCEINLINE bool IsSaveDiffAnalysis()const { return IsByBaseVersion() && bSaveDiffAnalysis; }
 //	FORCEINLINE bool IsSavePakVersion()const { return bSavePakVersion; }
 	FORCEINLINE bool IsSavePatchConfig()const { return bSavePatchConfig; }
+	FORCEINLINE bool IsCompressVersionFiles()const { return bCompressVersionFiles; }
+	FORCEINLINE FName GetVersionFilesCompressionFormat()const { return *VersionFilesCompressionFormat; }
 
 	FORCEINLINE bool IsIncludeAssetRegistry()const { return bIncludeAssetRegistry; }
 	FORCEINLINE bool IsIncludeGlobalShaderCache()const { return bIncludeGlobalShaderCache; }
@@ -98,6 +117,8 @@ public:
 	FORCEINLINE bool IsByBaseVersion()const { return bByBaseVersion; }
 	FORCEINLINE bool IsEnableExternFilesDiff()const { return bEnableExternFilesDiff; }
 	FORCEINLINE bool IsIncludeHasRefAssetsOnly()const { return bIncludeHasRefAssetsOnly; }
+	FORCEINLINE bool IsCheckInValidAssets()const { return bCheckInValidAssets; }
+	FORCEINLINE bool IsForceRefreshAssetRegistry()const { return bForceRefreshAssetRegistry; }
 	FORCEINLINE bool IsIncludePakVersion()const { return bIncludePakVersionFile; }
 	FORCEINLINE FString GetPakVersionFileMountPoint()const { return PakVersionFileMountPoint; }
 	FORCEINLINE TArray<FExternAssetFileInfo> GetAddExternFiles()const { return AddExternFileToPak; }
@@ -105,9 +126,20 @@ public:
 	static FPakVersion GetPakVersion(const FHotPatcherVersion& InHotPatcherVersion,const FString& InUtcTime);
 	static FString GetSavePakVersionPath(const FString& InSaveAbsPath,const FHotPatcherVersion& InVersion);
 	static FString GetSavePakCommandsPath(const FString& InSaveAbsPath, const FString& InPlatfornName, const FHotPatcherVersion& InVersion);
+	// the pak name of the identical files in all platforms
+	FORCEINLINE static FString GetSharedPakName() { return TEXT("Shared"); }
 
 	TArray<FString> CombineAllExternDirectoryCookCommand()const;
 	TArray<FString> CombineAllCookCommandsInTheSetting(const FString& InPlatformName, const FAssetDependenciesInfo& AllChangedAssetInfo, const TArray<FExternAssetFileInfo>& AllChangedExFiles,bool bDiffExFiles=true)const;
+	// the pak commands of not asset files,e.g. ini,AssetRegistry.bin,extern files and PakVersion.json
+	TArray<FString> CombineNotAssetCookCommandsInTheSetting(const FString& InPlatformName, const TArray<FExternAssetFileInfo>& AllChangedExFiles, bool bDiffExFiles = true)const;
+	// same as CombineAllCookCommandsInTheSetting,but the commands are streamed to the pak list file
+	bool SavePakListInTheSetting(const FString& InPlatformName, const FAssetDependenciesInfo& AllChangedAssetInfo, const TArray<FExternAssetFileInfo>& AllChangedExFiles, bool bDiffExFiles, const FString& InPakListFile, int32& OutCommandNum)const;
+	// shared pak,pak order,chunk split,skip unchanged paks and the in process pak writer need all commands in memory
+	FORCEINLINE bool IsStreamPakList()const
+	{
+		return !IsSharedPakForIdenticalContent() && GetPakOrderFile().IsEmpty() && !IsOrderByMapDependencies() && GetMaxPakChunkSize() <= 0 && !IsSkipUnchangedPaks() && !IsUseInProcessPakWriter();
+	}
 	FHotPatcherVersion GetNewPatchVersionInfo()const;
 	bool GetBaseVersionInfo(FHotPatcherVersion& OutBaseVersion)const;
 	FString GetCurrentVersionSavePath()const;
@@ -125,6 +157,12 @@ public:
 		TArray<FDirectoryPath> AssetIgnoreFilters;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PatchSettings|Asset Filter")
 		bool bIncludeHasRefAssetsOnly;
+	// check the patch assets is exist on disk before pak
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PatchSettings|Asset Filter")
+		bool bCheckInValidAssets;
+	// rebuild the asset manager database even if no asset changed since the last export,e.g. the files are changed outside the editor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PatchSettings|Asset Filter")
+		bool bForceRefreshAssetRegistry = false;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PatchSettings|Specify Assets")
 		TArray<FPatcherSpecifyAsset> IncludeSpecifyAssets;
 
@@ -155,6 +193,45 @@ public:
 		TArray<FString> UnrealPakOptions;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options")
 		TArray<ETargetPlatform> PakTargetPlatforms;
+	// max UnrealPak process run at the same time,0 is the number of cores
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options", meta = (ClampMin = "0"))
+		int32 MaxPakProcessNum = 0;
+	// the memory expected by one UnrealPak process,a new process is launched only when the available memory is enough
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options", meta = (ClampMin = "0"))
+		int32 PakProcessMemoryMB = 2048;
+	// create pak in the editor process and compress blocks on all cores,fallback to UnrealPak if faild
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options")
+		bool bUseInProcessPakWriter = false;
+	// save the fingerprint of inputs next to the pak,skip the pak if the inputs are not changed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options")
+		bool bSkipUnchangedPaks = false;
+	// the paks are cached by the fingerprint in the directory,shared by branches and CI retries,empty is disabled
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options", meta = (EditCondition = "bSkipUnchangedPaks"))
+		FDirectoryPath PakBuildCacheDir;
+	// reuse the compressed blocks of unchanged files from the last builds,only for the in process pak writer
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options", meta = (EditCondition = "bUseInProcessPakWriter"))
+		bool bUsePakBlockCache = true;
+	// default is Saved/HotPatcher/PakCache
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options", meta = (EditCondition = "bUsePakBlockCache"))
+		FDirectoryPath PakBlockCacheDir;
+	// split the patch of a platform to 001_P,002_P... paks,the files of a package are always in the same pak,0 is no limit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options", meta = (ClampMin = "0"))
+		int32 MaxPakChunkSizeMB = 0;
+	// package the files with same content in all target platforms to a Shared pak,the platform pak only contains the different files
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options")
+		bool bSharedPakForIdenticalContent = false;
+	// the open order log of the game(-fileopenlog),patch pak files are sorted by it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options")
+		FFilePath PakOrderFile;
+	// if no order file,the changed maps and their dependencies are placed first in the order of loading
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options")
+		bool bOrderByMapDependencies = false;
+	// create the binary delta from the paks of base version,the client can rebuild the new pak by the local pak and the delta
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options|Delta", meta = (EditCondition = "bByBaseVersion"))
+		bool bCreateDeltaFromBasePaks = false;
+	// the directory of base version paks,the paks are in PLATFORM_NAME sub directory,default is SAVE_PATH/BASE_VERSION_ID
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pak Options|Delta", meta = (EditCondition = "bCreateDeltaFromBasePaks"))
+		FDirectoryPath DeltaBasePaksDir;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveTo")
 		bool bSavePakList = true;
@@ -164,6 +241,11 @@ public:
 	//	bool bSavePakVersion;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveTo")
 		bool bSavePatchConfig = true;
+	// compress the Release/Diff json,e.g. Zlib/Oodle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveTo")
+		bool bCompressVersionFiles = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveTo", meta = (EditCondition = "bCompressVersionFiles"))
+		FString VersionFilesCompressionFormat = TEXT("Zlib");
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveTo")
 		FDirectoryPath SavePath;
 
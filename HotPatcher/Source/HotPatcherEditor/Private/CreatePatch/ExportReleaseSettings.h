@@ -103,7 +103,11 @@ public:
 	FORCEINLINE FString GetSavePath()const{return SavePath.Path;}
 
 	FORCEINLINE bool IsSaveConfig()const {return bSaveReleaseConfig;}
+	FORCEINLINE bool IsCompressVersionFiles()const { return bCompressVersionFiles; }
+	FORCEINLINE FName GetVersionFilesCompressionFormat()const { return *VersionFilesCompressionFormat; }
 	FORCEINLINE bool IsIncludeHasRefAssetsOnly()const { return bIncludeHasRefAssetsOnly; }
+	FORCEINLINE bool IsMemoryBoundedAnalysis()const { return bMemoryBoundedAnalysis; }
+	FORCEINLINE int64 GetAnalysisMemoryBudget()const { return (int64)AnalysisMemoryBudgetMB * 1024 * 1024; }
 
 	FORCEINLINE TArray<FPatcherSpecifyAsset> GetSpecifyAssets()const { return IncludeSpecifyAssets; }
 
@@ -123,12 +127,23 @@ public:
 		bool bIncludeHasRefAssetsOnly;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReleaseSetting|Specify Assets")
 		TArray<FPatcherSpecifyAsset> IncludeSpecifyAssets;
+	// analyse the directories in batches and spill the assets and visited packages to disk,the peak memory is limited by the budget,used by the huge projects.
+	// only the release export is bounded,the patch export still analyses all assets in memory
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReleaseSetting|Analysis")
+		bool bMemoryBoundedAnalysis = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReleaseSetting|Analysis", meta = (EditCondition = "bMemoryBoundedAnalysis", ClampMin = "64"))
+		int32 AnalysisMemoryBudgetMB = 4096;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReleaseSetting|Extern Files")
 		TArray<FExternAssetFileInfo> AddExternFileToPak;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReleaseSetting|Extern Files")
 		TArray<FExternDirectoryInfo> AddExternDirectoryToPak;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveTo")
 		bool bSaveReleaseConfig;
+	// compress the Release json,e.g. Zlib/Oodle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveTo")
+		bool bCompressVersionFiles = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveTo", meta = (EditCondition = "bCompressVersionFiles"))
+		FString VersionFilesCompressionFormat = TEXT("Zlib");
 	UPROPERTY(EditAnywhere, BlueprintReadWrite,Category = "SaveTo")
 		FDirectoryPath SavePath;
 };
\ No newline at end of file
@@ -0,0 +1,55 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "FExportPatchBatch.h"
+#include "FHotPatcherAssetSnapshot.h"
+
+// engine header
+#include "HAL/PlatformTime.h"
+
+void FExportPatchBatch::AddPatchSetting(UExportPatchSettings* InExportPatchSetting)
+{
+	PatchSettings.Add(InExportPatchSetting);
+}
+
+int32 FExportPatchBatch::RunSynchronously()
+{
+	check(IsInGameThread());
+	double BeginTime = FPlatformTime::Seconds();
+
+	TSharedPtr<FHotPatcherAssetSnapshot, ESPMode::ThreadSafe> AssetSnapshot = MakeShareable(new FHotPatcherAssetSnapshot);
+	AssetSnapshot->Capture();
+	TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> SharedPakProcCounter = MakeShareable(new FThreadSafeCounter);
+
+	FThreadSafeCounter FailedNum;
+	TArray<TSharedRef<FHotPatcherPipeline, ESPMode::ThreadSafe>> Pipelines;
+	for (UExportPatchSettings* PatchSetting : PatchSettings)
+	{
+		TSharedRef<FExportPatchPipeline, ESPMode::ThreadSafe> Pipeline = MakeShareable(new FExportPatchPipeline(PatchSetting, AssetSnapshot));
+		Pipeline->SetSharedPakProcCounter(SharedPakProcCounter);
+
+		FString VersionId = PatchSetting->GetVersionId();
+		Pipeline->ProgressDelegate.AddLambda([VersionId](const FText& InMsg, float InPercent)
+		{
+			UE_LOG(LogTemp, Display, TEXT("[%s] %3d%% %s"), *VersionId, FMath::RoundToInt(InPercent * 100.f), *InMsg.ToString());
+		});
+		Pipeline->FinishedDelegate.AddLambda([VersionId, &FailedNum](bool bInSuccessed, const FString& InErrorMsg)
+		{
+			if (!bInSuccessed)
+			{
+				FailedNum.Increment();
+				UE_LOG(LogTemp, Error, TEXT("[%s] FAILD:\n%s"), *VersionId, *InErrorMsg);
+			}
+			UE_LOG(LogTemp, Display, TEXT("Export patch %s is %s."), *VersionId, bInSuccessed ? TEXT("Success") : TEXT("FAILD"));
+		});
+		Pipelines.Add(Pipeline);
+	}
+
+	for (const auto& Pipeline : Pipelines)
+	{
+		Pipeline->Start();
+	}
+	FHotPatcherPipeline::WaitForPipelines(Pipelines);
+
+	UE_LOG(LogTemp, Display, TEXT("Export %d patches,%d faild,take %.2fs."), Pipelines.Num(), FailedNum.GetValue(), FPlatformTime::Seconds() - BeginTime);
+	return FailedNum.GetValue();
+}
@@ -0,0 +1,28 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+#include "ExportPatchSettings.h"
+#include "FExportPatchPipeline.h"
+
+// engine header
+#include "CoreMinimal.h"
+
+/**
+ * Export many patch configs over the same project state.
+ * The asset registry is refreshed and captured once,the configs are analysed on the snapshot and exported concurrently,
+ * the UnrealPak processes of all configs are limited by the max pak process num together.
+ */
+class FExportPatchBatch
+{
+public:
+	// the settings must be kept alive while exporting
+	void AddPatchSetting(UExportPatchSettings* InExportPatchSetting);
+
+	// block the game thread until all patches exported,return the failed num
+	int32 RunSynchronously();
+
+	FORCEINLINE int32 GetPatchNum()const { return PatchSettings.Num(); }
+
+private:
+	TArray<UExportPatchSettings*> PatchSettings;
+};
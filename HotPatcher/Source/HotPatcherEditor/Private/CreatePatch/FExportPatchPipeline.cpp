@@ -0,0 +1,732 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "FExportPatchPipeline.h"
+#include "FlibHotPatcherEditorHelper.h"
+#include "FlibPatchParserHelper.h"
+#include "FLibAssetManageHelperEx.h"
+#include "FHotPatcherDelta.h"
+#include "FHotPatcherPakWriter.h"
+#include "FHotPatcherProfiler.h"
+#include "FAssetRegistryChangeTracker.h"
+#include "ThreadUtils/FProcWorkerPool.hpp"
+// engine header
+#include "Misc/FileHelper.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "HAL/FileManager.h"
+#include "Async/ParallelFor.h"
+#include "Misc/EngineVersion.h"
+
+#define LOCTEXT_NAMESPACE "SHotPatcherCreatePatch"
+
+FExportPatchPipeline::FExportPatchPipeline(UExportPatchSettings* InExportPatchSetting, TSharedPtr<const FHotPatcherAssetSnapshot, ESPMode::ThreadSafe> InAssetSnapshot)
+	: FHotPatcherPipeline(FExportPatchPipeline::GetAmountOfWork(InExportPatchSetting)),
+	ExportPatchSetting(InExportPatchSetting),
+	AssetSnapshot(InAssetSnapshot),
+	ProfileHandle(0)
+{
+	// the asset registry is only accessed in the game thread
+	AddStage(TEXT("Analysis"), !AssetSnapshot.IsValid(), {}, { TEXT("Versions") }, [this]() { return DoAnalysis(); });
+	AddStage(TEXT("Validation"), false, { TEXT("Versions") }, { TEXT("Validated") }, [this]() { return DoValidation(); });
+	// the manifests of version are serialized while pakking
+	AddStage(TEXT("PakVersion"), false, { TEXT("Validated") }, { TEXT("PakVersionFile") }, [this]() { return DoSavePakVersion(); });
+	AddStage(TEXT("DiffManifest"), false, { TEXT("Validated") }, { TEXT("DiffFile") }, [this]() { return DoSaveDiff(); });
+	AddStage(TEXT("ReleaseManifest"), false, { TEXT("Validated") }, { TEXT("ReleaseFile") }, [this]() { return DoSaveRelease(); });
+	AddStage(TEXT("PatchConfig"), false, { TEXT("Validated") }, { TEXT("PatchConfigFile") }, [this]() { return DoSavePatchConfig(); });
+	// the map load order query the asset registry,so it's in the game thread
+	AddStage(TEXT("PakOrder"), InExportPatchSetting->IsOrderByMapDependencies(), { TEXT("Validated") }, { TEXT("PakOrderMap") }, [this]() { return DoPakOrder(); });
+	AddStage(TEXT("Pak"), false, { TEXT("PakVersionFile"), TEXT("PakOrderMap") }, { TEXT("Paks") }, [this]() { return DoPak(); });
+	AddStage(TEXT("Delta"), false, { TEXT("Paks") }, { TEXT("DeltaFiles") }, [this]() { return DoDelta(); });
+	AddStage(TEXT("PakFilesInfo"), false, { TEXT("Paks") }, { TEXT("PakFilesInfoFile") }, [this]() { return DoSavePakFilesInfo(); });
+}
+
+float FExportPatchPipeline::GetAmountOfWork(const UExportPatchSettings* InExportPatchSetting)
+{
+	return 2.f * InExportPatchSetting->GetPakTargetPlatforms().Num() + 6.0f + (InExportPatchSetting->IsSharedPakForIdenticalContent() ? 1.f : 0.f) + (InExportPatchSetting->IsCreateDeltaFromBasePaks() ? 1.f : 0.f);
+}
+
+void FExportPatchPipeline::NotifyFileSaved(const FText& InMsg, const FString& InSavedFile)const
+{
+	FHotPatcherPipeline::RunOnGameThread([InMsg, InSavedFile]()
+	{
+		UFlibHotPatcherEditorHelper::CreateSaveFileNotify(InMsg, InSavedFile);
+	});
+}
+
+void FExportPatchPipeline::OnStart()
+{
+	ProfileHandle = FHotPatcherProfiler::BeginProfile(FString::Printf(TEXT("ExportPatch %s"), *ExportPatchSetting->GetVersionId()));
+}
+
+void FExportPatchPipeline::OnFinish(bool bInSuccessed)
+{
+	// the version save path is empty if the analysis isn't finished
+	FString SaveProfileFile;
+	if (!CurrentVersionSavePath.IsEmpty())
+	{
+		SaveProfileFile = FPaths::Combine(CurrentVersionSavePath, FString::Printf(TEXT("%s_BuildProfile.json"), *CurrentVersion.VersionId));
+	}
+	FHotPatcherProfiler::EndProfile(ProfileHandle, SaveProfileFile);
+}
+
+bool FExportPatchPipeline::DoAnalysis()
+{
+	{
+		FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch", "ExportPatchAnalysis", "Analysis the difference of version {0}"), FText::FromString(ExportPatchSetting->GetVersionId()));
+		EnterProgressFrame(1.0, DiaLogMsg);
+	}
+
+	if (ExportPatchSetting->IsByBaseVersion() && !ExportPatchSetting->GetBaseVersionInfo(BaseVersion))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Deserialize Base Version Faild!"));
+		Fail(TEXT("Deserialize Base Version Faild!\n"));
+		return false;
+	}
+
+	if (AssetSnapshot.IsValid())
+	{
+		CurrentVersion = AssetSnapshot->ExportReleaseVersionInfo(
+			ExportPatchSetting->GetVersionId(),
+			BaseVersion.VersionId,
+			FDateTime::UtcNow().ToString(),
+			ExportPatchSetting->GetAssetIncludeFilters(),
+			ExportPatchSetting->GetAssetIgnoreFilters(),
+			ExportPatchSetting->GetIncludeSpecifyAssets(),
+			ExportPatchSetting->GetAllExternFiles(true),
+			ExportPatchSetting->IsIncludeHasRefAssetsOnly()
+		);
+	}
+	else
+	{
+		FAssetRegistryChangeTracker::Get().RefreshAssetManagerDatabase(ExportPatchSetting->IsForceRefreshAssetRegistry());
+		CurrentVersion = ExportPatchSetting->GetNewPatchVersionInfo();
+	}
+
+	CurrentVersionSavePath = ExportPatchSetting->GetCurrentVersionSavePath();
+
+	// parser version difference
+
+	FAssetDependenciesInfo BaseVersionAssetDependInfo = BaseVersion.AssetInfo;
+	FAssetDependenciesInfo CurrentVersionAssetDependInfo = CurrentVersion.AssetInfo;
+
+	UFlibPatchParserHelper::DiffVersionAssets(
+		CurrentVersionAssetDependInfo,
+		BaseVersionAssetDependInfo,
+		AddAssetDependInfo,
+		ModifyAssetDependInfo,
+		DeleteAssetDependInfo
+	);
+
+	UFlibPatchParserHelper::DiffVersionExFiles(CurrentVersion, BaseVersion, AddExternalFiles, ModifyExternalFiles, DeleteExternalFiles);
+
+	AllChangedExternalFiles.Append(AddExternalFiles);
+	AllChangedExternalFiles.Append(ModifyExternalFiles);
+
+	// handle add & modify asset only
+	AllChangedAssetInfo = UFLibAssetManageHelperEx::CombineAssetDependencies(AddAssetDependInfo, ModifyAssetDependInfo);
+	return true;
+}
+
+bool FExportPatchPipeline::DoValidation()
+{
+	{
+		FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch", "ExportPatchValidation", "Checking the changed assets of version {0}"), FText::FromString(CurrentVersion.VersionId));
+		EnterProgressFrame(1.0, DiaLogMsg);
+	}
+
+	// 错误处理
+	{
+		FString GenErrorMsg;
+		// 检查所修改的资源是否被Cook过
+		{
+
+			for (const auto& PlatformName : ExportPatchSetting->GetPakTargetPlatformNames())
+			{
+				TArray<FAssetDetail> ValidCookAssets;
+				TArray<FAssetDetail> InvalidCookAssets;
+
+				UFlibHotPatcherEditorHelper::CheckInvalidCookFilesByAssetDependenciesInfo(UKismetSystemLibrary::GetProjectDirectory(), PlatformName, AllChangedAssetInfo, ValidCookAssets, InvalidCookAssets);
+
+				if (InvalidCookAssets.Num() > 0)
+				{
+					GenErrorMsg.Append(FString::Printf(TEXT("%s UnCooked Assets:\n"), *PlatformName));
+
+					for (const auto& Asset : InvalidCookAssets)
+					{
+						FString AssetLongPackageName;
+						UFLibAssetManageHelperEx::ConvPackagePathToLongPackageName(Asset.mPackagePath, AssetLongPackageName);
+						GenErrorMsg.Append(FString::Printf(TEXT("\t%s\n"), *AssetLongPackageName));
+					}
+				}
+			}
+		}
+
+		// 检查资源是否存在于磁盘
+		if (ExportPatchSetting->IsCheckInValidAssets())
+		{
+			TArray<FString> InValidAssets;
+			UFLibAssetManageHelperEx::GetAllInValidAssetInProject(AllChangedAssetInfo, InValidAssets, TArray<FString>{TEXT("Script")});
+			if (InValidAssets.Num() > 0)
+			{
+				GenErrorMsg.Append(TEXT("InValid Assets:\n"));
+				for (const auto& AssetLongPackageName : InValidAssets)
+				{
+					GenErrorMsg.Append(FString::Printf(TEXT("\t%s\n"), *AssetLongPackageName));
+				}
+			}
+		}
+
+		// 检查添加的外部文件是否有重复
+		//{
+		//	TArray<FString> AllExternList;
+		//	TArray<FString> RepeatList;
+
+		//	const TArray<FString>& AllExternFileToPakCommands = ExportPatchSetting->CombineAddExternFileToCookCommands();
+		//	const TArray<FString>& AllExtensionDirectoryToPakCommands = ExportPatchSetting->CombineAllExternDirectoryCookCommand();
+
+		//	auto FilterRepeatLambda = [&AllExternList, &RepeatList](const TArray<FString>& InList)
+		//	{
+		//		for (const auto& Item : InList)
+		//		{
+		//			if (!AllExternList.Contains(Item))
+		//			{
+		//				AllExternList.Add(Item);
+		//				continue;
+		//			}
+
+		//			if (!RepeatList.Contains(Item))
+		//			{
+		//				RepeatList.Add(Item);
+		//			}
+		//		}
+		//	};
+
+		//	FilterRepeatLambda(AllExternFileToPakCommands);
+		//	FilterRepeatLambda(AllExtensionDirectoryToPakCommands);
+
+		//	if (RepeatList.Num() > 0)
+		//	{
+		//		GenErrorMsg.Append(FString::Printf(TEXT("Repeat Extern File(s):\n")));
+		//		for (const auto& RepeatFile : RepeatList)
+		//		{
+		//			GenErrorMsg.Append(FString::Printf(TEXT("\t%s\n"), *RepeatFile));
+		//		}
+
+		//	}
+		//}
+
+
+
+		// 如果有错误信息 则输出后退出
+		if (!GenErrorMsg.IsEmpty())
+		{
+			Fail(GenErrorMsg);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FExportPatchPipeline::DoSavePakVersion()
+{
+	// save pakversion.json
+	PakVersion = UExportPatchSettings::GetPakVersion(CurrentVersion, FDateTime::UtcNow().ToString());
+	if (ExportPatchSetting->IsIncludePakVersion())
+	{
+		FString SavePakVersionFilePath = UExportPatchSettings::GetSavePakVersionPath(CurrentVersionSavePath, CurrentVersion);
+
+		// the date and check code change every export,reuse the last pakversion.json of the same version,
+		// so it's a same input of the pak fingerprint and the unchanged paks can be skipped
+		FString LastPakVersionContent;
+		FPakVersion LastPakVersion;
+		if (ExportPatchSetting->IsSkipUnchangedPaks() &&
+			FPaths::FileExists(SavePakVersionFilePath) &&
+			UFLibAssetManageHelperEx::LoadFileToString(SavePakVersionFilePath, LastPakVersionContent) &&
+			UFlibPakHelper::DeserializeStringToPakVersion(LastPakVersionContent, LastPakVersion) &&
+			LastPakVersion.VersionId == PakVersion.VersionId &&
+			LastPakVersion.BaseVersionId == PakVersion.BaseVersionId)
+		{
+			PakVersion = LastPakVersion;
+		}
+
+		FString OutString;
+		if (UFlibPakHelper::SerializePakVersionToString(PakVersion, OutString))
+		{
+			UFLibAssetManageHelperEx::SaveStringToFile(SavePakVersionFilePath, OutString);
+		}
+	}
+	return true;
+}
+
+bool FExportPatchPipeline::DoPakOrder()
+{
+	PakOrderMap.Reset();
+	ExportPatchSetting->GetPakOrderMap(AllChangedAssetInfo, PakOrderMap);
+	return true;
+}
+
+bool FExportPatchPipeline::DoPak()
+{
+	// package all selected platform
+	{
+		// generated cook command form asset list
+		// if no feature needs all commands in memory,they are streamed to the pak list file directly
+		const bool bStreamPakList = ExportPatchSetting->IsStreamPakList();
+		TMap<FString, TArray<FString>> PlatformPakCommands;
+		TMap<FString, int32> StreamedPakCommandNums;
+		for (const auto& PlatformName : ExportPatchSetting->GetPakTargetPlatformNames())
+		{
+			// Update Progress Dialog
+			{
+				FText Dialog = FText::Format(NSLOCTEXT("ExportPatch", "GeneratedPakCommands", "Generating UnrealPak Commands of {0} Platform."), FText::FromString(PlatformName));
+				EnterProgressFrame(1.0, Dialog);
+			}
+			if (bStreamPakList)
+			{
+				FString PakListFile = UExportPatchSettings::GetSavePakCommandsPath(CurrentVersionSavePath, PlatformName, CurrentVersion);
+				int32 PakCommandNum = 0;
+				if (ExportPatchSetting->SavePakListInTheSetting(PlatformName, AllChangedAssetInfo, AllChangedExternalFiles, ExportPatchSetting->IsEnableExternFilesDiff(), PakListFile, PakCommandNum))
+				{
+					StreamedPakCommandNums.Add(PlatformName, PakCommandNum);
+				}
+				continue;
+			}
+			PlatformPakCommands.Add(PlatformName, ExportPatchSetting->CombineAllCookCommandsInTheSetting(PlatformName, AllChangedAssetInfo, AllChangedExternalFiles, ExportPatchSetting->IsEnableExternFilesDiff()));
+		}
+
+		// the identical files in all platforms are packaged to the shared pak
+		if (ExportPatchSetting->IsSharedPakForIdenticalContent())
+		{
+			TArray<FString> SharedPakCommands;
+			if (UFlibPatchParserHelper::SplitSharedPakCommands(PlatformPakCommands, SharedPakCommands))
+			{
+				PlatformPakCommands.Add(UExportPatchSettings::GetSharedPakName(), SharedPakCommands);
+			}
+		}
+
+		// sort the files by the load order,so the patch content can be read sequentially
+		if (PakOrderMap.Num())
+		{
+			for (auto& PlatformPakCommand : PlatformPakCommands)
+			{
+				UFlibPatchParserHelper::SortPakCommandsByOrder(PlatformPakCommand.Value, PakOrderMap);
+			}
+		}
+
+		// split the pak commands of platform to 001_P,002_P... by the max chunk size
+		PakChunkJobs.Reset();
+		for (const auto& StreamedPakCommandNum : StreamedPakCommandNums)
+		{
+			const FString& PlatformName = StreamedPakCommandNum.Key;
+			FString PakListFile = UExportPatchSettings::GetSavePakCommandsPath(CurrentVersionSavePath, PlatformName, CurrentVersion);
+			if (!StreamedPakCommandNum.Value)
+			{
+				UE_LOG(LogTemp, Log, TEXT("[%s] No files,skip pak."), *PlatformName);
+				IFileManager::Get().Delete(*PakListFile);
+				continue;
+			}
+			FPakChunkJob& PakChunkJob = PakChunkJobs[PakChunkJobs.AddDefaulted()];
+			PakChunkJob.JobName = PlatformName;
+			PakChunkJob.PlatformName = PlatformName;
+			PakChunkJob.ChunkPostfix = TEXT("001");
+			PakChunkJob.PakFile = FPaths::Combine(
+				CurrentVersionSavePath,
+				PlatformName,
+				FString::Printf(TEXT("%s_%s_%s_P.pak"), *CurrentVersion.VersionId, *PlatformName, *PakChunkJob.ChunkPostfix)
+			);
+			PakChunkJob.PakListFile = PakListFile;
+			PakChunkJob.Progress = 1.f;
+			PakChunkJob.bPakListSaved = true;
+		}
+		for (auto& PlatformPakCommand : PlatformPakCommands)
+		{
+			const FString& PlatformName = PlatformPakCommand.Key;
+
+			// all files of the platform are in the shared pak
+			if (!PlatformPakCommand.Value.Num())
+			{
+				UE_LOG(LogTemp, Log, TEXT("[%s] No platform specific files,skip pak."), *PlatformName);
+				continue;
+			}
+
+			TArray<TArray<FString>> PakChunks;
+			UFlibPatchParserHelper::SplitPakCommandsBySize(PlatformPakCommand.Value, ExportPatchSetting->GetMaxPakChunkSize(), PakChunks);
+
+			FString PlatformPakListFile = UExportPatchSettings::GetSavePakCommandsPath(CurrentVersionSavePath, PlatformName, CurrentVersion);
+			for (int32 ChunkIndex = 0; ChunkIndex < PakChunks.Num(); ++ChunkIndex)
+			{
+				FString ChunkPostfix = FString::Printf(TEXT("%03d"), ChunkIndex + 1);
+				FPakChunkJob& PakChunkJob = PakChunkJobs[PakChunkJobs.AddDefaulted()];
+				PakChunkJob.JobName = PakChunks.Num() > 1 ? FString::Printf(TEXT("%s_%s"), *PlatformName, *ChunkPostfix) : PlatformName;
+				PakChunkJob.PlatformName = PlatformName;
+				PakChunkJob.ChunkPostfix = ChunkPostfix;
+				PakChunkJob.PakFile = FPaths::Combine(
+					CurrentVersionSavePath,
+					PlatformName,
+					FString::Printf(TEXT("%s_%s_%s_P.pak"), *CurrentVersion.VersionId, *PlatformName, *ChunkPostfix)
+				);
+				PakChunkJob.PakListFile = !ChunkIndex ? PlatformPakListFile :
+					FString::Printf(TEXT("%s_%s.txt"), *FPaths::Combine(FPaths::GetPath(PlatformPakListFile), FPaths::GetBaseFilename(PlatformPakListFile)), *ChunkPostfix);
+				PakChunkJob.PakOrderFile = FPaths::Combine(FPaths::GetPath(PlatformPakListFile), FString::Printf(TEXT("PakOrder_%s_%s_%s.txt"), *CurrentVersion.VersionId, *PlatformName, *ChunkPostfix));
+				PakChunkJob.PakCommands = MoveTemp(PakChunks[ChunkIndex]);
+				PakChunkJob.Progress = 1.f / PakChunks.Num();
+			}
+		}
+
+		// the options the in process pak writer can't handle,e.g. -encrypt -sign,fallback to UnrealPak
+		FPakWriterOptions InProcessPakWriterOptions;
+		const bool bUseInProcessPakWriter = ExportPatchSetting->IsUseInProcessPakWriter() && FHotPatcherPakWriter::ParseUnrealPakOptions(ExportPatchSetting->GetUnrealPakOptions(), InProcessPakWriterOptions);
+		if (ExportPatchSetting->IsUseInProcessPakWriter() && !bUseInProcessPakWriter)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("The UnrealPak options are not supported by the in process pak writer,use UnrealPak."));
+		}
+
+		// skip the paks whose inputs are not changed
+		if (ExportPatchSetting->IsSkipUnchangedPaks())
+		{
+			TSet<FString> AllSourceFiles;
+			for (const auto& PakChunkJob : PakChunkJobs)
+			{
+				for (const auto& PakCommand : PakChunkJob.PakCommands)
+				{
+					FPakWriteEntry Entry;
+					if (FHotPatcherPakWriter::ParsePakCommand(PakCommand, Entry))
+					{
+						AllSourceFiles.Add(Entry.SourceFile);
+					}
+				}
+			}
+			TMap<FString, FString> FilesHash = UFlibPatchParserHelper::GetFilesHash(AllSourceFiles.Array());
+
+			TArray<FString> ExtraInputs = ExportPatchSetting->GetUnrealPakOptions();
+			ExtraInputs.Add(FEngineVersion::Current().ToString());
+			ExtraInputs.Add(bUseInProcessPakWriter ? TEXT("InProcessPakWriter") : TEXT("UnrealPak"));
+
+			FString PakBuildCacheDir = ExportPatchSetting->GetPakBuildCacheDir();
+			for (auto& PakChunkJob : PakChunkJobs)
+			{
+				PakChunkJob.Fingerprint = UFlibPatchParserHelper::GetPakFingerprint(PakChunkJob.PakCommands, FilesHash, ExtraInputs);
+
+				FString FingerprintFile = PakChunkJob.PakFile + TEXT(".fingerprint");
+				FString LastFingerprint;
+				if (FPaths::FileExists(PakChunkJob.PakFile) && FFileHelper::LoadFileToString(LastFingerprint, *FingerprintFile) && LastFingerprint.TrimStartAndEnd() == PakChunkJob.Fingerprint)
+				{
+					UE_LOG(LogTemp, Log, TEXT("[%s] Inputs are not changed,skip %s."), *PakChunkJob.JobName, *PakChunkJob.PakFile);
+					PakChunkJob.bUpToDate = true;
+					continue;
+				}
+				IFileManager::Get().Delete(*FingerprintFile, false, false, true);
+
+				FString CachedPakFile = FPaths::Combine(PakBuildCacheDir, PakChunkJob.Fingerprint + TEXT(".pak"));
+				if (!PakBuildCacheDir.IsEmpty() && FPaths::FileExists(CachedPakFile) && IFileManager::Get().Copy(*PakChunkJob.PakFile, *CachedPakFile) == COPY_OK)
+				{
+					UE_LOG(LogTemp, Log, TEXT("[%s] Copy %s from the build cache."), *PakChunkJob.JobName, *PakChunkJob.PakFile);
+					FFileHelper::SaveStringToFile(PakChunkJob.Fingerprint, *FingerprintFile);
+					PakChunkJob.bUpToDate = true;
+				}
+			}
+		}
+
+		FProcWorkerPool UnrealPakPool(ExportPatchSetting->GetMaxPakProcessNum(), ExportPatchSetting->GetPakProcessMemoryMB());
+		UnrealPakPool.SetSharedProcCounter(SharedPakProcCounter);
+		UnrealPakPool.JobOutputMsgDelegate.AddLambda([](const FString& InJobName, const FString& InMsg)
+		{
+			UE_LOG(LogTemp, Log, TEXT("[%s] %s"), *InJobName, *InMsg);
+		});
+		// every UnrealPak process is a track of the build profile
+		TMap<FString, double> UnrealPakBeginTimes;
+		UnrealPakPool.JobStartedDelegate.AddLambda([&UnrealPakBeginTimes](const FString& InJobName)
+		{
+			UnrealPakBeginTimes.Add(InJobName, FPlatformTime::Seconds());
+		});
+		UnrealPakPool.JobFinishedDelegate.AddLambda([this, &UnrealPakBeginTimes](const FString& InJobName, bool bInSuccessed)
+		{
+			if (const double* BeginTime = UnrealPakBeginTimes.Find(InJobName))
+			{
+				const FString UnrealPakTrack = FString::Printf(TEXT("UnrealPak %s"), *InJobName);
+				FHotPatcherProfiler::AddEvent(UnrealPakTrack, UnrealPakTrack, *BeginTime, FPlatformTime::Seconds(), { TPair<FString, int64>(TEXT("Successed"), bInSuccessed ? 1 : 0) });
+			}
+			const FPakChunkJob* PakChunkJob = PakChunkJobs.FindByPredicate([&InJobName](const FPakChunkJob& InPakChunkJob) { return InPakChunkJob.JobName == InJobName; });
+			FText Dialog = FText::Format(NSLOCTEXT("ExportPatch", "GeneratedPak", "Generating Pak list of {0} Platform."), FText::FromString(InJobName));
+			EnterProgressFrame(PakChunkJob ? PakChunkJob->Progress : 1.f, Dialog);
+			UE_LOG(LogTemp, Log, TEXT("[%s] UnrealPak is %s."), *InJobName, bInSuccessed ? TEXT("Success") : TEXT("FAILD"));
+		});
+
+		FString UnrealPakBinary = UFlibPatchParserHelper::GetUnrealPakBinary();
+		for (auto& PakChunkJob : PakChunkJobs)
+		{
+			if (IsCanceled())
+				break;
+			if (PakChunkJob.bUpToDate)
+			{
+				FText Dialog = FText::Format(NSLOCTEXT("ExportPatch", "GeneratedPak", "Generating Pak list of {0} Platform."), FText::FromString(PakChunkJob.JobName));
+				EnterProgressFrame(PakChunkJob.Progress, Dialog);
+				continue;
+			}
+
+			// save paklist to file
+			if (PakChunkJob.bPakListSaved || UFlibPatchParserHelper::SavePakListFile(PakChunkJob.PakCommands, PakChunkJob.PakListFile))
+			{
+				if (ExportPatchSetting->IsSavePakList())
+				{
+					auto Msg = LOCTEXT("SavePatchPakCommand", "Succeed to export the Patch Packaghe Pak Command.");
+					NotifyFileSaved(Msg, PakChunkJob.PakListFile);
+				}
+			}
+
+			// create .pak file in the editor process
+			if (bUseInProcessPakWriter)
+			{
+				if (UFlibPakHelper::CreatePakFileWithInfo(PakChunkJob.PakFile, PakChunkJob.PakCommands, ExportPatchSetting->GetUnrealPakOptions(), ExportPatchSetting->GetPakBlockCacheDir(), PakChunkJob.PakFileInfo))
+				{
+					PakChunkJob.bHasPakFileInfo = true;
+					FText Dialog = FText::Format(NSLOCTEXT("ExportPatch", "GeneratedPak", "Generating Pak list of {0} Platform."), FText::FromString(PakChunkJob.JobName));
+					EnterProgressFrame(PakChunkJob.Progress, Dialog);
+					continue;
+				}
+				UE_LOG(LogTemp, Warning, TEXT("[%s] In process pak writer faild,fallback to UnrealPak."), *PakChunkJob.JobName);
+			}
+
+			// create UnrealPak.exe create .pak file
+			{
+				FString CommandLine = FString::Printf(
+					TEXT("%s -create=%s"),
+					*(TEXT("\"") + PakChunkJob.PakFile + TEXT("\"")),
+					*(TEXT("\"") + PakChunkJob.PakListFile + TEXT("\""))
+				);
+
+				// keep the sorted order in UnrealPak
+				if (PakOrderMap.Num() && UFlibPatchParserHelper::SavePakOrderFile(PakChunkJob.PakCommands, PakChunkJob.PakOrderFile))
+				{
+					CommandLine.Append(FString::Printf(TEXT(" -order=\"%s\""), *PakChunkJob.PakOrderFile));
+				}
+
+				// combine UnrealPak Options
+				TArray<FString> UnrealPakOptions = ExportPatchSetting->GetUnrealPakOptions();
+				for (const auto& Option : UnrealPakOptions)
+				{
+					CommandLine.Append(FString::Printf(TEXT(" %s"), *Option));
+				}
+
+				UnrealPakPool.AddJob(PakChunkJob.JobName, UnrealPakBinary, CommandLine);
+			}
+		}
+
+		// run all UnrealPak process,kill them if canceled
+		SetCancelHandler([&UnrealPakPool]() { UnrealPakPool.Cancel(); });
+		if (!IsCanceled())
+		{
+			UnrealPakPool.Run();
+		}
+		SetCancelHandler(nullptr);
+
+		for (const auto& PakChunkJob : PakChunkJobs)
+		{
+			if (FPaths::FileExists(PakChunkJob.PakFile))
+			{
+				FText Msg = LOCTEXT("SavedPakFileMsg", "Successd to Package the patch as Pak.");
+				NotifyFileSaved(Msg, PakChunkJob.PakFile);
+
+				// record the inputs of the new pak
+				if (!PakChunkJob.Fingerprint.IsEmpty() && !PakChunkJob.bUpToDate)
+				{
+					FFileHelper::SaveStringToFile(PakChunkJob.Fingerprint, *(PakChunkJob.PakFile + TEXT(".fingerprint")));
+					FString PakBuildCacheDir = ExportPatchSetting->GetPakBuildCacheDir();
+					if (!PakBuildCacheDir.IsEmpty())
+					{
+						IFileManager::Get().Copy(*FPaths::Combine(PakBuildCacheDir, PakChunkJob.Fingerprint + TEXT(".pak")), *PakChunkJob.PakFile);
+					}
+				}
+
+				FPakFileInfo CurrentPakInfo = PakChunkJob.PakFileInfo;
+				if (PakChunkJob.bHasPakFileInfo || UFlibPatchParserHelper::GetPakFileInfo(PakChunkJob.PakFile, CurrentPakInfo))
+				{
+					CurrentPakInfo.PakVersion = PakVersion;
+					PakFilesInfoMap.FindOrAdd(PakChunkJob.PlatformName).Add(CurrentPakInfo);
+				}
+			}
+
+			// is save PakList?
+			if (!ExportPatchSetting->IsSavePakList())
+			{
+				for (const auto& PakListFile : TArray<FString>{ PakChunkJob.PakListFile, PakChunkJob.PakOrderFile })
+				{
+					if (FPaths::FileExists(PakListFile))
+					{
+						IFileManager::Get().Delete(*PakListFile);
+					}
+				}
+			}
+		}
+	}
+
+	// delete pakversion.json,it's kept when skip unchanged paks,the next export reuses it as the same pak input
+	{
+		FString PakVersionSavedPath = UExportPatchSettings::GetSavePakVersionPath(CurrentVersionSavePath,CurrentVersion);
+		if (ExportPatchSetting->IsIncludePakVersion() && !ExportPatchSetting->IsSkipUnchangedPaks() && FPaths::FileExists(PakVersionSavedPath))
+		{
+			IFileManager::Get().Delete(*PakVersionSavedPath);
+		}
+	}
+	return !IsCanceled();
+}
+
+bool FExportPatchPipeline::DoDelta()
+{
+	// binary delta from the paks of base version
+	if (ExportPatchSetting->IsCreateDeltaFromBasePaks() && !CurrentVersion.BaseVersionId.IsEmpty())
+	{
+		FText Dialog = FText::Format(NSLOCTEXT("ExportPatch", "GeneratedDelta", "Generating Delta of version {0}"), FText::FromString(CurrentVersion.VersionId));
+		EnterProgressFrame(1.0, Dialog);
+
+		FString BasePaksDir = ExportPatchSetting->GetDeltaBasePaksDir(CurrentVersion.BaseVersionId);
+		TArray<FString> DeltaFiles;
+		DeltaFiles.SetNum(PakChunkJobs.Num());
+		ParallelFor(PakChunkJobs.Num(), [&](int32 JobIndex)
+		{
+			const FPakChunkJob& PakChunkJob = PakChunkJobs[JobIndex];
+			FString BasePakFile = FPaths::Combine(
+				BasePaksDir,
+				PakChunkJob.PlatformName,
+				FString::Printf(TEXT("%s_%s_%s_P.pak"), *CurrentVersion.BaseVersionId, *PakChunkJob.PlatformName, *PakChunkJob.ChunkPostfix)
+			);
+			if (!FPaths::FileExists(BasePakFile) || !FPaths::FileExists(PakChunkJob.PakFile))
+			{
+				UE_LOG(LogTemp, Log, TEXT("[%s] Base pak %s not found,skip delta."), *PakChunkJob.JobName, *BasePakFile);
+				return;
+			}
+
+			FString DeltaFile = FPaths::Combine(
+				FPaths::GetPath(PakChunkJob.PakFile),
+				FString::Printf(TEXT("%s_%s_%s_%s_P.delta"), *CurrentVersion.BaseVersionId, *CurrentVersion.VersionId, *PakChunkJob.PlatformName, *PakChunkJob.ChunkPostfix)
+			);
+			if (FHotPatcherDelta::CreateDelta(BasePakFile, PakChunkJob.PakFile, DeltaFile))
+			{
+				DeltaFiles[JobIndex] = DeltaFile;
+			}
+		});
+
+		for (const auto& DeltaFile : DeltaFiles)
+		{
+			if (!DeltaFile.IsEmpty())
+			{
+				FText Msg = LOCTEXT("SavedDeltaFileMsg", "Successd to create the delta of pak.");
+				NotifyFileSaved(Msg, DeltaFile);
+			}
+		}
+	}
+	return true;
+}
+
+bool FExportPatchPipeline::DoSaveDiff()
+{
+	// save difference to file
+	{
+		FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch","ExportPatchDiffFile","Generating Diff info of version {0}"),FText::FromString(CurrentVersion.VersionId));
+		EnterProgressFrame(1.0, DiaLogMsg);
+	}
+
+	if (ExportPatchSetting->IsSaveDiffAnalysis())
+	{
+		FString SerializeDiffInfo =
+			FString::Printf(TEXT("%s\n%s\n"),
+				*UFlibPatchParserHelper::SerializeDiffAssetsInfomationToString(AddAssetDependInfo, ModifyAssetDependInfo, DeleteAssetDependInfo),
+				ExportPatchSetting->IsEnableExternFilesDiff()?
+				*UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToString(AddExternalFiles, ModifyExternalFiles, DeleteExternalFiles):
+				*UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToString(ExportPatchSetting->GetAllExternFiles(), TArray<FExternAssetFileInfo>{}, TArray<FExternAssetFileInfo>{})
+			);
+
+
+		FString SaveDiffToFile = FPaths::Combine(
+			CurrentVersionSavePath,
+			FString::Printf(TEXT("%s_%s_Diff.json"), *CurrentVersion.BaseVersionId, *CurrentVersion.VersionId)
+		);
+		bool bSaveStatus = ExportPatchSetting->IsCompressVersionFiles() ?
+			UFLibAssetManageHelperEx::SaveStringToCompressedFile(SaveDiffToFile, SerializeDiffInfo, ExportPatchSetting->GetVersionFilesCompressionFormat()) :
+			UFLibAssetManageHelperEx::SaveStringToFile(SaveDiffToFile, SerializeDiffInfo);
+		if (bSaveStatus)
+		{
+			auto Msg = LOCTEXT("SavePatchDiffInfo", "Succeed to export New Patch Diff Info.");
+			NotifyFileSaved(Msg, SaveDiffToFile);
+		}
+	}
+	return true;
+}
+
+bool FExportPatchPipeline::DoSaveRelease()
+{
+	// save Patch Tracked asset info to file
+	{
+		FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch", "ExportPatchAssetInfo", "Generating Patch Tacked Asset info of version {0}"), FText::FromString(CurrentVersion.VersionId));
+		EnterProgressFrame(1.0, DiaLogMsg);
+	}
+	FString SerializeCurrentVersionInfo;
+	UFlibPatchParserHelper::SerializeHotPatcherVersionToString(CurrentVersion, SerializeCurrentVersionInfo);
+
+	FString SaveCurrentVersionToFile = FPaths::Combine(
+		CurrentVersionSavePath,
+		FString::Printf(TEXT("%s_Release.json"), *CurrentVersion.VersionId)
+	);
+	bool bSaveStatus = ExportPatchSetting->IsCompressVersionFiles() ?
+		UFLibAssetManageHelperEx::SaveStringToCompressedFile(SaveCurrentVersionToFile, SerializeCurrentVersionInfo, ExportPatchSetting->GetVersionFilesCompressionFormat()) :
+		UFLibAssetManageHelperEx::SaveStringToFile(SaveCurrentVersionToFile, SerializeCurrentVersionInfo);
+	if (bSaveStatus)
+	{
+		auto Msg = LOCTEXT("SavePatchDiffInfo", "Succeed to export New Release Info.");
+		NotifyFileSaved(Msg, SaveCurrentVersionToFile);
+	}
+	return true;
+}
+
+bool FExportPatchPipeline::DoSavePakFilesInfo()
+{
+	// serialize all pak file info
+	{
+		FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch", "ExportPatchPakFileInfo", "Generating All Platform Pak info of version {0}"), FText::FromString(CurrentVersion.VersionId));
+		EnterProgressFrame(1.0, DiaLogMsg);
+	}
+	FString PakFilesInfoStr;
+	UFlibPatchParserHelper::SerializePlatformPakInfoToString(PakFilesInfoMap, PakFilesInfoStr);
+
+	if (!PakFilesInfoStr.IsEmpty())
+	{
+		FString SavePakFilesPath = FPaths::Combine(
+			CurrentVersionSavePath,
+			FString::Printf(TEXT("%s_PakFilesInfo.json"), *CurrentVersion.VersionId)
+		);
+		if (UFLibAssetManageHelperEx::SaveStringToFile(SavePakFilesPath, PakFilesInfoStr) && FPaths::FileExists(SavePakFilesPath))
+		{
+			FText Msg = LOCTEXT("SavedPakFileMsg", "Successd to Export the Pak File info.");
+			NotifyFileSaved(Msg, SavePakFilesPath);
+		}
+	}
+	return true;
+}
+
+bool FExportPatchPipeline::DoSavePatchConfig()
+{
+	// serialize patch config
+	{
+		FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch", "ExportPatchConfig", "Generating Current Patch Config of version {0}"), FText::FromString(CurrentVersion.VersionId));
+		EnterProgressFrame(1.0, DiaLogMsg);
+	}
+
+	FString SaveConfigPath = FPaths::Combine(
+		CurrentVersionSavePath,
+		FString::Printf(TEXT("%s_PatchConfig.json"),*CurrentVersion.VersionId)
+	);
+
+	if (ExportPatchSetting->IsSavePatchConfig())
+	{
+		FString SerializedJsonStr;
+		ExportPatchSetting->SerializePatchConfigToString(SerializedJsonStr);
+
+		if (FFileHelper::SaveStringToFile(SerializedJsonStr, *SaveConfigPath))
+		{
+			FText Msg = LOCTEXT("SavedPatchConfigMas", "Successd to Export the Patch Config.");
+			NotifyFileSaved(Msg, SaveConfigPath);
+		}
+	}
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,99 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "ExportPatchSettings.h"
+#include "FHotPatcherVersion.h"
+#include "FPakFileInfo.h"
+#include "FPakVersion.h"
+#include "FHotPatcherAssetSnapshot.h"
+#include "ThreadUtils/FHotPatcherPipeline.hpp"
+
+// engine header
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+
+/**
+ * Export the patch off the game thread,the stages run as a DAG:
+ * analysis -> validation -> pakversion,pakorder -> pak of all platforms -> delta,pak files info
+ *                        -> diff,release,patch config manifests
+ * Only the analysis and the pak order of map dependencies access the asset registry and run in the game thread.
+ * If the asset snapshot is given,the analysis runs on it in the background,used by the batch export.
+ */
+class FExportPatchPipeline : public FHotPatcherPipeline
+{
+public:
+	// the settings is the rooted default object,it's kept alive while exporting
+	explicit FExportPatchPipeline(UExportPatchSettings* InExportPatchSetting, TSharedPtr<const FHotPatcherAssetSnapshot, ESPMode::ThreadSafe> InAssetSnapshot = nullptr);
+
+	// the UnrealPak process num is shared by the pipelines of batch,must be called before start
+	FORCEINLINE void SetSharedPakProcCounter(TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> InSharedPakProcCounter) { SharedPakProcCounter = InSharedPakProcCounter; }
+
+	static float GetAmountOfWork(const UExportPatchSettings* InExportPatchSetting);
+
+protected:
+	// profile the stages,saved as <VersionId>_BuildProfile.json in the version save dir
+	virtual void OnStart()override;
+	virtual void OnFinish(bool bInSuccessed)override;
+
+	// a chunk of the platform pak,e.g. 001_P,002_P...
+	struct FPakChunkJob
+	{
+		FString JobName;
+		FString PlatformName;
+		FString ChunkPostfix;
+		FString PakFile;
+		FString PakListFile;
+		FString PakOrderFile;
+		TArray<FString> PakCommands;
+		// empty if fingerprint is disabled
+		FString Fingerprint;
+		bool bUpToDate = false;
+		// the progress of the platform is shared by all chunks
+		float Progress;
+		// filled by the in process pak writer,needn't hash the pak again
+		FPakFileInfo PakFileInfo;
+		bool bHasPakFileInfo = false;
+		// the pak list is streamed to file,PakCommands is empty
+		bool bPakListSaved = false;
+	};
+
+	bool DoAnalysis();
+	bool DoValidation();
+	bool DoSavePakVersion();
+	bool DoPakOrder();
+	bool DoPak();
+	bool DoDelta();
+	bool DoSaveDiff();
+	bool DoSaveRelease();
+	bool DoSavePakFilesInfo();
+	bool DoSavePatchConfig();
+
+	// the notification is created in the game thread
+	void NotifyFileSaved(const FText& InMsg, const FString& InSavedFile)const;
+
+private:
+	UExportPatchSettings* ExportPatchSetting;
+	TSharedPtr<const FHotPatcherAssetSnapshot, ESPMode::ThreadSafe> AssetSnapshot;
+	TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> SharedPakProcCounter;
+
+	FHotPatcherVersion BaseVersion;
+	FHotPatcherVersion CurrentVersion;
+	FString CurrentVersionSavePath;
+
+	FAssetDependenciesInfo AddAssetDependInfo;
+	FAssetDependenciesInfo ModifyAssetDependInfo;
+	FAssetDependenciesInfo DeleteAssetDependInfo;
+	FAssetDependenciesInfo AllChangedAssetInfo;
+
+	TArray<FExternAssetFileInfo> AddExternalFiles;
+	TArray<FExternAssetFileInfo> ModifyExternalFiles;
+	TArray<FExternAssetFileInfo> DeleteExternalFiles;
+	TArray<FExternAssetFileInfo> AllChangedExternalFiles;
+
+	FPakVersion PakVersion;
+	// computed by the PakOrder stage,only read by DoPak
+	TMap<FString, int32> PakOrderMap;
+	TArray<FPakChunkJob> PakChunkJobs;
+	TMap<FString, TArray<FPakFileInfo>> PakFilesInfoMap;
+	int32 ProfileHandle;
+};
@@ -0,0 +1,132 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "FExportReleasePipeline.h"
+#include "FlibHotPatcherEditorHelper.h"
+#include "FlibPatchParserHelper.h"
+#include "FLibAssetManageHelperEx.h"
+#include "FHotPatcherProfiler.h"
+
+#define LOCTEXT_NAMESPACE "SHotPatcherExportRelease"
+
+FExportReleasePipeline::FExportReleasePipeline(UExportReleaseSettings* InExportReleaseSetting)
+	: FHotPatcherPipeline(2.f),
+	ExportReleaseSetting(InExportReleaseSetting),
+	ProfileHandle(0)
+{
+	// the asset registry is only accessed in the game thread
+	AddStage(TEXT("Analysis"), true, [this]() { return DoAnalysis(); });
+	AddStage(TEXT("Manifests"), false, [this]() { return DoManifests(); });
+}
+
+void FExportReleasePipeline::NotifyFileSaved(const FText& InMsg, const FString& InSavedFile)const
+{
+	FHotPatcherPipeline::RunOnGameThread([InMsg, InSavedFile]()
+	{
+		UFlibHotPatcherEditorHelper::CreateSaveFileNotify(InMsg, InSavedFile);
+	});
+}
+
+void FExportReleasePipeline::OnStart()
+{
+	ProfileHandle = FHotPatcherProfiler::BeginProfile(FString::Printf(TEXT("ExportRelease %s"), *ExportReleaseSetting->GetVersionId()));
+}
+
+void FExportReleasePipeline::OnFinish(bool bInSuccessed)
+{
+	FString SaveVersionDir = FPaths::Combine(ExportReleaseSetting->GetSavePath(), ExportReleaseSetting->GetVersionId());
+	FString SaveProfileFile = FPaths::Combine(SaveVersionDir, FString::Printf(TEXT("%s_BuildProfile.json"), *ExportReleaseSetting->GetVersionId()));
+	FHotPatcherProfiler::EndProfile(ProfileHandle, FPaths::DirectoryExists(SaveVersionDir) ? SaveProfileFile : FString{});
+	// delete the spilled files
+	PartitionedAnalysis.Reset();
+}
+
+bool FExportReleasePipeline::DoAnalysis()
+{
+	EnterProgressFrame(1.0, FText::Format(LOCTEXT("ExportReleaseAnalysis", "Analysis the assets of version {0}"), FText::FromString(ExportReleaseSetting->GetVersionId())));
+	if (ExportReleaseSetting->IsMemoryBoundedAnalysis())
+	{
+		FString SpillDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HotPatcher/Spill"), ExportReleaseSetting->GetVersionId());
+		PartitionedAnalysis = MakeUnique<FPartitionedReleaseAnalysis>(FPaths::ConvertRelativePathToFull(SpillDir), ExportReleaseSetting->GetAnalysisMemoryBudget());
+		return PartitionedAnalysis->Analysis(
+			ExportReleaseSetting->GetVersionId(),
+			TEXT(""),
+			FDateTime::UtcNow().ToString(),
+			ExportReleaseSetting->GetAssetIncludeFilters(),
+			ExportReleaseSetting->GetAssetIgnoreFilters(),
+			ExportReleaseSetting->GetSpecifyAssets(),
+			ExportReleaseSetting->GetAllExternFiles(true),
+			ExportReleaseSetting->IsIncludeHasRefAssetsOnly()
+		);
+	}
+	ExportVersion = UFlibHotPatcherEditorHelper::ExportReleaseVersionInfo(
+		ExportReleaseSetting->GetVersionId(),
+		TEXT(""),
+		FDateTime::UtcNow().ToString(),
+		ExportReleaseSetting->GetAssetIncludeFilters(),
+		ExportReleaseSetting->GetAssetIgnoreFilters(),
+		ExportReleaseSetting->GetSpecifyAssets(),
+		ExportReleaseSetting->GetAllExternFiles(true),
+		ExportReleaseSetting->IsIncludeHasRefAssetsOnly()
+	);
+	return true;
+}
+
+bool FExportReleasePipeline::DoManifests()
+{
+	EnterProgressFrame(1.0, FText::Format(LOCTEXT("ExportReleaseManifests", "Saving the release of version {0}"), FText::FromString(ExportReleaseSetting->GetVersionId())));
+	FString SaveVersionDir = FPaths::Combine(ExportReleaseSetting->GetSavePath(), ExportReleaseSetting->GetVersionId());
+
+	bool bRunStatus = true;
+	if (PartitionedAnalysis.IsValid())
+	{
+		FString SaveToFile = FPaths::Combine(
+			SaveVersionDir,
+			FString::Printf(TEXT("%s_Release.json"), *ExportReleaseSetting->GetVersionId())
+		);
+		bool runState = PartitionedAnalysis->SaveRelease(SaveToFile, ExportReleaseSetting->IsCompressVersionFiles() ? ExportReleaseSetting->GetVersionFilesCompressionFormat() : NAME_None);
+		if (runState)
+		{
+			auto Message = LOCTEXT("ExportReleaseSuccessNotification", "Succeed to export HotPatcher Release Version.");
+			NotifyFileSaved(Message, SaveToFile);
+		}
+		bRunStatus = runState && bRunStatus;
+		UE_LOG(LogTemp, Log, TEXT("HotPatcher Export RELEASE is %s."), runState ? TEXT("Success") : TEXT("FAILD"));
+	}
+	FString SaveToJson;
+	if (!PartitionedAnalysis.IsValid() && UFlibPatchParserHelper::SerializeHotPatcherVersionToString(ExportVersion, SaveToJson))
+	{
+		FString SaveToFile = FPaths::Combine(
+			SaveVersionDir,
+			FString::Printf(TEXT("%s_Release.json"), *ExportReleaseSetting->GetVersionId())
+		);
+		bool runState = ExportReleaseSetting->IsCompressVersionFiles() ?
+			UFLibAssetManageHelperEx::SaveStringToCompressedFile(SaveToFile, SaveToJson, ExportReleaseSetting->GetVersionFilesCompressionFormat()) :
+			UFLibAssetManageHelperEx::SaveStringToFile(SaveToFile,SaveToJson);
+		if (runState)
+		{
+			auto Message = LOCTEXT("ExportReleaseSuccessNotification", "Succeed to export HotPatcher Release Version.");
+			NotifyFileSaved(Message, SaveToFile);
+		}
+		bRunStatus = runState && bRunStatus;
+		UE_LOG(LogTemp, Log, TEXT("HotPatcher Export RELEASE is %s."), runState ? TEXT("Success") : TEXT("FAILD"));
+	}
+	FString ConfigJson;
+	if (ExportReleaseSetting->SerializeReleaseConfigToString(ConfigJson))
+	{
+		FString SaveToFile = FPaths::Combine(
+			SaveVersionDir,
+			FString::Printf(TEXT("%s_ReleaseConfig.json"), *ExportReleaseSetting->GetVersionId())
+		);
+		bool runState = UFLibAssetManageHelperEx::SaveStringToFile(SaveToFile, ConfigJson);
+		if (runState)
+		{
+			auto Message = LOCTEXT("ExportReleaseConfigSuccessNotification", "Succeed to export HotPatcher Release Config.");
+			NotifyFileSaved(Message, SaveToFile);
+		}
+		bRunStatus = runState && bRunStatus;
+		UE_LOG(LogTemp, Log, TEXT("HotPatcher Export RELEASE CONFIG is %s."), runState ? TEXT("Success") : TEXT("FAILD"));
+	}
+	return bRunStatus;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,39 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "ExportReleaseSettings.h"
+#include "FHotPatcherVersion.h"
+#include "FPartitionedReleaseAnalysis.h"
+#include "ThreadUtils/FHotPatcherPipeline.hpp"
+
+// engine header
+#include "CoreMinimal.h"
+
+/**
+ * Export the release version: analysis in the game thread -> save the release and config in the background.
+ * If the memory bounded analysis is enabled,the assets are spilled to Saved/HotPatcher/Spill and the release is streamed from them.
+ */
+class FExportReleasePipeline : public FHotPatcherPipeline
+{
+public:
+	// the settings must be kept alive while exporting
+	explicit FExportReleasePipeline(UExportReleaseSettings* InExportReleaseSetting);
+
+protected:
+	// profile the stages,saved as <VersionId>_BuildProfile.json in the version save dir
+	virtual void OnStart()override;
+	virtual void OnFinish(bool bInSuccessed)override;
+
+	bool DoAnalysis();
+	bool DoManifests();
+
+	// the notification is created in the game thread
+	void NotifyFileSaved(const FText& InMsg, const FString& InSavedFile)const;
+
+private:
+	UExportReleaseSettings* ExportReleaseSetting;
+	FHotPatcherVersion ExportVersion;
+	// valid if the memory bounded analysis is enabled,the ExportVersion is not used
+	TUniquePtr<FPartitionedReleaseAnalysis> PartitionedAnalysis;
+	int32 ProfileHandle;
+};
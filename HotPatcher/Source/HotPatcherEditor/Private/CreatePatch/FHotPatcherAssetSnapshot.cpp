@@ -0,0 +1,283 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "FHotPatcherAssetSnapshot.h"
+#include "FlibHotPatcherEditorHelper.h"
+#include "FLibAssetManageHelperEx.h"
+#include "FAssetRegistryChangeTracker.h"
+
+// engine header
+#include "HAL/PlatformTime.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+void FHotPatcherAssetSnapshot::Capture()
+{
+	check(IsInGameThread());
+	double BeginTime = FPlatformTime::Seconds();
+	Packages.Reset();
+
+	FAssetRegistryChangeTracker::Get().RefreshAssetManagerDatabase();
+	const IAssetRegistryQuery& AssetRegistry = IAssetRegistryQuery::Get();
+
+	// all assets on disk,the first asset of the package is used
+	TArray<FName> PendingPackages;
+	{
+		TArray<FAssetData> AllAssetData;
+		AssetRegistry.GetAllAssets(AllAssetData, true);
+		for (const auto& AssetData : AllAssetData)
+		{
+			if (!AssetData.IsValid() || Packages.Contains(AssetData.PackageName))
+				continue;
+			FSnapshotPackage& Package = Packages.Add(AssetData.PackageName);
+			CapturePackage(AssetData.PackageName, AssetData, Package);
+			Package.bIsOnDisk = true;
+			PendingPackages.Add(AssetData.PackageName);
+		}
+	}
+
+	CaptureDependencies(PendingPackages, nullptr);
+
+	// used by the has ref assets only filter
+	for (auto& Package : Packages)
+	{
+		CaptureReferencers(Package.Key, Package.Value);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Capture %d packages of asset registry,take %.2fs."), Packages.Num(), FPlatformTime::Seconds() - BeginTime);
+}
+
+void FHotPatcherAssetSnapshot::UpdatePackages(const TSet<FName>& InChangedPackages)
+{
+	check(IsInGameThread());
+	if (!InChangedPackages.Num())
+		return;
+	double BeginTime = FPlatformTime::Seconds();
+	const IAssetRegistryQuery& AssetRegistry = IAssetRegistryQuery::Get();
+
+	// the referencers of the old and new dependencies may be changed too
+	TSet<FName> AffectedPackages;
+	TArray<FName> PendingPackages;
+	for (const auto& PackageName : InChangedPackages)
+	{
+		FSnapshotPackage& Package = Packages.FindOrAdd(PackageName);
+		AffectedPackages.Append(Package.Dependencies);
+		AffectedPackages.Add(PackageName);
+		Package = FSnapshotPackage();
+
+		TArray<FAssetData> AssetData;
+		AssetRegistry.GetAssetsByPackageName(PackageName, AssetData, true);
+		// deleted or renamed,keep it as the missing dependency of the referencers
+		if (!AssetData.Num() || !AssetData[0].IsValid())
+			continue;
+		CapturePackage(PackageName, AssetData[0], Package);
+		Package.bIsOnDisk = true;
+		PendingPackages.Add(PackageName);
+	}
+
+	CaptureDependencies(PendingPackages, &AffectedPackages);
+
+	for (const auto& PackageName : AffectedPackages)
+	{
+		if (FSnapshotPackage* Package = Packages.Find(PackageName))
+		{
+			CaptureReferencers(PackageName, *Package);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Update %d changed packages of asset snapshot,take %.3fs."), InChangedPackages.Num(), FPlatformTime::Seconds() - BeginTime);
+}
+
+void FHotPatcherAssetSnapshot::CapturePackage(FName InPackageName, const FAssetData& InAssetData, FSnapshotPackage& OutPackage)
+{
+	const IAssetRegistryQuery& AssetRegistry = IAssetRegistryQuery::Get();
+	OutPackage.AssetData = InAssetData;
+	const FAssetPackageData* PackageData = AssetRegistry.GetAssetPackageData(InPackageName);
+	OutPackage.bHasPackageData = PackageData != nullptr;
+	if (PackageData)
+	{
+		OutPackage.PackageData = *PackageData;
+	}
+}
+
+void FHotPatcherAssetSnapshot::CaptureDependencies(TArray<FName>& InOutPendingPackages, TSet<FName>* OutDependencies)
+{
+	const IAssetRegistryQuery& AssetRegistry = IAssetRegistryQuery::Get();
+
+	// the dependencies,e.g. /Script/Engine,are captured too
+	while (InOutPendingPackages.Num())
+	{
+		FName PackageName = InOutPendingPackages.Pop(false);
+		TArray<FName> Dependencies;
+		AssetRegistry.GetDependencies(PackageName, Dependencies);
+		for (const auto& Dependency : Dependencies)
+		{
+			if (OutDependencies)
+			{
+				OutDependencies->Add(Dependency);
+			}
+			if (Packages.Contains(Dependency))
+				continue;
+			FSnapshotPackage& DependencyPackage = Packages.Add(Dependency);
+			FString LongPackageName = Dependency.ToString();
+			DependencyPackage.bIsOnDisk = AssetRegistry.DoesPackageExist(LongPackageName);
+			FString PackagePath;
+			UFLibAssetManageHelperEx::ConvLongPackageNameToPackagePath(LongPackageName, PackagePath);
+			FAssetData AssetData;
+			if (AssetRegistry.GetAssetByObjectPath(*PackagePath, AssetData))
+			{
+				CapturePackage(Dependency, AssetData, DependencyPackage);
+			}
+			InOutPendingPackages.Add(Dependency);
+		}
+		Packages.FindChecked(PackageName).Dependencies = MoveTemp(Dependencies);
+	}
+}
+
+void FHotPatcherAssetSnapshot::CaptureReferencers(FName InPackageName, FSnapshotPackage& InOutPackage)
+{
+	InOutPackage.Referencers.Reset();
+	if (!InOutPackage.bIsOnDisk)
+		return;
+	IAssetRegistryQuery::Get().GetReferencers(InPackageName, InOutPackage.Referencers);
+}
+
+FHotPatcherVersion FHotPatcherAssetSnapshot::ExportReleaseVersionInfo(
+	const FString& InVersionId,
+	const FString& InBaseVersion,
+	const FString& InDate,
+	const TArray<FString>& InIncludeFilter,
+	const TArray<FString>& InIgnoreFilter,
+	const TArray<FPatcherSpecifyAsset>& InIncludeSpecifyAsset,
+	const TArray<FExternAssetFileInfo>& InAllExternFiles,
+	bool InIncludeHasRefAssetsOnly
+)const
+{
+	// the analysis of this thread queries the snapshot,same as the normal export
+	FScopedThreadAssetRegistryQuery ScopedAssetRegistryQuery(*this);
+	return UFlibHotPatcherEditorHelper::ExportReleaseVersionInfo(
+		InVersionId,
+		InBaseVersion,
+		InDate,
+		InIncludeFilter,
+		InIgnoreFilter,
+		InIncludeSpecifyAsset,
+		InAllExternFiles,
+		InIncludeHasRefAssetsOnly
+	);
+}
+
+void FHotPatcherAssetSnapshot::GetAssetsList(const TArray<FString>& InFilterPackagePaths, TArray<FAssetDetail>& OutAssetList)const
+{
+	FScopedThreadAssetRegistryQuery ScopedAssetRegistryQuery(*this);
+	UFLibAssetManageHelperEx::GetAssetsList(InFilterPackagePaths, OutAssetList);
+}
+
+bool FHotPatcherAssetSnapshot::GetAllAssets(TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const
+{
+	for (const auto& Package : Packages)
+	{
+		if (Package.Value.AssetData.IsValid() && (Package.Value.bIsOnDisk || !bIncludeOnlyOnDiskAssets))
+		{
+			OutAssetData.Add(Package.Value.AssetData);
+		}
+	}
+	return true;
+}
+
+bool FHotPatcherAssetSnapshot::GetAssets(const FARFilter& InFilter, TArray<FAssetData>& OutAssetData)const
+{
+	for (const auto& Package : Packages)
+	{
+		const FSnapshotPackage& SnapshotPackage = Package.Value;
+		if (!SnapshotPackage.AssetData.IsValid() || (InFilter.bIncludeOnlyOnDiskAssets && !SnapshotPackage.bIsOnDisk))
+			continue;
+		if (IsFilterMatched(InFilter, SnapshotPackage.AssetData))
+		{
+			OutAssetData.Add(SnapshotPackage.AssetData);
+		}
+	}
+	return true;
+}
+
+bool FHotPatcherAssetSnapshot::GetAssetsByPackageName(FName InPackageName, TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const
+{
+	const FSnapshotPackage* Package = Packages.Find(InPackageName);
+	if (Package && Package->AssetData.IsValid() && (Package->bIsOnDisk || !bIncludeOnlyOnDiskAssets))
+	{
+		OutAssetData.Add(Package->AssetData);
+	}
+	return true;
+}
+
+bool FHotPatcherAssetSnapshot::GetAssetByObjectPath(FName InObjectPath, FAssetData& OutAssetData)const
+{
+	const FSnapshotPackage* Package = Packages.Find(*FPackageName::ObjectPathToPackageName(InObjectPath.ToString()));
+	if (!Package || !Package->AssetData.IsValid() || Package->AssetData.ObjectPath != InObjectPath)
+		return false;
+	OutAssetData = Package->AssetData;
+	return true;
+}
+
+bool FHotPatcherAssetSnapshot::GetDependencies(FName InPackageName, TArray<FName>& OutDependencies)const
+{
+	const FSnapshotPackage* Package = Packages.Find(InPackageName);
+	if (!Package)
+		return false;
+	OutDependencies.Append(Package->Dependencies);
+	return true;
+}
+
+bool FHotPatcherAssetSnapshot::GetReferencers(FName InPackageName, TArray<FName>& OutReferencers)const
+{
+	const FSnapshotPackage* Package = Packages.Find(InPackageName);
+	if (!Package)
+		return false;
+	OutReferencers.Append(Package->Referencers);
+	return true;
+}
+
+const FAssetPackageData* FHotPatcherAssetSnapshot::GetAssetPackageData(FName InPackageName)const
+{
+	const FSnapshotPackage* Package = Packages.Find(InPackageName);
+	return Package && Package->bHasPackageData ? &Package->PackageData : nullptr;
+}
+
+bool FHotPatcherAssetSnapshot::DoesPackageExist(const FString& InLongPackageName)const
+{
+	const FSnapshotPackage* Package = Packages.Find(FName(*InLongPackageName, FNAME_Find));
+	return Package && Package->bIsOnDisk;
+}
+
+void FHotPatcherAssetSnapshot::GetSubPaths(const FString& InBasePath, TArray<FString>& OutPathList, bool bInRecurse)const
+{
+	FString BasePath = InBasePath;
+	BasePath.RemoveFromEnd(TEXT("/"));
+	BasePath += TEXT("/");
+
+	TSet<FString> SubPaths;
+	for (const auto& Package : Packages)
+	{
+		if (!Package.Value.AssetData.IsValid())
+			continue;
+		// all parent directories of the package under the base path
+		FString PackagePath = Package.Value.AssetData.PackagePath.ToString();
+		while (PackagePath.StartsWith(BasePath))
+		{
+			if (bInRecurse || PackagePath.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, BasePath.Len()) == INDEX_NONE)
+			{
+				SubPaths.Add(PackagePath);
+			}
+			PackagePath = FPaths::GetPath(PackagePath);
+		}
+	}
+	OutPathList.Append(SubPaths.Array());
+}
+
+void FHotPatcherAssetSnapshot::EnumeratePackagesInPath(FName InPackagePath, TFunctionRef<bool(FName)> InFunc)const
+{
+	for (const auto& Package : Packages)
+	{
+		if (Package.Value.bIsOnDisk && Package.Value.AssetData.PackagePath == InPackagePath && !InFunc(Package.Key))
+			return;
+	}
+}
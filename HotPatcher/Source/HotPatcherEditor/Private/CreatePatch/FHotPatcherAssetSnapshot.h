@@ -0,0 +1,90 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+#include "FHotPatcherVersion.h"
+#include "FPatcherSpecifyAsset.h"
+#include "FExternAssetFileInfo.h"
+#include "AssetManager/FAssetDetail.h"
+#include "AssetManager/FAssetDependenciesInfo.h"
+#include "IAssetRegistryQuery.h"
+
+// engine header
+#include "CoreMinimal.h"
+#include "AssetData.h"
+#include "AssetRegistryState.h"
+
+/**
+ * The asset registry data captured once in the game thread.
+ * It's a query of the asset registry,the versions of many patch configs are analysed on it concurrently by the helpers of normal export,
+ * the asset registry is not accessed again.
+ */
+class FHotPatcherAssetSnapshot : public IAssetRegistryQuery
+{
+public:
+	struct FSnapshotPackage
+	{
+		// the first asset of package,invalid if the package has no asset,e.g. /Script/Engine
+		FAssetData AssetData;
+		// valid if bHasPackageData
+		FAssetPackageData PackageData;
+		TArray<FName> Dependencies;
+		// captured for the packages on disk,used by the has ref assets only filter
+		TArray<FName> Referencers;
+		bool bHasPackageData = false;
+		bool bIsOnDisk = false;
+	};
+
+	// refresh the asset registry and capture all assets,must be called in the game thread
+	void Capture();
+	// recapture the changed packages and their new dependencies,the referencers of the affected packages are updated,must be called in the game thread
+	void UpdatePackages(const TSet<FName>& InChangedPackages);
+
+	// UFlibHotPatcherEditorHelper::ExportReleaseVersionInfo on the snapshot,thread safe
+	FHotPatcherVersion ExportReleaseVersionInfo(
+		const FString& InVersionId,
+		const FString& InBaseVersion,
+		const FString& InDate,
+		const TArray<FString>& InIncludeFilter,
+		const TArray<FString>& InIgnoreFilter,
+		const TArray<FPatcherSpecifyAsset>& InIncludeSpecifyAsset,
+		const TArray<FExternAssetFileInfo>& InAllExternFiles,
+		bool InIncludeHasRefAssetsOnly
+	)const;
+	// UFLibAssetManageHelperEx::GetAssetsList on the snapshot,thread safe
+	void GetAssetsList(const TArray<FString>& InFilterPackagePaths, TArray<FAssetDetail>& OutAssetList)const;
+
+	FORCEINLINE int32 GetPackageNum()const { return Packages.Num(); }
+	// add a package without the asset registry,used by the synthetic benchmark
+	FORCEINLINE void AddPackage(FName InLongPackageName, const FSnapshotPackage& InPackage) { Packages.Add(InLongPackageName, InPackage); }
+	FORCEINLINE void ForEachPackage(TFunctionRef<void(FName, const FSnapshotPackage&)> InFunc)const
+	{
+		for (const auto& Package : Packages)
+		{
+			InFunc(Package.Key, Package.Value);
+		}
+	}
+
+	// IAssetRegistryQuery,only the first asset of package is captured
+	virtual bool GetAllAssets(TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const override;
+	virtual bool GetAssets(const FARFilter& InFilter, TArray<FAssetData>& OutAssetData)const override;
+	virtual bool GetAssetsByPackageName(FName InPackageName, TArray<FAssetData>& OutAssetData, bool bIncludeOnlyOnDiskAssets)const override;
+	virtual bool GetAssetByObjectPath(FName InObjectPath, FAssetData& OutAssetData)const override;
+	virtual bool GetDependencies(FName InPackageName, TArray<FName>& OutDependencies)const override;
+	virtual bool GetReferencers(FName InPackageName, TArray<FName>& OutReferencers)const override;
+	virtual const FAssetPackageData* GetAssetPackageData(FName InPackageName)const override;
+	virtual bool DoesPackageExist(const FString& InLongPackageName)const override;
+	virtual void GetSubPaths(const FString& InBasePath, TArray<FString>& OutPathList, bool bInRecurse)const override;
+	virtual void EnumeratePackagesInPath(FName InPackagePath, TFunctionRef<bool(FName)> InFunc)const override;
+	// the snapshot is updated by UpdatePackages
+	virtual void ScanModifiedFiles(const TArray<FString>& InFiles)const override {}
+
+protected:
+	static void CapturePackage(FName InPackageName, const FAssetData& InAssetData, FSnapshotPackage& OutPackage);
+	// capture the dependencies of the pending packages recursively,the direct dependencies are added to OutDependencies if given
+	void CaptureDependencies(TArray<FName>& InOutPendingPackages, TSet<FName>* OutDependencies);
+	static void CaptureReferencers(FName InPackageName, FSnapshotPackage& InOutPackage);
+
+private:
+	// key is the long package name
+	TMap<FName, FSnapshotPackage> Packages;
+};
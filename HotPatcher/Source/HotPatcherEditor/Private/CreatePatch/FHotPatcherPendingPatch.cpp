@@ -0,0 +1,192 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "FHotPatcherPendingPatch.h"
+#include "FlibPatchParserHelper.h"
+#include "FLibAssetManageHelperEx.h"
+#include "FAssetRegistryChangeTracker.h"
+#include "HotPatcherTrace.h"
+
+// engine header
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+FHotPatcherPendingPatch::FHotPatcherPendingPatch()
+{
+	PackageChangedHandle = FAssetRegistryChangeTracker::Get().OnPackageChanged().AddRaw(this, &FHotPatcherPendingPatch::OnPackageChanged);
+}
+
+FHotPatcherPendingPatch::~FHotPatcherPendingPatch()
+{
+	FAssetRegistryChangeTracker::Get().OnPackageChanged().Remove(PackageChangedHandle);
+}
+
+void FHotPatcherPendingPatch::Invalidate()
+{
+	AssetSnapshot.Reset();
+	PendingPackages.Empty();
+	bDiffOutdated = true;
+}
+
+void FHotPatcherPendingPatch::OnPackageChanged(FName InPackageName)
+{
+	// applied in the next update,the asset registry may not be updated in the event
+	if (AssetSnapshot.IsValid())
+	{
+		PendingPackages.Add(InPackageName);
+	}
+}
+
+bool FHotPatcherPendingPatch::Update(const UExportPatchSettings* InExportPatchSetting)
+{
+	HOTPATCHER_TRACE_SCOPE(UpdatePendingPatch);
+	check(IsInGameThread());
+	if (!InExportPatchSetting)
+		return false;
+	double BeginTime = FPlatformTime::Seconds();
+
+	if (!UpdateBaseVersion(InExportPatchSetting))
+		return false;
+	UpdateAssetSnapshot();
+	UpdateExternFiles(InExportPatchSetting);
+
+	FString CurrentSettingsSignature = GetSettingsSignature(InExportPatchSetting);
+	if (CurrentSettingsSignature != SettingsSignature)
+	{
+		SettingsSignature = CurrentSettingsSignature;
+		bDiffOutdated = true;
+	}
+	if (!bDiffOutdated)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Nothing changed since the last diff,the pending patch is reused."));
+		return true;
+	}
+
+	Diff.CurrentVersion = AssetSnapshot->ExportReleaseVersionInfo(
+		InExportPatchSetting->GetVersionId(),
+		Diff.BaseVersion.VersionId,
+		FDateTime::UtcNow().ToString(),
+		InExportPatchSetting->GetAssetIncludeFilters(),
+		InExportPatchSetting->GetAssetIgnoreFilters(),
+		InExportPatchSetting->GetIncludeSpecifyAssets(),
+		ExternFiles,
+		InExportPatchSetting->IsIncludeHasRefAssetsOnly()
+	);
+
+	Diff.AddAssetDependInfo = FAssetDependenciesInfo();
+	Diff.ModifyAssetDependInfo = FAssetDependenciesInfo();
+	Diff.DeleteAssetDependInfo = FAssetDependenciesInfo();
+	UFlibPatchParserHelper::DiffVersionAssets(
+		Diff.CurrentVersion.AssetInfo,
+		Diff.BaseVersion.AssetInfo,
+		Diff.AddAssetDependInfo,
+		Diff.ModifyAssetDependInfo,
+		Diff.DeleteAssetDependInfo
+	);
+	UFlibPatchParserHelper::DiffVersionExFiles(Diff.CurrentVersion, Diff.BaseVersion, Diff.AddExternalFiles, Diff.ModifyExternalFiles, Diff.DeleteExternalFiles);
+
+	bDiffOutdated = false;
+	UE_LOG(LogTemp, Log, TEXT("Update the pending patch,take %.3fs."), FPlatformTime::Seconds() - BeginTime);
+	return true;
+}
+
+bool FHotPatcherPendingPatch::UpdateAssetSnapshot()
+{
+	// the events are only broadcast while tracking,e.g. not in commandlet
+	if (!AssetSnapshot.IsValid() || !FAssetRegistryChangeTracker::Get().IsTracking())
+	{
+		AssetSnapshot = MakeUnique<FHotPatcherAssetSnapshot>();
+		AssetSnapshot->Capture();
+		PendingPackages.Empty();
+		bDiffOutdated = true;
+		return true;
+	}
+
+	// the files changed outside the editor are rescanned before recapture
+	FAssetRegistryChangeTracker::Get().ScanPendingFiles();
+	if (!PendingPackages.Num())
+		return false;
+
+	AssetSnapshot->UpdatePackages(PendingPackages);
+	PendingPackages.Empty();
+	bDiffOutdated = true;
+	return true;
+}
+
+bool FHotPatcherPendingPatch::UpdateBaseVersion(const UExportPatchSettings* InExportPatchSetting)
+{
+	if (!InExportPatchSetting->IsByBaseVersion())
+	{
+		if (!BaseVersionFile.IsEmpty())
+		{
+			BaseVersionFile.Empty();
+			Diff.BaseVersion = FHotPatcherVersion();
+			bDiffOutdated = true;
+		}
+		return true;
+	}
+
+	FString CurrentBaseVersionFile = FPaths::ConvertRelativePathToFull(InExportPatchSetting->GetBaseVersion());
+	FDateTime CurrentTimeStamp = IFileManager::Get().GetTimeStamp(*CurrentBaseVersionFile);
+	if (CurrentBaseVersionFile == BaseVersionFile && CurrentTimeStamp == BaseVersionTimeStamp)
+		return true;
+
+	FString BaseVersionContent;
+	FHotPatcherVersion BaseVersion;
+	if (!UFLibAssetManageHelperEx::LoadFileToString(CurrentBaseVersionFile, BaseVersionContent) ||
+		!UFlibPatchParserHelper::DeserializeHotPatcherVersionFromString(BaseVersionContent, BaseVersion))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Deserialize Base Version %s Faild!"), *CurrentBaseVersionFile);
+		BaseVersionFile.Empty();
+		return false;
+	}
+	Diff.BaseVersion = MoveTemp(BaseVersion);
+	BaseVersionFile = CurrentBaseVersionFile;
+	BaseVersionTimeStamp = CurrentTimeStamp;
+	bDiffOutdated = true;
+	return true;
+}
+
+bool FHotPatcherPendingPatch::UpdateExternFiles(const UExportPatchSettings* InExportPatchSetting)
+{
+	TArray<FExternAssetFileInfo> CurrentExternFiles = InExportPatchSetting->GetAllExternFiles(false);
+
+	// only the new or modified files are hashed again
+	IFileManager& FileManager = IFileManager::Get();
+	for (auto& ExFile : CurrentExternFiles)
+	{
+		FString FileAbsPath = FPaths::ConvertRelativePathToFull(ExFile.FilePath.FilePath);
+		FDateTime TimeStamp = FileManager.GetTimeStamp(*FileAbsPath);
+		int64 FileSize = FileManager.FileSize(*FileAbsPath);
+
+		FExternFileHash* CachedHash = ExternFileHashes.Find(FileAbsPath);
+		if (!CachedHash || CachedHash->TimeStamp != TimeStamp || CachedHash->FileSize != FileSize)
+		{
+			CachedHash = &ExternFileHashes.Add(FileAbsPath);
+			CachedHash->TimeStamp = TimeStamp;
+			CachedHash->FileSize = FileSize;
+			CachedHash->FileHash = ExFile.GetFileHash();
+		}
+		ExFile.FileHash = CachedHash->FileHash;
+	}
+
+	if (CurrentExternFiles == ExternFiles)
+		return false;
+	ExternFiles = MoveTemp(CurrentExternFiles);
+	bDiffOutdated = true;
+	return true;
+}
+
+FString FHotPatcherPendingPatch::GetSettingsSignature(const UExportPatchSettings* InExportPatchSetting)
+{
+	FString Signature = InExportPatchSetting->GetVersionId();
+	Signature += TEXT("|Include:") + FString::Join(InExportPatchSetting->GetAssetIncludeFilters(), TEXT(","));
+	Signature += TEXT("|Ignore:") + FString::Join(InExportPatchSetting->GetAssetIgnoreFilters(), TEXT(","));
+	Signature += TEXT("|Specify:");
+	for (const auto& SpecifyAsset : InExportPatchSetting->GetIncludeSpecifyAssets())
+	{
+		Signature += FString::Printf(TEXT("%s:%d,"), *SpecifyAsset.Asset.GetLongPackageName(), SpecifyAsset.bAnalysisAssetDependencies ? 1 : 0);
+	}
+	Signature += FString::Printf(TEXT("|HasRefOnly:%d"), InExportPatchSetting->IsIncludeHasRefAssetsOnly() ? 1 : 0);
+	return Signature;
+}
@@ -0,0 +1,80 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+#include "ExportPatchSettings.h"
+#include "FHotPatcherVersion.h"
+#include "FExternAssetFileInfo.h"
+#include "FHotPatcherAssetSnapshot.h"
+#include "AssetManager/FAssetDependenciesInfo.h"
+
+// engine header
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "Delegates/IDelegateInstance.h"
+
+// the difference of the current assets and the base version
+struct FHotPatcherPendingDiff
+{
+	FHotPatcherVersion BaseVersion;
+	FHotPatcherVersion CurrentVersion;
+
+	FAssetDependenciesInfo AddAssetDependInfo;
+	FAssetDependenciesInfo ModifyAssetDependInfo;
+	FAssetDependenciesInfo DeleteAssetDependInfo;
+
+	TArray<FExternAssetFileInfo> AddExternalFiles;
+	TArray<FExternAssetFileInfo> ModifyExternalFiles;
+	TArray<FExternAssetFileInfo> DeleteExternalFiles;
+};
+
+/**
+ * The pending patch of the export patch panel,it's kept up to date by the asset registry events.
+ * The asset registry is captured once,then only the changed packages are recaptured.
+ * The package files changed outside the editor(e.g. source control sync) are reported by the change tracker too,
+ * they are rescanned by the asset registry before the update.
+ * The base version and the hash of extern files are cached by the file timestamp,
+ * the diff is reused if no asset,file or setting changed since the last update.
+ */
+class FHotPatcherPendingPatch
+{
+public:
+	FHotPatcherPendingPatch();
+	~FHotPatcherPendingPatch();
+
+	// update the diff by the settings,must be called in the game thread
+	bool Update(const UExportPatchSettings* InExportPatchSetting);
+	FORCEINLINE const FHotPatcherPendingDiff& GetDiff()const { return Diff; }
+	// the changed packages not applied to the snapshot yet
+	FORCEINLINE int32 GetPendingPackageNum()const { return PendingPackages.Num(); }
+	// recapture the asset registry in the next update
+	void Invalidate();
+
+protected:
+	void OnPackageChanged(FName InPackageName);
+	bool UpdateAssetSnapshot();
+	bool UpdateBaseVersion(const UExportPatchSettings* InExportPatchSetting);
+	bool UpdateExternFiles(const UExportPatchSettings* InExportPatchSetting);
+	static FString GetSettingsSignature(const UExportPatchSettings* InExportPatchSetting);
+
+private:
+	TUniquePtr<FHotPatcherAssetSnapshot> AssetSnapshot;
+	TSet<FName> PendingPackages;
+	bool bDiffOutdated = true;
+
+	FString BaseVersionFile;
+	FDateTime BaseVersionTimeStamp;
+
+	struct FExternFileHash
+	{
+		FDateTime TimeStamp;
+		int64 FileSize = 0;
+		FString FileHash;
+	};
+	// key is the absolute path of file
+	TMap<FString, FExternFileHash> ExternFileHashes;
+	TArray<FExternAssetFileInfo> ExternFiles;
+
+	FString SettingsSignature;
+	FHotPatcherPendingDiff Diff;
+	FDelegateHandle PackageChangedHandle;
+};
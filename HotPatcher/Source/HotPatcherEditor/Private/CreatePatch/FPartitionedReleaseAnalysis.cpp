@@ -0,0 +1,402 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "FPartitionedReleaseAnalysis.h"
+#include "FLibAssetManageHelperEx.h"
+#include "IAssetRegistryQuery.h"
+#include "FHotPatcherProfiler.h"
+#include "HotPatcherTrace.h"
+
+// engine header
+#include "ARFilter.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+namespace PartitionedReleaseAnalysis
+{
+	typedef TJsonWriter<UTF8CHAR, TPrettyJsonPrintPolicy<UTF8CHAR>> FReleaseJsonWriter;
+
+	struct FSpilledAsset
+	{
+		FString LongPackageName;
+		FAssetDetail Detail;
+
+		friend FArchive& operator<<(FArchive& Ar, FSpilledAsset& InAsset)
+		{
+			return Ar << InAsset.LongPackageName << InAsset.Detail.mPackagePath << InAsset.Detail.mAssetType << InAsset.Detail.mGuid;
+		}
+	};
+
+	// read the spilled assets of module one by one
+	bool ForEachSpilledAsset(const FString& InSpillFile, TFunctionRef<void(const FSpilledAsset&)> InFunc)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InSpillFile));
+		if (!Reader)
+			return false;
+		FSpilledAsset Asset;
+		while (!Reader->AtEnd() && !Reader->IsError())
+		{
+			*Reader << Asset;
+			InFunc(Asset);
+		}
+		return !Reader->IsError();
+	}
+}
+
+FPartitionedReleaseAnalysis::FPartitionedReleaseAnalysis(const FString& InSpillDir, int64 InMemoryBudget)
+	: SpillDir(InSpillDir),
+	BatchAssetNum((int32)FMath::Clamp<int64>(InMemoryBudget * BatchBudgetPercent / 100 / EstimatedBytesPerAsset, 1, MAX_int32)),
+	VisitedPackages(FPaths::Combine(InSpillDir, TEXT("Visited.hashes")), (int32)FMath::Clamp<int64>(InMemoryBudget * (100 - BatchBudgetPercent) / 100 / FSpillablePackageSet::EstimatedBytesPerHash, 1, MAX_int32)),
+	AssetNum(0)
+{
+}
+
+FPartitionedReleaseAnalysis::~FPartitionedReleaseAnalysis()
+{
+	ModuleWriters.Empty();
+	VisitedPackages.Reset();
+	IFileManager::Get().DeleteDirectory(*SpillDir, false, true);
+}
+
+bool FPartitionedReleaseAnalysis::Analysis(
+	const FString& InVersionId,
+	const FString& InBaseVersion,
+	const FString& InDate,
+	const TArray<FString>& InIncludeFilter,
+	const TArray<FString>& InIgnoreFilter,
+	const TArray<FPatcherSpecifyAsset>& InIncludeSpecifyAsset,
+	const TArray<FExternAssetFileInfo>& InAllExternFiles,
+	bool InIncludeHasRefAssetsOnly
+)
+{
+	HOTPATCHER_SCOPED_TIMER(TEXT("PartitionedReleaseAnalysis"));
+	check(IsInGameThread());
+	VisitedPackages.Reset();
+	UnexpandedPackages.Reset();
+	IFileManager::Get().DeleteDirectory(*SpillDir, false, true);
+	IFileManager::Get().MakeDirectory(*SpillDir, true);
+
+	Version = FHotPatcherVersion{};
+	Version.VersionId = InVersionId;
+	Version.Date = InDate;
+	Version.BaseVersionId = InBaseVersion;
+	for (const auto& Filter : InIncludeFilter)
+	{
+		Version.IncludeFilter.AddUnique(Filter);
+	}
+	for (const auto& Filter : InIgnoreFilter)
+	{
+		Version.IgnoreFilter.AddUnique(Filter);
+	}
+	Version.bIncludeHasRefAssetsOnly = InIncludeHasRefAssetsOnly;
+	Version.IncludeSpecifyAssets = InIncludeSpecifyAsset;
+
+	const IAssetRegistryQuery& AssetRegistryQuery = IAssetRegistryQuery::Get();
+
+	// every directory of the include filters is a partition,the partitions are merged to batches
+	TArray<FAssetDetail> BatchAssets;
+	TArray<FName> PagePackages;
+	auto FlushBatch = [this, &BatchAssets, InIncludeHasRefAssetsOnly]()
+	{
+		if (InIncludeHasRefAssetsOnly)
+		{
+			TArray<FAssetDetail> HasRefAssets;
+			TArray<FAssetDetail> DontHasRefAssets;
+			UFLibAssetManageHelperEx::FilterNoRefAssetsWithIgnoreFilter(BatchAssets, Version.IgnoreFilter, HasRefAssets, DontHasRefAssets);
+			BatchAssets = MoveTemp(HasRefAssets);
+		}
+		AnalysisBatch(BatchAssets, true);
+		BatchAssets.Reset();
+	};
+
+	for (const auto& IncludeFilter : Version.IncludeFilter)
+	{
+		FString FilterPath = IncludeFilter;
+		while (FilterPath.EndsWith(TEXT("/")))
+		{
+			FilterPath.RemoveAt(FilterPath.Len() - 1);
+		}
+		TArray<FString> PartitionPaths{ FilterPath };
+		AssetRegistryQuery.GetSubPaths(FilterPath, PartitionPaths, true);
+
+		for (const auto& PartitionPath : PartitionPaths)
+		{
+			if (IsIgnored(PartitionPath + TEXT("/")))
+				continue;
+
+			// the assets of a huge directory are not got at once
+			AssetRegistryQuery.EnumeratePackagesInPath(*PartitionPath, [this, &PagePackages, &BatchAssets, &FlushBatch](FName InPackageName)->bool
+			{
+				if (VisitedPackages.Contains(InPackageName))
+					return true;
+				PagePackages.Add(InPackageName);
+				if (PagePackages.Num() >= BatchAssetNum)
+				{
+					AddPackagePage(PagePackages, BatchAssets);
+				}
+				if (BatchAssets.Num() >= BatchAssetNum)
+				{
+					FlushBatch();
+				}
+				return true;
+			});
+			AddPackagePage(PagePackages, BatchAssets);
+			if (BatchAssets.Num() >= BatchAssetNum)
+			{
+				FlushBatch();
+			}
+		}
+	}
+	FlushBatch();
+
+	// Specify Assets
+	for (const auto& SpecifyAsset : InIncludeSpecifyAsset)
+	{
+		FAssetDetail AssetDetail;
+		if (UFLibAssetManageHelperEx::GetSpecifyAssetDetail(SpecifyAsset.Asset.GetLongPackageName(), AssetDetail))
+		{
+			AnalysisBatch(TArray<FAssetDetail>{ AssetDetail }, SpecifyAsset.bAnalysisAssetDependencies);
+		}
+	}
+
+	for (const auto& File : InAllExternFiles)
+	{
+		if (!Version.ExternalFiles.Contains(File.FilePath.FilePath))
+		{
+			Version.ExternalFiles.Add(File.MountPath, File);
+		}
+	}
+
+	bool bRunStatus = true;
+	for (auto& ModuleWriter : ModuleWriters)
+	{
+		bRunStatus = ModuleWriter.Value->Close() && bRunStatus;
+	}
+	ModuleWriters.Empty();
+	UE_LOG(LogTemp, Log, TEXT("Partitioned analysis of %s found %lld assets in %d modules,%lld packages are visited."), *InVersionId, AssetNum, ModuleNames.Num(), VisitedPackages.Num());
+	return bRunStatus;
+}
+
+void FPartitionedReleaseAnalysis::AddPackagePage(TArray<FName>& InPackages, TArray<FAssetDetail>& OutBatchAssets)
+{
+	if (!InPackages.Num())
+		return;
+	FARFilter Filter;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+	Filter.PackageNames = MoveTemp(InPackages);
+	InPackages.Reset();
+	TArray<FAssetData> PageAssetData;
+	HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+	IAssetRegistryQuery::Get().GetAssets(Filter, PageAssetData);
+
+	for (const auto& AssetData : PageAssetData)
+	{
+		if (!AssetData.IsValid() || AssetData.IsRedirector())
+			continue;
+		FAssetDetail AssetDetail;
+		UFLibAssetManageHelperEx::ConvFAssetDataToFAssetDetail(AssetData, AssetDetail);
+		if (IsIgnored(AssetDetail.mPackagePath))
+			continue;
+		OutBatchAssets.Add(AssetDetail);
+	}
+}
+
+void FPartitionedReleaseAnalysis::AnalysisBatch(const TArray<FAssetDetail>& InAssets, bool bInAnalysisDepend)
+{
+	HOTPATCHER_TRACE_SCOPE(PartitionedAnalysisBatch);
+	const IAssetRegistryQuery& AssetRegistryQuery = IAssetRegistryQuery::Get();
+
+	TArray<FName> PendingPackages;
+	for (const auto& AssetDetail : InAssets)
+	{
+		FString LongPackageName;
+		if (!UFLibAssetManageHelperEx::ConvPackagePathToLongPackageName(AssetDetail.mPackagePath, LongPackageName))
+			continue;
+		FName PackageName(*LongPackageName);
+		if (VisitedPackages.Add(PackageName))
+		{
+			SpillAsset(LongPackageName, AssetDetail);
+		}
+		else if (!bInAnalysisDepend || !UnexpandedPackages.Remove(PackageName))
+		{
+			continue;
+		}
+
+		if (bInAnalysisDepend)
+		{
+			PendingPackages.Add(PackageName);
+		}
+		else
+		{
+			UnexpandedPackages.Add(PackageName);
+		}
+	}
+
+	// same as UFLibAssetManageHelperEx::GatherAssetDependicesInfoRecursively,the packages are visited only once
+	while (PendingPackages.Num())
+	{
+		FName PackageName = PendingPackages.Pop(false);
+		TArray<FName> Dependencies;
+		HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+		AssetRegistryQuery.GetDependencies(PackageName, Dependencies);
+		for (const auto& Dependency : Dependencies)
+		{
+			FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::AssetsVisited);
+			if (!VisitedPackages.Add(Dependency))
+			{
+				if (!UnexpandedPackages.Remove(Dependency))
+					continue;
+			}
+			else
+			{
+				FString LongPackageName = Dependency.ToString();
+				FString PackagePath;
+				UFLibAssetManageHelperEx::ConvLongPackageNameToPackagePath(LongPackageName, PackagePath);
+				FAssetData AssetData;
+				HOTPATCHER_TRACE_COUNT(AssetRegistryQueries);
+				if (AssetRegistryQuery.GetAssetByObjectPath(*PackagePath, AssetData) && AssetData.IsValid())
+				{
+					FAssetDetail AssetDetail;
+					AssetDetail.mPackagePath = PackagePath;
+					AssetDetail.mAssetType = AssetData.AssetClass.ToString();
+					UFLibAssetManageHelperEx::GetAssetPackageGUID(PackagePath, AssetDetail.mGuid);
+					SpillAsset(LongPackageName, AssetDetail);
+				}
+			}
+			PendingPackages.Add(Dependency);
+		}
+	}
+}
+
+void FPartitionedReleaseAnalysis::SpillAsset(const FString& InLongPackageName, const FAssetDetail& InAssetDetail)
+{
+	FString ModuleName = UFLibAssetManageHelperEx::GetAssetBelongModuleName(InLongPackageName);
+	TUniquePtr<FArchive>* ModuleWriter = ModuleWriters.Find(ModuleName);
+	if (!ModuleWriter)
+	{
+		ModuleNames.AddUnique(ModuleName);
+		FString SpillFile = FPaths::Combine(SpillDir, FString::Printf(TEXT("%d.spill"), ModuleNames.IndexOfByKey(ModuleName)));
+		ModuleWriter = &ModuleWriters.Add(ModuleName, TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*SpillFile)));
+	}
+	if (!ModuleWriter->IsValid())
+		return;
+
+	PartitionedReleaseAnalysis::FSpilledAsset Asset{ InLongPackageName, InAssetDetail };
+	**ModuleWriter << Asset;
+	++AssetNum;
+}
+
+bool FPartitionedReleaseAnalysis::IsIgnored(const FString& InPath)const
+{
+	for (const auto& IgnoreFilter : Version.IgnoreFilter)
+	{
+		if (InPath.StartsWith(IgnoreFilter))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FPartitionedReleaseAnalysis::SaveRelease(const FString& InFile, FName InCompressionFormat)const
+{
+	HOTPATCHER_SCOPED_TIMER(TEXT("SaveRelease"));
+	const bool bCompress = !InCompressionFormat.IsNone();
+	FString JsonFile = bCompress ? FPaths::Combine(SpillDir, TEXT("Release.json")) : InFile;
+	bool bRunStatus = false;
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*JsonFile));
+		if (!Writer)
+			return false;
+		bRunStatus = WriteRelease(*Writer);
+		FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesWritten, Writer->Tell());
+		bRunStatus = Writer->Close() && bRunStatus;
+	}
+	if (bRunStatus && bCompress)
+	{
+		bRunStatus = UFLibAssetManageHelperEx::SaveFileToCompressedFile(InFile, JsonFile, InCompressionFormat);
+		IFileManager::Get().Delete(*JsonFile);
+	}
+	return bRunStatus;
+}
+
+bool FPartitionedReleaseAnalysis::WriteRelease(FArchive& InWriter)const
+{
+	using namespace PartitionedReleaseAnalysis;
+	TSharedRef<FReleaseJsonWriter> JsonWriter = TJsonWriterFactory<UTF8CHAR, TPrettyJsonPrintPolicy<UTF8CHAR>>::Create(&InWriter);
+	auto WriteStringArray = [&JsonWriter](const FString& InIdentifier, const TArray<FString>& InValues)
+	{
+		JsonWriter->WriteArrayStart(InIdentifier);
+		for (const auto& Value : InValues)
+		{
+			JsonWriter->WriteValue(Value);
+		}
+		JsonWriter->WriteArrayEnd();
+	};
+
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("VersionId"), Version.VersionId);
+	JsonWriter->WriteValue(TEXT("BaseVersionId"), Version.BaseVersionId);
+	JsonWriter->WriteValue(TEXT("Date"), Version.Date);
+	WriteStringArray(TEXT("IncludeFilter"), Version.IncludeFilter);
+	WriteStringArray(TEXT("IgnoreFilter"), Version.IgnoreFilter);
+	JsonWriter->WriteValue(TEXT("bIncludeHasRefAssetsOnly"), Version.bIncludeHasRefAssetsOnly);
+	JsonWriter->WriteArrayStart(TEXT("IncludeSpecifyAssets"));
+	for (const auto& SpecifyAsset : Version.IncludeSpecifyAssets)
+	{
+		FString LongPackageName;
+		bool bConvStatus = UFLibAssetManageHelperEx::ConvPackagePathToLongPackageName(SpecifyAsset.Asset.ToString(), LongPackageName);
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("Asset"), bConvStatus ? LongPackageName : SpecifyAsset.Asset.ToString());
+		JsonWriter->WriteValue(TEXT("bAnalysisAssetDependencies"), SpecifyAsset.bAnalysisAssetDependencies);
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+
+	// the module files are read twice,for the assets list and the details
+	bool bRunStatus = true;
+	JsonWriter->WriteObjectStart(TEXT("AssetInfo"));
+	WriteStringArray(JSON_MODULE_LIST_SECTION_NAME, ModuleNames);
+	JsonWriter->WriteObjectStart(JSON_ALL_ASSETS_LIST_SECTION_NAME);
+	for (int32 ModuleIndex = 0; ModuleIndex < ModuleNames.Num(); ++ModuleIndex)
+	{
+		JsonWriter->WriteArrayStart(ModuleNames[ModuleIndex]);
+		bRunStatus = ForEachSpilledAsset(FPaths::Combine(SpillDir, FString::Printf(TEXT("%d.spill"), ModuleIndex)), [&JsonWriter](const FSpilledAsset& InAsset)
+		{
+			JsonWriter->WriteValue(InAsset.LongPackageName);
+		}) && bRunStatus;
+		JsonWriter->WriteArrayEnd();
+	}
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->WriteObjectStart(JSON_ALL_ASSETS_Detail_SECTION_NAME);
+	for (int32 ModuleIndex = 0; ModuleIndex < ModuleNames.Num(); ++ModuleIndex)
+	{
+		JsonWriter->WriteObjectStart(ModuleNames[ModuleIndex]);
+		bRunStatus = ForEachSpilledAsset(FPaths::Combine(SpillDir, FString::Printf(TEXT("%d.spill"), ModuleIndex)), [&JsonWriter](const FSpilledAsset& InAsset)
+		{
+			JsonWriter->WriteObjectStart(InAsset.LongPackageName);
+			JsonWriter->WriteValue(TEXT("PackagePath"), InAsset.Detail.mPackagePath);
+			JsonWriter->WriteValue(TEXT("AssetType"), InAsset.Detail.mAssetType);
+			JsonWriter->WriteValue(TEXT("AssetGUID"), InAsset.Detail.mGuid);
+			JsonWriter->WriteObjectEnd();
+		}) && bRunStatus;
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->WriteObjectEnd();
+
+	JsonWriter->WriteArrayStart(TEXT("ExternalFiles"));
+	for (const auto& ExternalFile : Version.ExternalFiles)
+	{
+		const FExternAssetFileInfo& FileInfo = ExternalFile.Value;
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("FilePath"), FPaths::ConvertRelativePathToFull(FileInfo.FilePath.FilePath));
+		JsonWriter->WriteValue(TEXT("MD5Hash"), FileInfo.FileHash.IsEmpty() ? FileInfo.GetFileHash() : FileInfo.FileHash);
+		JsonWriter->WriteValue(TEXT("MountPath"), FileInfo.MountPath);
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+	JsonWriter->WriteObjectEnd();
+	return JsonWriter->Close() && bRunStatus;
+}
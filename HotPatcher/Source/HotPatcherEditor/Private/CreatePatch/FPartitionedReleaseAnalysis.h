@@ -0,0 +1,71 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+#include "FHotPatcherVersion.h"
+#include "FPatcherSpecifyAsset.h"
+#include "FExternAssetFileInfo.h"
+#include "FSpillablePackageSet.h"
+#include "AssetManager/FAssetDetail.h"
+
+// engine header
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+/**
+ * Analyse the release version with a memory budget,used by the projects of millions assets.
+ * The directories of include filters are analysed one by one,the assets of directory are got by pages of the batch size.
+ * The dependency closure of a batch only visits the new packages,the found assets are spilled to disk by module,
+ * the visited packages are spilled to disk too when they reach the half of budget.
+ * Only the release export is bounded,the patch export analyses the assets in memory.
+ * The release json is streamed from the spilled files,it's same as the json of SerializeHotPatcherVersionToString.
+ */
+class FPartitionedReleaseAnalysis
+{
+public:
+	FPartitionedReleaseAnalysis(const FString& InSpillDir, int64 InMemoryBudget);
+	// the spilled files are deleted
+	~FPartitionedReleaseAnalysis();
+
+	// same as UFlibHotPatcherEditorHelper::ExportReleaseVersionInfo,must be called in the game thread
+	bool Analysis(
+		const FString& InVersionId,
+		const FString& InBaseVersion,
+		const FString& InDate,
+		const TArray<FString>& InIncludeFilter,
+		const TArray<FString>& InIgnoreFilter,
+		const TArray<FPatcherSpecifyAsset>& InIncludeSpecifyAsset,
+		const TArray<FExternAssetFileInfo>& InAllExternFiles,
+		bool InIncludeHasRefAssetsOnly
+	);
+	// stream the release json to file,it's compressed by chunks if InCompressionFormat isn't none
+	bool SaveRelease(const FString& InFile, FName InCompressionFormat = NAME_None)const;
+
+	FORCEINLINE int64 GetAssetNum()const { return AssetNum; }
+	FORCEINLINE int32 GetBatchAssetNum()const { return BatchAssetNum; }
+
+	// the estimated memory of an asset in the batch,include asset data,detail and dependencies
+	static const int64 EstimatedBytesPerAsset = 4 * 1024;
+	// the budget of batch and the visited packages
+	static const int64 BatchBudgetPercent = 50;
+
+protected:
+	// the assets of the package page are added to the batch
+	void AddPackagePage(TArray<FName>& InPackages, TArray<FAssetDetail>& OutBatchAssets);
+	void AnalysisBatch(const TArray<FAssetDetail>& InAssets, bool bInAnalysisDepend);
+	void SpillAsset(const FString& InLongPackageName, const FAssetDetail& InAssetDetail);
+	bool IsIgnored(const FString& InPath)const;
+	bool WriteRelease(FArchive& InWriter)const;
+
+private:
+	FString SpillDir;
+	int32 BatchAssetNum;
+	// the AssetInfo is empty,the assets are spilled
+	FHotPatcherVersion Version;
+
+	FSpillablePackageSet VisitedPackages;
+	// the specify assets don't analysis dependencies,the dependencies is analysed if they are visited again
+	TSet<FName> UnexpandedPackages;
+	TArray<FString> ModuleNames;
+	TMap<FString, TUniquePtr<FArchive>> ModuleWriters;
+	int64 AssetNum;
+};
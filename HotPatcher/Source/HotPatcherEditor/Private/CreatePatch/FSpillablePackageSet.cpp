@@ -0,0 +1,153 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#include "FSpillablePackageSet.h"
+
+// engine header
+#include "Algo/BinarySearch.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "Containers/StringConv.h"
+
+FSpillablePackageSet::FSpillablePackageSet(const FString& InSpillFile, int32 InMaxMemoryHashNum)
+	: SpillFile(InSpillFile),
+	MaxMemoryHashNum(FMath::Max(InMaxMemoryHashNum, BlockHashNum)),
+	SpilledHashNum(0)
+{
+}
+
+FSpillablePackageSet::~FSpillablePackageSet()
+{
+	Reset();
+}
+
+uint64 FSpillablePackageSet::GetPackageHash(FName InPackageName)
+{
+	// the name is case insensitive
+	FTCHARToUTF8 PackageName(*InPackageName.ToString().ToLower());
+	return CityHash64(PackageName.Get(), PackageName.Length());
+}
+
+bool FSpillablePackageSet::Contains(FName InPackageName)const
+{
+	uint64 Hash = GetPackageHash(InPackageName);
+	return MemoryHashes.Contains(Hash) || ContainsSpilled(Hash);
+}
+
+bool FSpillablePackageSet::Add(FName InPackageName)
+{
+	uint64 Hash = GetPackageHash(InPackageName);
+	if (MemoryHashes.Contains(Hash) || ContainsSpilled(Hash))
+		return false;
+	MemoryHashes.Add(Hash);
+	if (MemoryHashes.Num() >= MaxMemoryHashNum && !Spill())
+	{
+		// don't try to spill on every add
+		MaxMemoryHashNum = MemoryHashes.Num() * 2;
+		UE_LOG(LogTemp, Warning, TEXT("Spill the visited packages to %s Faild,keep them in memory."), *SpillFile);
+	}
+	return true;
+}
+
+void FSpillablePackageSet::Reset()
+{
+	MemoryHashes.Empty();
+	SpillReader.Reset();
+	IFileManager::Get().Delete(*SpillFile, false, false, true);
+	SpilledHashNum = 0;
+	BlockFirstHashes.Empty();
+	BlockBuffer.Empty();
+}
+
+bool FSpillablePackageSet::ContainsSpilled(uint64 InHash)const
+{
+	if (!SpilledHashNum || !SpillReader)
+		return false;
+	int32 BlockIndex = Algo::UpperBound(BlockFirstHashes, InHash) - 1;
+	if (BlockIndex < 0)
+		return false;
+
+	int64 BeginIndex = (int64)BlockIndex * BlockHashNum;
+	int32 HashNum = (int32)FMath::Min<int64>(BlockHashNum, SpilledHashNum - BeginIndex);
+	BlockBuffer.SetNumUninitialized(HashNum, false);
+	SpillReader->Seek(BeginIndex * sizeof(uint64));
+	SpillReader->Serialize(BlockBuffer.GetData(), HashNum * sizeof(uint64));
+	return !SpillReader->IsError() && Algo::BinarySearch(BlockBuffer, InHash) != INDEX_NONE;
+}
+
+bool FSpillablePackageSet::Spill()
+{
+	FString MergeFile = SpillFile + TEXT(".merge");
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*MergeFile));
+	if (!Writer)
+		return false;
+
+	TArray<uint64> Hashes = MemoryHashes.Array();
+	Hashes.Sort();
+
+	TArray<uint64> NewBlockFirstHashes;
+	int64 NewHashNum = 0;
+	auto WriteHash = [&Writer, &NewBlockFirstHashes, &NewHashNum](uint64 InHash)
+	{
+		if (NewHashNum % BlockHashNum == 0)
+		{
+			NewBlockFirstHashes.Add(InHash);
+		}
+		*Writer << InHash;
+		++NewHashNum;
+	};
+
+	// the spilled file is read by blocks
+	int64 ReadIndex = 0;
+	int32 BufferIndex = 0;
+	BlockBuffer.Reset();
+	auto ReadSpilledHash = [this, &ReadIndex, &BufferIndex](uint64& OutHash)->bool
+	{
+		if (BufferIndex >= BlockBuffer.Num())
+		{
+			if (ReadIndex >= SpilledHashNum || !SpillReader)
+				return false;
+			int32 HashNum = (int32)FMath::Min<int64>(BlockHashNum, SpilledHashNum - ReadIndex);
+			BlockBuffer.SetNumUninitialized(HashNum, false);
+			SpillReader->Seek(ReadIndex * sizeof(uint64));
+			SpillReader->Serialize(BlockBuffer.GetData(), HashNum * sizeof(uint64));
+			ReadIndex += HashNum;
+			BufferIndex = 0;
+		}
+		OutHash = BlockBuffer[BufferIndex++];
+		return true;
+	};
+
+	int32 MemoryIndex = 0;
+	uint64 SpilledHash = 0;
+	bool bHasSpilledHash = ReadSpilledHash(SpilledHash);
+	while (bHasSpilledHash || MemoryIndex < Hashes.Num())
+	{
+		if (bHasSpilledHash && (MemoryIndex >= Hashes.Num() || SpilledHash < Hashes[MemoryIndex]))
+		{
+			WriteHash(SpilledHash);
+			bHasSpilledHash = ReadSpilledHash(SpilledHash);
+		}
+		else
+		{
+			WriteHash(Hashes[MemoryIndex++]);
+		}
+	}
+
+	bool bRunStatus = !Writer->IsError() && Writer->Close() && !(SpillReader && SpillReader->IsError());
+	Writer.Reset();
+	SpillReader.Reset();
+	BlockBuffer.Reset();
+	if (!bRunStatus || !IFileManager::Get().Move(*SpillFile, *MergeFile, true))
+	{
+		// the old spilled file is still valid
+		IFileManager::Get().Delete(*MergeFile, false, false, true);
+		SpillReader.Reset(IFileManager::Get().CreateFileReader(*SpillFile));
+		return false;
+	}
+
+	SpilledHashNum = NewHashNum;
+	BlockFirstHashes = MoveTemp(NewBlockFirstHashes);
+	MemoryHashes.Reset();
+	SpillReader.Reset(IFileManager::Get().CreateFileReader(*SpillFile));
+	return SpillReader.IsValid();
+}
@@ -0,0 +1,49 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "Serialization/Archive.h"
+
+/**
+ * The set of package names with a memory limit,used by the memory bounded analysis.
+ * The packages are kept as the 64 bits hash of name,when the hashes in memory reach the limit,
+ * they are merged to a sorted file on disk.Only one of every BlockHashNum hashes of the file is kept in memory,
+ * a lookup of the file reads one block.
+ */
+class FSpillablePackageSet
+{
+public:
+	FSpillablePackageSet(const FString& InSpillFile, int32 InMaxMemoryHashNum);
+	~FSpillablePackageSet();
+
+	bool Contains(FName InPackageName)const;
+	// return false if the package is already in the set
+	bool Add(FName InPackageName);
+	void Reset();
+	FORCEINLINE int64 Num()const { return MemoryHashes.Num() + SpilledHashNum; }
+
+	// the hashes of a block of the spilled file
+	static const int32 BlockHashNum = 512;
+	// the memory of a hash in TSet,include the hash index
+	static const int64 EstimatedBytesPerHash = 32;
+
+protected:
+	static uint64 GetPackageHash(FName InPackageName);
+	bool ContainsSpilled(uint64 InHash)const;
+	// merge the hashes in memory and the spilled file to a new sorted file
+	bool Spill();
+
+private:
+	FString SpillFile;
+	int32 MaxMemoryHashNum;
+	TSet<uint64> MemoryHashes;
+
+	int64 SpilledHashNum;
+	// the first hash of every block in the spilled file
+	TArray<uint64> BlockFirstHashes;
+	mutable TUniquePtr<FArchive> SpillReader;
+	mutable TArray<uint64> BlockBuffer;
+};
@@ -0,0 +1,143 @@
+// Copyright 2019 Lipeng Zha, Inc. All Rights Reserved.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+#include "Widgets/Views/SExpanderArrow.h"
+#include "Widgets/Views/STreeView.h"
+
+#define LOCTEXT_NAMESPACE "SHotPatcherDiffListRow"
+
+enum class EHotPatcherDiffChange : uint8
+{
+	Add,
+	Modify,
+	Delete,
+	Num
+};
+
+// a node of the diff tree,change type -> module -> asset or external file
+struct FHotPatcherDiffItem
+{
+	enum class EItemType : uint8
+	{
+		ChangeType,
+		Module,
+		Asset,
+		ExternalFile
+	};
+
+	EItemType ItemType = EItemType::Asset;
+	EHotPatcherDiffChange Change = EHotPatcherDiffChange::Add;
+	// the change type,module name,long package name or file path
+	FString Name;
+	// the asset class or mount path of file
+	FString Type;
+	// bytes on disk,the group is the sum of filtered children,-1 is unknown
+	int64 Size = -1;
+	// the assets and files of group after filter
+	int32 LeafNum = 0;
+
+	TArray<TSharedPtr<FHotPatcherDiffItem>> Children;
+	TArray<TSharedPtr<FHotPatcherDiffItem>> FilteredChildren;
+
+	FORCEINLINE bool IsLeaf()const { return ItemType == EItemType::Asset || ItemType == EItemType::ExternalFile; }
+	FText GetDisplayName()const
+	{
+		return IsLeaf() ? FText::FromString(Name) : FText::Format(LOCTEXT("DiffGroupName", "{0} ({1})"), FText::FromString(Name), FText::AsNumber(LeafNum));
+	}
+};
+
+/**
+ * Implements a row widget for the diff tree.
+ */
+class SHotPatcherDiffListRow
+	: public SMultiColumnTableRow<TSharedPtr<FHotPatcherDiffItem> >
+{
+public:
+
+	SLATE_BEGIN_ARGS(SHotPatcherDiffListRow) { }
+		SLATE_ATTRIBUTE(FText, HighlightText)
+		SLATE_ARGUMENT(TSharedPtr<FHotPatcherDiffItem>, Item)
+	SLATE_END_ARGS()
+
+public:
+
+	/**
+	 * Constructs the widget.
+	 *
+	 * @param InArgs The construction arguments.
+	 * @param InOwnerTableView The tree view of the row.
+	 */
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTableView)
+	{
+		HighlightText = InArgs._HighlightText;
+		Item = InArgs._Item;
+
+		SMultiColumnTableRow<TSharedPtr<FHotPatcherDiffItem> >::Construct(FSuperRowType::FArguments(), InOwnerTableView);
+	}
+
+public:
+
+	/**
+	 * Generates the widget for the specified column.
+	 *
+	 * @param ColumnName The name of the column to generate the widget for.
+	 * @return The widget.
+	 */
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		if (ColumnName == "Name")
+		{
+			return SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SNew(SExpanderArrow, SharedThis(this))
+				]
+				+ SHorizontalBox::Slot()
+				.FillWidth(1.0f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(this, &SHotPatcherDiffListRow::HandleNameText)
+					.HighlightText(Item->IsLeaf() ? HighlightText : TAttribute<FText>(FText::GetEmpty()))
+				];
+		}
+		if (ColumnName == "Type")
+		{
+			return SNew(STextBlock)
+				.Text(FText::FromString(Item->Type));
+		}
+		if (ColumnName == "Size")
+		{
+			return SNew(STextBlock)
+				.Text(this, &SHotPatcherDiffListRow::HandleSizeText);
+		}
+
+		return SNullWidget::NullWidget;
+	}
+
+private:
+
+	// the count and size of group are changed by the filter,the row is reused
+	FText HandleNameText()const
+	{
+		return Item->GetDisplayName();
+	}
+	FText HandleSizeText()const
+	{
+		return Item->Size >= 0 ? FText::AsMemory((uint64)Item->Size) : FText::FromString(TEXT("-"));
+	}
+
+private:
+
+	TAttribute<FText> HighlightText;
+	TSharedPtr<FHotPatcherDiffItem> Item;
+};
+
+#undef LOCTEXT_NAMESPACE
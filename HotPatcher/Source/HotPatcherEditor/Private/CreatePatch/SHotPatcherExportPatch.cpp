@@ -2,11 +2,13 @@
 
 // #include "HotPatcherPrivatePCH.h"
 #include "SHotPatcherExportPatch.h"
+#include "FExportPatchPipeline.h"
 #include "FlibHotPatcherEditorHelper.h"
 #include "FlibPatchParserHelper.h"
 #include "FHotPatcherVersion.h"
 #include "FLibAssetManageHelperEx.h"
 #include "FPakFileInfo.h"
+#include "HotPatcherTrace.h"
 // engine header
 #include "SHyperlink.h"
 #include "Misc/FileHelper.h"
@@ -15,7 +17,6 @@
 
 #include "Kismet/KismetSystemLibrary.h"
 #include "Misc/SecureHash.h"
-#include "Misc/ScopedSlowTask.h"
 #include "HAL/FileManager.h"
 
 #define LOCTEXT_NAMESPACE "SHotPatcherCreatePatch"
@@ -25,6 +26,7 @@ void SHotPatcherExportPatch::Construct(const FArguments& InArgs, TSharedPtr<FHot
 
 	CreateExportFilterListView();
 	mCreatePatchModel = InCreatePatchModel;
+	PendingPatch = MakeShareable(new FHotPatcherPendingPatch);
 
 	ChildSlot
 		[
@@ -75,7 +77,7 @@ void SHotPatcherExportPatch::Construct(const FArguments& InArgs, TSharedPtr<FHot
 					[
 						SNew(SButton)
 						.Text(LOCTEXT("GeneratePatch", "GeneratePatch"))
-						.IsEnabled(this, &SHotPatcherExportPatch::CanExportPatch)
+						.IsEnabled(this, &SHotPatcherExportPatch::CanGeneratePatch)
 						.OnClicked(this, &SHotPatcherExportPatch::DoExportPatch)
 					]
 			]
@@ -93,6 +95,8 @@ void SHotPatcherExportPatch::Construct(const FArguments& InArgs, TSharedPtr<FHot
 
 	ExportPatchSetting = UExportPatchSettings::Get();
 	SettingsView->SetObject(ExportPatchSetting.Get());
+	// the settings are read by the export pipeline in the background
+	SettingsView->SetIsPropertyEditingEnabledDelegate(FIsPropertyEditingEnabled::CreateLambda([this]() { return !IsPipelineRunning(); }));
 
 }
 
@@ -154,90 +158,22 @@ void SHotPatcherExportPatch::DoGenerate()
 
 FReply SHotPatcherExportPatch::DoDiff()const
 {
-	FString BaseVersionContent;
-	FHotPatcherVersion BaseVersion;
-
-	bool bDeserializeStatus = false;
-
-	if (ExportPatchSetting->IsByBaseVersion())
+	HOTPATCHER_TRACE_SCOPE(DoDiff);
+	if (!PendingPatch->Update(ExportPatchSetting.Get()))
 	{
-		if (UFLibAssetManageHelperEx::LoadFileToString(ExportPatchSetting->GetBaseVersion(), BaseVersionContent))
-		{
-			bDeserializeStatus = UFlibPatchParserHelper::DeserializeHotPatcherVersionFromString(BaseVersionContent, BaseVersion);
-		}
-		if (!bDeserializeStatus)
-		{
-			UE_LOG(LogTemp, Error, TEXT("Deserialize Base Version Faild!"));
-			return FReply::Handled();
-		}
+		return FReply::Handled();
 	}
+	const FHotPatcherPendingDiff& Diff = PendingPatch->GetDiff();
 
-	FHotPatcherVersion CurrentVersion = UFlibHotPatcherEditorHelper::ExportReleaseVersionInfo(
-		ExportPatchSetting->GetVersionId(),
-		BaseVersion.VersionId,
-		FDateTime::UtcNow().ToString(),
-		ExportPatchSetting->GetAssetIncludeFilters(),
-		ExportPatchSetting->GetAssetIgnoreFilters(),
-		ExportPatchSetting->GetIncludeSpecifyAssets(),
-		ExportPatchSetting->GetAllExternFiles(true),
-		ExportPatchSetting->IsIncludeHasRefAssetsOnly()
-	);
-
-	FString CurrentVersionSavePath = FPaths::Combine(ExportPatchSetting->GetSaveAbsPath(), CurrentVersion.VersionId);
-
-	// parser version difference
-
-	FAssetDependenciesInfo BaseVersionAssetDependInfo = BaseVersion.AssetInfo;
-	FAssetDependenciesInfo CurrentVersionAssetDependInfo = CurrentVersion.AssetInfo;
-
-	FAssetDependenciesInfo AddAssetDependInfo;
-	FAssetDependenciesInfo ModifyAssetDependInfo;
-	FAssetDependenciesInfo DeleteAssetDependInfo;
-
-	UFlibPatchParserHelper::DiffVersionAssets(
-		CurrentVersionAssetDependInfo,
-		BaseVersionAssetDependInfo,
-		AddAssetDependInfo,
-		ModifyAssetDependInfo,
-		DeleteAssetDependInfo
-	);
-
-	TArray<FExternAssetFileInfo> AddExternalFiles;
-	TArray<FExternAssetFileInfo> ModifyExternalFiles;
-	TArray<FExternAssetFileInfo> DeleteExternalFiles;
-
-	UFlibPatchParserHelper::DiffVersionExFiles(CurrentVersion, BaseVersion, AddExternalFiles, ModifyExternalFiles, DeleteExternalFiles);
-
-	// debug
-	//{
-	//	auto VersionPrint = [](const FHotPatcherVersion& CurrentVersion)
-	//	{
-	//		TArray<FString> Keys;
-	//		CurrentVersion.ExternalFiles.GetKeys(Keys);
-
-	//		for (const auto& File : Keys)
-	//		{
-	//			FExternAssetFileInfo CurrentFile = *CurrentVersion.ExternalFiles.Find(File);
-	//			UE_LOG(LogTemp, Warning, TEXT("new External Files filepath %s"), *CurrentFile.FilePath.FilePath);
-	//			UE_LOG(LogTemp, Warning, TEXT("new External Files filehash %s"), *CurrentFile.FileHash);
-	//			UE_LOG(LogTemp, Warning, TEXT("new External Files mountpath %s"), *CurrentFile.MountPath);
-	//		}
-	//	};
-
-	//	UE_LOG(LogTemp, Warning, TEXT("---------------------"));
-	//	VersionPrint(CurrentVersion);
-	//	UE_LOG(LogTemp, Warning, TEXT("---------------------"));
-	//	VersionPrint(BaseVersion);
-	//	UE_LOG(LogTemp, Warning, TEXT("---------------------"));
-	//}
-	FString SerializeDiffInfo =
-		FString::Printf(TEXT("%s\n%s\n"),
-			*UFlibPatchParserHelper::SerializeDiffAssetsInfomationToString(AddAssetDependInfo, ModifyAssetDependInfo, DeleteAssetDependInfo),
-			ExportPatchSetting->IsEnableExternFilesDiff()?
-			*UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToString(AddExternalFiles, ModifyExternalFiles, DeleteExternalFiles):
-			*UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToString(ExportPatchSetting->GetAllExternFiles(), TArray<FExternAssetFileInfo>{}, TArray<FExternAssetFileInfo>{})
-		);
-	SetInformationContent(SerializeDiffInfo);
+	// fed to the tree view directly,serialize the diff to text is too slow for the large projects
+	if (ExportPatchSetting->IsEnableExternFilesDiff())
+	{
+		DiffWidget->SetDiff(Diff.AddAssetDependInfo, Diff.ModifyAssetDependInfo, Diff.DeleteAssetDependInfo, Diff.AddExternalFiles, Diff.ModifyExternalFiles, Diff.DeleteExternalFiles);
+	}
+	else
+	{
+		DiffWidget->SetDiff(Diff.AddAssetDependInfo, Diff.ModifyAssetDependInfo, Diff.DeleteAssetDependInfo, ExportPatchSetting->GetAllExternFiles(), TArray<FExternAssetFileInfo>{}, TArray<FExternAssetFileInfo>{});
+	}
 	SetInfomationContentVisibility(EVisibility::Visible);
 
 	return FReply::Handled();
@@ -330,355 +266,31 @@ bool SHotPatcherExportPatch::CanExportPatch()const
 
 FReply SHotPatcherExportPatch::DoExportPatch()
 {
+	HOTPATCHER_TRACE_SCOPE(DoExportPatch);
+	RunPipeline(MakeShareable(new FExportPatchPipeline(ExportPatchSetting.Get())), LOCTEXT("ExportPatchPipeline", "Export Patch"));
+	return FReply::Handled();
+}
 
-	FHotPatcherVersion BaseVersion;
-
-	if (ExportPatchSetting->IsByBaseVersion() && !ExportPatchSetting->GetBaseVersionInfo(BaseVersion))
-	{
-		UE_LOG(LogTemp, Error, TEXT("Deserialize Base Version Faild!"));
-		return FReply::Handled();
-	}
-
-	UFLibAssetManageHelperEx::UpdateAssetMangerDatabase(true);
-
-	FHotPatcherVersion CurrentVersion = ExportPatchSetting->GetNewPatchVersionInfo();
-
-	FString CurrentVersionSavePath = ExportPatchSetting->GetCurrentVersionSavePath();
-
-	// parser version difference
-
-	FAssetDependenciesInfo BaseVersionAssetDependInfo = BaseVersion.AssetInfo;
-	FAssetDependenciesInfo CurrentVersionAssetDependInfo = CurrentVersion.AssetInfo;
-
-	FAssetDependenciesInfo AddAssetDependInfo;
-	FAssetDependenciesInfo ModifyAssetDependInfo;
-	FAssetDependenciesInfo DeleteAssetDependInfo;
-
-	UFlibPatchParserHelper::DiffVersionAssets(
-		CurrentVersionAssetDependInfo,
-		BaseVersionAssetDependInfo,
-		AddAssetDependInfo,
-		ModifyAssetDependInfo,
-		DeleteAssetDependInfo
-	);
-
-	TArray<FExternAssetFileInfo> AddExternalFiles;
-	TArray<FExternAssetFileInfo> ModifyExternalFiles;
-	TArray<FExternAssetFileInfo> DeleteExternalFiles;
-
-	UFlibPatchParserHelper::DiffVersionExFiles(CurrentVersion, BaseVersion, AddExternalFiles, ModifyExternalFiles, DeleteExternalFiles);
-
-	TArray<FExternAssetFileInfo> AllChangedExternalFiles;
-	AllChangedExternalFiles.Append(AddExternalFiles);
-	AllChangedExternalFiles.Append(ModifyExternalFiles);
-
-	// handle add & modify asset only
-	FAssetDependenciesInfo AllChangedAssetInfo = UFLibAssetManageHelperEx::CombineAssetDependencies(AddAssetDependInfo, ModifyAssetDependInfo);
-
-	auto ErrorMsgShowLambda = [this](const FString& InErrorMsg)->bool
-	{
-		bool bHasError = false;
-		if (!InErrorMsg.IsEmpty())
-		{
-			this->SetInformationContent(InErrorMsg);
-			this->SetInfomationContentVisibility(EVisibility::Visible);
-			bHasError = true;
-		}
-		else
-		{
-			if (this->InformationContentIsVisibility())
-			{
-				this->SetInformationContent(TEXT(""));
-				this->SetInfomationContentVisibility(EVisibility::Collapsed);
-			}
-		}
-		return bHasError;
-	};
-
-	// 错误处理
-	{
-		FString GenErrorMsg;
-		// 检查所修改的资源是否被Cook过
-		{
-
-			for (const auto& PlatformName : ExportPatchSetting->GetPakTargetPlatformNames())
-			{
-				TArray<FAssetDetail> ValidCookAssets;
-				TArray<FAssetDetail> InvalidCookAssets;
-
-				UFlibHotPatcherEditorHelper::CheckInvalidCookFilesByAssetDependenciesInfo(UKismetSystemLibrary::GetProjectDirectory(), PlatformName, AllChangedAssetInfo, ValidCookAssets, InvalidCookAssets);
-
-				if (InvalidCookAssets.Num() > 0)
-				{
-					GenErrorMsg.Append(FString::Printf(TEXT("%s UnCooked Assets:\n"), *PlatformName));
-
-					for (const auto& Asset : InvalidCookAssets)
-					{
-						FString AssetLongPackageName;
-						UFLibAssetManageHelperEx::ConvPackagePathToLongPackageName(Asset.mPackagePath, AssetLongPackageName);
-						GenErrorMsg.Append(FString::Printf(TEXT("\t%s\n"), *AssetLongPackageName));
-					}
-				}
-			}
-		}
-
-		// 检查添加的外部文件是否有重复
-		//{
-		//	TArray<FString> AllExternList;
-		//	TArray<FString> RepeatList;
-
-		//	const TArray<FString>& AllExternFileToPakCommands = ExportPatchSetting->CombineAddExternFileToCookCommands();
-		//	const TArray<FString>& AllExtensionDirectoryToPakCommands = ExportPatchSetting->CombineAllExternDirectoryCookCommand();
-
-		//	auto FilterRepeatLambda = [&AllExternList, &RepeatList](const TArray<FString>& InList)
-		//	{
-		//		for (const auto& Item : InList)
-		//		{
-		//			if (!AllExternList.Contains(Item))
-		//			{
-		//				AllExternList.Add(Item);
-		//				continue;
-		//			}
-
-		//			if (!RepeatList.Contains(Item))
-		//			{
-		//				RepeatList.Add(Item);
-		//			}
-		//		}
-		//	};
-
-		//	FilterRepeatLambda(AllExternFileToPakCommands);
-		//	FilterRepeatLambda(AllExtensionDirectoryToPakCommands);
-
-		//	if (RepeatList.Num() > 0)
-		//	{
-		//		GenErrorMsg.Append(FString::Printf(TEXT("Repeat Extern File(s):\n")));
-		//		for (const auto& RepeatFile : RepeatList)
-		//		{
-		//			GenErrorMsg.Append(FString::Printf(TEXT("\t%s\n"), *RepeatFile));
-		//		}
-
-		//	}
-		//}
-
-
-
-		// 如果有错误信息 则输出后退出
-		if (ErrorMsgShowLambda(GenErrorMsg)) return FReply::Handled();
-	}
-
-	float AmountOfWorkProgress = 2.f * ExportPatchSetting->GetPakTargetPlatforms().Num() + 4.0f;
-	FScopedSlowTask UnrealPakSlowTask(AmountOfWorkProgress);
-	UnrealPakSlowTask.MakeDialog();
-
-	// save pakversion.json
-	FPakVersion PakVersion = UExportPatchSettings::GetPakVersion(CurrentVersion, FDateTime::UtcNow().ToString());
-	{
-		if (ExportPatchSetting->IsIncludePakVersion())
-		{
-			FString SavePakVersionFilePath = UExportPatchSettings::GetSavePakVersionPath(CurrentVersionSavePath, CurrentVersion);
-
-			FString OutString;
-			if (UFlibPakHelper::SerializePakVersionToString(PakVersion, OutString))
-			{
-				UFLibAssetManageHelperEx::SaveStringToFile(SavePakVersionFilePath, OutString);
-			}
-		}
-	}
-
-	// package all selected platform
-	TMap<FString,FPakFileInfo> PakFilesInfoMap;
-	for(const auto& PlatformName :ExportPatchSetting->GetPakTargetPlatformNames())
-	{
-		// Update Progress Dialog
-		{
-			FText Dialog = FText::Format(NSLOCTEXT("ExportPatch", "GeneratedPakCommands", "Generating UnrealPak Commands of {0} Platform."), FText::FromString(PlatformName));
-			UnrealPakSlowTask.EnterProgressFrame(1.0, Dialog);
-		}
-
-		FString SavePakCommandPath = UExportPatchSettings::GetSavePakCommandsPath(CurrentVersionSavePath, PlatformName, CurrentVersion);
-
-		// combine all cook commands
-		{
-			FString ProjectDir = UKismetSystemLibrary::GetProjectDirectory();
-
-			// generated cook command form asset list
-			TArray<FString> OutPakCommand = ExportPatchSetting->CombineAllCookCommandsInTheSetting(PlatformName, AllChangedAssetInfo, AllChangedExternalFiles,ExportPatchSetting->IsEnableExternFilesDiff());
-
-			// save paklist to file
-			if (FFileHelper::SaveStringArrayToFile(OutPakCommand, *SavePakCommandPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
-			{
-				if (ExportPatchSetting->IsSavePakList())
-				{
-					auto Msg = LOCTEXT("SavePatchPakCommand", "Succeed to export the Patch Packaghe Pak Command.");
-					UFlibHotPatcherEditorHelper::CreateSaveFileNotify(Msg, SavePakCommandPath);
-				}
-			}
-		}
-		
-		// Update SlowTask Progress
-		{
-			FText Dialog = FText::Format(NSLOCTEXT("ExportPatch", "GeneratedPak", "Generating Pak list of {0} Platform."), FText::FromString(PlatformName));
-			UnrealPakSlowTask.EnterProgressFrame(1.0, Dialog);
-		}
-
-		// create UnrealPak.exe create .pak file
-		{
-			FString SavePakFilePath = FPaths::Combine(
-				CurrentVersionSavePath,
-				PlatformName,
-				FString::Printf(TEXT("%s_%s_001_P.pak"), *CurrentVersion.VersionId, *PlatformName)
-			);
-			FString UnrealPakBinary = UFlibPatchParserHelper::GetUnrealPakBinary();
-
-			FString CommandLine = FString::Printf(
-				TEXT("%s -create=%s"),
-				*(TEXT("\"") + SavePakFilePath + TEXT("\"")),
-				*(TEXT("\"") + SavePakCommandPath + TEXT("\""))
-			);
-
-			// combine UnrealPak Options
-			TArray<FString> UnrealPakOptions = ExportPatchSetting->GetUnrealPakOptions();
-			for (const auto& Option : UnrealPakOptions)
-			{
-				CommandLine.Append(FString::Printf(TEXT(" %s"), *Option));
-			}
-
-			// create UnrealPak process
-
-			uint32 *ProcessID = NULL;
-            FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*UnrealPakBinary, *CommandLine, true, false, false, ProcessID, 0, NULL, NULL, NULL);
-			FPlatformProcess::WaitForProc(ProcessHandle);
-
-			if (FPaths::FileExists(SavePakFilePath))
-			{
-				FText Msg = LOCTEXT("SavedPakFileMsg", "Successd to Package the patch as Pak.");
-				UFlibHotPatcherEditorHelper::CreateSaveFileNotify(Msg, SavePakFilePath);
-				
-				FPakFileInfo CurrentPakInfo;
-				if (UFlibPatchParserHelper::GetPakFileInfo(SavePakFilePath, CurrentPakInfo))
-				{
-					CurrentPakInfo.PakVersion = PakVersion;
-					PakFilesInfoMap.Add(PlatformName,CurrentPakInfo);
-				}
-			}
-		}
-
-		// is save PakList?
-		if (!ExportPatchSetting->IsSavePakList() && FPaths::FileExists(SavePakCommandPath))
-		{
-			IFileManager::Get().Delete(*SavePakCommandPath);
-		}
-	}
-
-	// delete pakversion.json
-	{
-		FString PakVersionSavedPath = UExportPatchSettings::GetSavePakVersionPath(CurrentVersionSavePath,CurrentVersion);
-		if (ExportPatchSetting->IsIncludePakVersion() && FPaths::FileExists(PakVersionSavedPath))
-		{
-			IFileManager::Get().Delete(*PakVersionSavedPath);
-		}
-	}
-	
-	// save difference to file
-	{
-		{
-			FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch","ExportPatchDiffFile","Generating Diff info of version {0}"),FText::FromString(CurrentVersion.VersionId));
-			UnrealPakSlowTask.EnterProgressFrame(1.0, DiaLogMsg);
-		}
-
-		if (ExportPatchSetting->IsSaveDiffAnalysis())
-		{
-			FString SerializeDiffInfo =
-				FString::Printf(TEXT("%s\n%s\n"),
-					*UFlibPatchParserHelper::SerializeDiffAssetsInfomationToString(AddAssetDependInfo, ModifyAssetDependInfo, DeleteAssetDependInfo),
-					ExportPatchSetting->IsEnableExternFilesDiff()?
-					*UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToString(AddExternalFiles, ModifyExternalFiles, DeleteExternalFiles):
-					*UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToString(ExportPatchSetting->GetAllExternFiles(), TArray<FExternAssetFileInfo>{}, TArray<FExternAssetFileInfo>{})
-				);
-
-
-			FString SaveDiffToFile = FPaths::Combine(
-				CurrentVersionSavePath,
-				FString::Printf(TEXT("%s_%s_Diff.json"), *CurrentVersion.BaseVersionId, *CurrentVersion.VersionId)
-			);
-			if (UFLibAssetManageHelperEx::SaveStringToFile(SaveDiffToFile, SerializeDiffInfo))
-			{
-				auto Msg = LOCTEXT("SavePatchDiffInfo", "Succeed to export New Patch Diff Info.");
-				UFlibHotPatcherEditorHelper::CreateSaveFileNotify(Msg, SaveDiffToFile);
-			}
-		}
-	}
-
-	// save Patch Tracked asset info to file
-	{
-		{
-			FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch", "ExportPatchAssetInfo", "Generating Patch Tacked Asset info of version {0}"), FText::FromString(CurrentVersion.VersionId));
-			UnrealPakSlowTask.EnterProgressFrame(1.0, DiaLogMsg);
-		}
-		FString SerializeCurrentVersionInfo;
-		UFlibPatchParserHelper::SerializeHotPatcherVersionToString(CurrentVersion, SerializeCurrentVersionInfo);
+bool SHotPatcherExportPatch::CanGeneratePatch()const
+{
+	return CanExportPatch() && !IsPipelineRunning();
+}
 
-		FString SaveCurrentVersionToFile = FPaths::Combine(
-			CurrentVersionSavePath,
-			FString::Printf(TEXT("%s_Release.json"), *CurrentVersion.VersionId)
-		);
-		if (UFLibAssetManageHelperEx::SaveStringToFile(SaveCurrentVersionToFile, SerializeCurrentVersionInfo))
-		{
-			auto Msg = LOCTEXT("SavePatchDiffInfo", "Succeed to export New Release Info.");
-			UFlibHotPatcherEditorHelper::CreateSaveFileNotify(Msg, SaveCurrentVersionToFile);
-		}
-	}
+void SHotPatcherExportPatch::OnPipelineFinished(bool bInSuccessed, const FString& InErrorMsg)
+{
+	SHotPatcherPatchableBase::OnPipelineFinished(bInSuccessed, InErrorMsg);
 
-	// serialize all pak file info
+	// show the error of the changed assets,or clear the last error
+	if (!InErrorMsg.IsEmpty())
 	{
-		{
-			FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch", "ExportPatchPakFileInfo", "Generating All Platform Pak info of version {0}"), FText::FromString(CurrentVersion.VersionId));
-			UnrealPakSlowTask.EnterProgressFrame(1.0, DiaLogMsg);
-		}
-		FString PakFilesInfoStr;
-		UFlibPatchParserHelper::SerializePlatformPakInfoToString(PakFilesInfoMap, PakFilesInfoStr);
-
-		if (!PakFilesInfoStr.IsEmpty())
-		{
-			FString SavePakFilesPath = FPaths::Combine(
-				CurrentVersionSavePath,
-				FString::Printf(TEXT("%s_PakFilesInfo.json"), *CurrentVersion.VersionId)
-			);
-			if (UFLibAssetManageHelperEx::SaveStringToFile(SavePakFilesPath, PakFilesInfoStr) && FPaths::FileExists(SavePakFilesPath))
-			{
-				FText Msg = LOCTEXT("SavedPakFileMsg", "Successd to Export the Pak File info.");
-				UFlibHotPatcherEditorHelper::CreateSaveFileNotify(Msg, SavePakFilesPath);
-			}
-		}
+		SetInformationContent(InErrorMsg);
+		SetInfomationContentVisibility(EVisibility::Visible);
 	}
-
-	// serialize patch config
+	else if (InformationContentIsVisibility())
 	{
-		{
-			FText DiaLogMsg = FText::Format(NSLOCTEXT("ExportPatch", "ExportPatchConfig", "Generating Current Patch Config of version {0}"), FText::FromString(CurrentVersion.VersionId));
-			UnrealPakSlowTask.EnterProgressFrame(1.0, DiaLogMsg);
-		}
-
-		FString SaveConfigPath = FPaths::Combine(
-			CurrentVersionSavePath,
-			FString::Printf(TEXT("%s_PatchConfig.json"),*CurrentVersion.VersionId)
-		);
-
-		if (ExportPatchSetting->IsSavePatchConfig())
-		{
-			FString SerializedJsonStr;
-			ExportPatchSetting->SerializePatchConfigToString(SerializedJsonStr);
-
-			if (FFileHelper::SaveStringToFile(SerializedJsonStr, *SaveConfigPath))
-			{
-				FText Msg = LOCTEXT("SavedPatchConfigMas", "Successd to Export the Patch Config.");
-				UFlibHotPatcherEditorHelper::CreateSaveFileNotify(Msg, SaveConfigPath);
-			}
-		}
+		SetInformationContent(TEXT(""));
+		SetInfomationContentVisibility(EVisibility::Collapsed);
 	}
-
-	return FReply::Handled();
 }
 
 void SHotPatcherExportPatch::CreateExportFilterListView()
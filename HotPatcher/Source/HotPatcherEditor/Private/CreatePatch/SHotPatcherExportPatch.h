@@ -7,6 +7,7 @@
 #include "ExportPatchSettings.h"
 #include "SHotPatcherInformations.h"
 #include "SHotPatcherPatchableBase.h"
+#include "FHotPatcherPendingPatch.h"
 
 // engine header
 #include "Interfaces/ITargetPlatform.h"
@@ -45,6 +46,8 @@ protected:
 	void CreateExportFilterListView();
 	bool CanExportPatch()const;
 	FReply DoExportPatch();
+	bool CanGeneratePatch()const;
+	virtual void OnPipelineFinished(bool bInSuccessed, const FString& InErrorMsg)override;
 
 	FReply DoDiff()const;
 	bool CanDiff()const;
@@ -66,5 +69,7 @@ private:
 	TSharedPtr<UExportPatchSettings> ExportPatchSetting;
 
 	TSharedPtr<SHotPatcherInformations> DiffWidget;
+	// kept up to date by the asset registry events,the diff is incremental
+	TSharedPtr<FHotPatcherPendingPatch> PendingPatch;
 };
 
@@ -2,10 +2,13 @@
 
 // #include "HotPatcherPrivatePCH.h"
 #include "SHotPatcherExportRelease.h"
+#include "FExportReleasePipeline.h"
 #include "FlibHotPatcherEditorHelper.h"
 #include "FLibAssetManageHelperEx.h"
 #include "AssetManager/FAssetDependenciesInfo.h"
 #include "FHotPatcherVersion.h"
+#include "FlibPatchParserHelper.h"
+#include "HotPatcherTrace.h"
 
 // engine header
 #include "SHyperlink.h"
@@ -48,12 +51,14 @@ void SHotPatcherExportRelease::Construct(const FArguments& InArgs, TSharedPtr<FH
 				SNew(SButton)
 				.Text(LOCTEXT("GenerateRelease", "Export Release"))
 				.OnClicked(this,&SHotPatcherExportRelease::DoExportRelease)
-				.IsEnabled(this,&SHotPatcherExportRelease::CanExportRelease)
+				.IsEnabled(this,&SHotPatcherExportRelease::CanGenerateRelease)
 			]
 		];
 
 	ExportReleaseSettings = UExportReleaseSettings::Get();
 	SettingsView->SetObject(ExportReleaseSettings.Get());
+	// the settings are read by the export pipeline in the background
+	SettingsView->SetIsPropertyEditingEnabledDelegate(FIsPropertyEditingEnabled::CreateLambda([this]() { return !IsPipelineRunning(); }));
 }
 
 void SHotPatcherExportRelease::ImportConfig()
@@ -141,52 +146,15 @@ bool SHotPatcherExportRelease::CanExportRelease()const
 	return bCanExport;
 }
 
+bool SHotPatcherExportRelease::CanGenerateRelease()const
+{
+	return CanExportRelease() && !IsPipelineRunning();
+}
+
 FReply SHotPatcherExportRelease::DoExportRelease()
 {
-	FHotPatcherVersion ExportVersion= UFlibHotPatcherEditorHelper::ExportReleaseVersionInfo(
-			ExportReleaseSettings->GetVersionId(),
-			TEXT(""),
-			FDateTime::UtcNow().ToString(),
-			ExportReleaseSettings->GetAssetIncludeFilters(),
-			ExportReleaseSettings->GetAssetIgnoreFilters(),
-			ExportReleaseSettings->GetSpecifyAssets(),
-			ExportReleaseSettings->GetAllExternFiles(true),
-			ExportReleaseSettings->IsIncludeHasRefAssetsOnly()
-		);
-	
-	FString SaveVersionDir = FPaths::Combine(ExportReleaseSettings->GetSavePath(), ExportReleaseSettings->GetVersionId());
-
-	FString SaveToJson;
-	if (UFlibPatchParserHelper::SerializeHotPatcherVersionToString(ExportVersion, SaveToJson))
-	{
-		
-		FString SaveToFile = FPaths::Combine(
-			SaveVersionDir,
-			FString::Printf(TEXT("%s_Release.json"), *ExportReleaseSettings->GetVersionId())
-		);
-		bool runState = UFLibAssetManageHelperEx::SaveStringToFile(SaveToFile,SaveToJson);
-		if (runState)
-		{
-			auto Message = LOCTEXT("ExportReleaseSuccessNotification", "Succeed to export HotPatcher Release Version.");
-			UFlibHotPatcherEditorHelper::CreateSaveFileNotify(Message, SaveToFile);
-		}
-		UE_LOG(LogTemp, Log, TEXT("HotPatcher Export RELEASE is %s."), runState ? TEXT("Success") : TEXT("FAILD"));
-	}
-	FString ConfigJson;
-	if (ExportReleaseSettings->SerializeReleaseConfigToString(ConfigJson))
-	{
-		FString SaveToFile = FPaths::Combine(
-			SaveVersionDir,
-			FString::Printf(TEXT("%s_ReleaseConfig.json"), *ExportReleaseSettings->GetVersionId())
-		);
-		bool runState = UFLibAssetManageHelperEx::SaveStringToFile(SaveToFile, ConfigJson);
-		if (runState)
-		{
-			auto Message = LOCTEXT("ExportReleaseConfigSuccessNotification", "Succeed to export HotPatcher Release Config.");
-			UFlibHotPatcherEditorHelper::CreateSaveFileNotify(Message, SaveToFile);
-		}
-		UE_LOG(LogTemp, Log, TEXT("HotPatcher Export RELEASE CONFIG is %s."), runState ? TEXT("Success") : TEXT("FAILD"));
-	}
+	HOTPATCHER_TRACE_SCOPE(DoExportRelease);
+	RunPipeline(MakeShareable(new FExportReleasePipeline(ExportReleaseSettings.Get())), LOCTEXT("ExportReleasePipeline", "Export Release"));
 	return FReply::Handled();
 }
 
@@ -41,6 +41,7 @@ public:
 protected:
 	void CreateExportFilterListView();
 	bool CanExportRelease()const;
+	bool CanGenerateRelease()const;
 	FReply DoExportRelease();
 
 private:
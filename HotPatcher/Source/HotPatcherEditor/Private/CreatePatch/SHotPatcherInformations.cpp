@@ -1,15 +1,37 @@
 #include "SHotPatcherInformations.h"
+#include "IAssetRegistryQuery.h"
 
 // engine header
 #include "SHyperlink.h"
 #include "Widgets/Layout/SSeparator.h"
 #include "Widgets/SBoxPanel.h"
+#include "Widgets/Layout/SBox.h"
 #include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Views/SHeaderRow.h"
 #include "SGridPanel.h"
 #include "Widgets/Layout/SHeader.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
 #include "Internationalization/Internationalization.h"
+
+#define LOCTEXT_NAMESPACE "SHotPatcherInformations"
+
 void SHotPatcherInformations::Construct(const FArguments& InArgs)
 {
+	auto MakeChangeTypeCheckBox = [this](EHotPatcherDiffChange InChange, const FText& InLabel)
+	{
+		return SNew(SCheckBox)
+			.IsChecked(this, &SHotPatcherInformations::HandleChangeTypeIsChecked, InChange)
+			.OnCheckStateChanged(this, &SHotPatcherInformations::HandleChangeTypeCheckStateChanged, InChange)
+			.Padding(FMargin(4.0f, 0.0f))
+			[
+				SNew(STextBlock)
+				.Text(InLabel)
+			];
+	};
+
 	ChildSlot
 	[
 
@@ -19,23 +41,102 @@ void SHotPatcherInformations::Construct(const FArguments& InArgs)
 		.Padding(8.0)
 		.BodyContent()
 		[
-			SNew(SOverlay)
-			+ SOverlay::Slot()
-			.HAlign(HAlign_Fill)
-			.VAlign(VAlign_Fill)
+			SAssignNew(ContentSwitcher, SWidgetSwitcher)
+			+ SWidgetSwitcher::Slot()
 			[
-				SNew(SHorizontalBox)
-				+SHorizontalBox::Slot()
+				SNew(SOverlay)
+				+ SOverlay::Slot()
+				.HAlign(HAlign_Fill)
 				.VAlign(VAlign_Fill)
-				.FillWidth(1.0)
 				[
-					SNew(SVerticalBox)
-					+ SVerticalBox::Slot()
-					.HAlign(HAlign_Left)
-					.Padding(4, 4, 10, 4)
+					SNew(SHorizontalBox)
+					+SHorizontalBox::Slot()
+					.VAlign(VAlign_Fill)
+					.FillWidth(1.0)
+					[
+						SNew(SVerticalBox)
+						+ SVerticalBox::Slot()
+						.HAlign(HAlign_Left)
+						.Padding(4, 4, 10, 4)
+						[
+							SAssignNew(MulitText, SMultiLineEditableText)
+							.IsReadOnly(true)
+						]
+					]
+				]
+			]
+			+ SWidgetSwitcher::Slot()
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4, 4, 10, 4)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.FillWidth(1.0f)
+					.VAlign(VAlign_Center)
+					[
+						SNew(SSearchBox)
+						.HintText(LOCTEXT("DiffFilterHint", "Filter assets and files"))
+						.OnTextChanged(this, &SHotPatcherInformations::HandleFilterTextChanged)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.VAlign(VAlign_Center)
+					.Padding(8.0f, 0.0f, 0.0f, 0.0f)
+					[
+						MakeChangeTypeCheckBox(EHotPatcherDiffChange::Add, LOCTEXT("DiffAdded", "Added"))
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.VAlign(VAlign_Center)
+					[
+						MakeChangeTypeCheckBox(EHotPatcherDiffChange::Modify, LOCTEXT("DiffModified", "Modified"))
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.VAlign(VAlign_Center)
+					[
+						MakeChangeTypeCheckBox(EHotPatcherDiffChange::Delete, LOCTEXT("DiffDeleted", "Deleted"))
+					]
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4, 0, 10, 4)
+				[
+					SNew(STextBlock)
+					.Text(this, &SHotPatcherInformations::HandleSummaryText)
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4, 0, 10, 4)
+				[
+					// the height is fixed,the panel is in a scroll box,only the visible rows are generated
+					SNew(SBox)
+					.HeightOverride(480.0f)
 					[
-						SAssignNew(MulitText, SMultiLineEditableText)
-						.IsReadOnly(true)
+						SAssignNew(DiffTreeView, STreeView<TSharedPtr<FHotPatcherDiffItem>>)
+						.HeaderRow(
+						SNew(SHeaderRow)
+
+						+ SHeaderRow::Column("Name")
+						.DefaultLabel(LOCTEXT("DiffNameColumnHeader", "Name"))
+						.FillWidth(0.6f)
+
+						+ SHeaderRow::Column("Type")
+						.DefaultLabel(LOCTEXT("DiffTypeColumnHeader", "Type"))
+						.FillWidth(0.25f)
+
+						+ SHeaderRow::Column("Size")
+						.DefaultLabel(LOCTEXT("DiffSizeColumnHeader", "Size"))
+						.FillWidth(0.15f)
+						)
+						.ItemHeight(16.0f)
+						.TreeItemsSource(&FilteredDiffItems)
+						.OnGenerateRow(this, &SHotPatcherInformations::HandleDiffTreeGenerateRow)
+						.OnGetChildren(this, &SHotPatcherInformations::HandleDiffTreeGetChildren)
+						.SelectionMode(ESelectionMode::Multi)
 					]
 				]
 			]
@@ -51,4 +152,201 @@ void SHotPatcherInformations::SetExpanded(bool InExpand)
 void SHotPatcherInformations::SetContent(const FString& InContent)
 {
 	MulitText->SetText(FText::FromString(InContent));
-}
\ No newline at end of file
+	ContentSwitcher->SetActiveWidgetIndex(0);
+	// release the diff items
+	DiffItems.Reset();
+	ApplyFilter();
+}
+
+void SHotPatcherInformations::SetDiff(
+	const FAssetDependenciesInfo& InAddAsset,
+	const FAssetDependenciesInfo& InModifyAsset,
+	const FAssetDependenciesInfo& InDeleteAsset,
+	const TArray<FExternAssetFileInfo>& InAddFiles,
+	const TArray<FExternAssetFileInfo>& InModifyFiles,
+	const TArray<FExternAssetFileInfo>& InDeleteFiles
+)
+{
+	DiffItems.Reset();
+	DiffItems.Add(MakeChangeTypeItem(EHotPatcherDiffChange::Add, InAddAsset, InAddFiles));
+	DiffItems.Add(MakeChangeTypeItem(EHotPatcherDiffChange::Modify, InModifyAsset, InModifyFiles));
+	DiffItems.Add(MakeChangeTypeItem(EHotPatcherDiffChange::Delete, InDeleteAsset, InDeleteFiles));
+	MulitText->SetText(FText::GetEmpty());
+	ContentSwitcher->SetActiveWidgetIndex(1);
+
+	ApplyFilter();
+	for (const auto& Item : DiffItems)
+	{
+		DiffTreeView->SetItemExpansion(Item, true);
+	}
+}
+
+TSharedPtr<FHotPatcherDiffItem> SHotPatcherInformations::MakeChangeTypeItem(
+	EHotPatcherDiffChange InChange,
+	const FAssetDependenciesInfo& InAssets,
+	const TArray<FExternAssetFileInfo>& InFiles
+)
+{
+	static const TCHAR* ChangeTypeNames[] = { TEXT("Added"), TEXT("Modified"), TEXT("Deleted") };
+
+	TSharedPtr<FHotPatcherDiffItem> ChangeTypeItem = MakeShareable(new FHotPatcherDiffItem);
+	ChangeTypeItem->ItemType = FHotPatcherDiffItem::EItemType::ChangeType;
+	ChangeTypeItem->Change = InChange;
+	ChangeTypeItem->Name = ChangeTypeNames[(uint8)InChange];
+
+	auto SortByName = [](const TSharedPtr<FHotPatcherDiffItem>& L, const TSharedPtr<FHotPatcherDiffItem>& R)
+	{
+		return L->Name < R->Name;
+	};
+
+	// the deleted assets aren't on disk,the size is unknown
+	const IAssetRegistryQuery& AssetRegistry = IAssetRegistryQuery::Get();
+	for (const auto& Module : InAssets.mDependencies)
+	{
+		TSharedPtr<FHotPatcherDiffItem> ModuleItem = MakeShareable(new FHotPatcherDiffItem);
+		ModuleItem->ItemType = FHotPatcherDiffItem::EItemType::Module;
+		ModuleItem->Change = InChange;
+		ModuleItem->Name = Module.Key;
+		ModuleItem->Children.Reserve(Module.Value.mDependAssetDetails.Num());
+		for (const auto& Asset : Module.Value.mDependAssetDetails)
+		{
+			TSharedPtr<FHotPatcherDiffItem> AssetItem = MakeShareable(new FHotPatcherDiffItem);
+			AssetItem->ItemType = FHotPatcherDiffItem::EItemType::Asset;
+			AssetItem->Change = InChange;
+			AssetItem->Name = Asset.Key;
+			AssetItem->Type = Asset.Value.mAssetType;
+			if (InChange != EHotPatcherDiffChange::Delete)
+			{
+				const FAssetPackageData* PackageData = AssetRegistry.GetAssetPackageData(*Asset.Key);
+				AssetItem->Size = PackageData ? PackageData->DiskSize : -1;
+			}
+			ModuleItem->Children.Add(AssetItem);
+		}
+		ModuleItem->Children.Sort(SortByName);
+		ChangeTypeItem->Children.Add(ModuleItem);
+	}
+	ChangeTypeItem->Children.Sort(SortByName);
+
+	if (InFiles.Num())
+	{
+		TSharedPtr<FHotPatcherDiffItem> FilesItem = MakeShareable(new FHotPatcherDiffItem);
+		FilesItem->ItemType = FHotPatcherDiffItem::EItemType::Module;
+		FilesItem->Change = InChange;
+		FilesItem->Name = TEXT("External Files");
+		for (const auto& File : InFiles)
+		{
+			TSharedPtr<FHotPatcherDiffItem> FileItem = MakeShareable(new FHotPatcherDiffItem);
+			FileItem->ItemType = FHotPatcherDiffItem::EItemType::ExternalFile;
+			FileItem->Change = InChange;
+			FileItem->Name = File.FilePath.FilePath;
+			FileItem->Type = File.MountPath;
+			if (InChange != EHotPatcherDiffChange::Delete)
+			{
+				FileItem->Size = IFileManager::Get().FileSize(*FPaths::ConvertRelativePathToFull(File.FilePath.FilePath));
+			}
+			FilesItem->Children.Add(FileItem);
+		}
+		FilesItem->Children.Sort(SortByName);
+		ChangeTypeItem->Children.Add(FilesItem);
+	}
+	return ChangeTypeItem;
+}
+
+void SHotPatcherInformations::ApplyFilter()
+{
+	FString Filter = FilterText.ToString();
+	FilteredDiffItems.Reset();
+
+	for (const auto& ChangeTypeItem : DiffItems)
+	{
+		ChangeTypeItem->FilteredChildren.Reset();
+		ChangeTypeItem->LeafNum = 0;
+		ChangeTypeItem->Size = 0;
+		for (const auto& GroupItem : ChangeTypeItem->Children)
+		{
+			GroupItem->FilteredChildren.Reset();
+			GroupItem->Size = 0;
+			for (const auto& LeafItem : GroupItem->Children)
+			{
+				if (Filter.IsEmpty() || LeafItem->Name.Contains(Filter))
+				{
+					GroupItem->FilteredChildren.Add(LeafItem);
+					GroupItem->Size += FMath::Max<int64>(LeafItem->Size, 0);
+				}
+			}
+			GroupItem->LeafNum = GroupItem->FilteredChildren.Num();
+			if (GroupItem->LeafNum)
+			{
+				ChangeTypeItem->FilteredChildren.Add(GroupItem);
+				ChangeTypeItem->LeafNum += GroupItem->LeafNum;
+				ChangeTypeItem->Size += GroupItem->Size;
+			}
+		}
+		// the count of the hidden change type is still shown in the summary
+		if (ChangeTypeItem->LeafNum && bChangeTypeVisible[(uint8)ChangeTypeItem->Change])
+		{
+			FilteredDiffItems.Add(ChangeTypeItem);
+		}
+	}
+
+	if (DiffTreeView.IsValid())
+	{
+		DiffTreeView->RequestTreeRefresh();
+	}
+}
+
+TSharedRef<ITableRow> SHotPatcherInformations::HandleDiffTreeGenerateRow(TSharedPtr<FHotPatcherDiffItem> InItem, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SHotPatcherDiffListRow, OwnerTable)
+		.Item(InItem)
+		.HighlightText(this, &SHotPatcherInformations::HandleHighlightText);
+}
+
+void SHotPatcherInformations::HandleDiffTreeGetChildren(TSharedPtr<FHotPatcherDiffItem> InItem, TArray<TSharedPtr<FHotPatcherDiffItem>>& OutChildren)
+{
+	OutChildren = InItem->FilteredChildren;
+}
+
+void SHotPatcherInformations::HandleFilterTextChanged(const FText& InFilterText)
+{
+	FilterText = InFilterText;
+	ApplyFilter();
+}
+
+FText SHotPatcherInformations::HandleHighlightText()const
+{
+	return FilterText;
+}
+
+ECheckBoxState SHotPatcherInformations::HandleChangeTypeIsChecked(EHotPatcherDiffChange InChange)const
+{
+	return bChangeTypeVisible[(uint8)InChange] ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SHotPatcherInformations::HandleChangeTypeCheckStateChanged(ECheckBoxState InNewState, EHotPatcherDiffChange InChange)
+{
+	bChangeTypeVisible[(uint8)InChange] = (InNewState == ECheckBoxState::Checked);
+	ApplyFilter();
+}
+
+FText SHotPatcherInformations::HandleSummaryText()const
+{
+	int32 LeafNums[(uint8)EHotPatcherDiffChange::Num] = { 0, 0, 0 };
+	int64 TotalSize = 0;
+	for (const auto& ChangeTypeItem : DiffItems)
+	{
+		LeafNums[(uint8)ChangeTypeItem->Change] = ChangeTypeItem->LeafNum;
+		if (ChangeTypeItem->Change != EHotPatcherDiffChange::Delete)
+		{
+			TotalSize += ChangeTypeItem->Size;
+		}
+	}
+	return FText::Format(LOCTEXT("DiffSummary", "Added: {0}  Modified: {1}  Deleted: {2}  Size: {3}"),
+		FText::AsNumber(LeafNums[(uint8)EHotPatcherDiffChange::Add]),
+		FText::AsNumber(LeafNums[(uint8)EHotPatcherDiffChange::Modify]),
+		FText::AsNumber(LeafNums[(uint8)EHotPatcherDiffChange::Delete]),
+		FText::AsMemory((uint64)TotalSize)
+	);
+}
+
+#undef LOCTEXT_NAMESPACE
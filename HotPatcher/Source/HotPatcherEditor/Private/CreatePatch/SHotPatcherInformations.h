@@ -1,11 +1,18 @@
-#pragma once 
+#pragma once
 
+#include "SHotPatcherDiffListRow.h"
+#include "FExternAssetFileInfo.h"
+#include "AssetManager/FAssetDependenciesInfo.h"
+
+// engine header
 #include "CoreMinimal.h"
 
 #include "SharedPointer.h"
 #include "IDetailsView.h"
 #include "PropertyEditorModule.h"
 #include "Widgets/Text/SMultiLineEditableText.h"
+#include "Widgets/Layout/SWidgetSwitcher.h"
+#include "Widgets/Views/STreeView.h"
 
 
 class SHotPatcherInformations
@@ -29,10 +36,46 @@ public:
 
 	void SetExpanded(bool InExpand);
 
+	// show the message text,e.g. the error of export
 	void SetContent(const FString& InContent);
 
+	// show the diff in the tree view,only the visible rows are generated
+	void SetDiff(
+		const FAssetDependenciesInfo& InAddAsset,
+		const FAssetDependenciesInfo& InModifyAsset,
+		const FAssetDependenciesInfo& InDeleteAsset,
+		const TArray<FExternAssetFileInfo>& InAddFiles,
+		const TArray<FExternAssetFileInfo>& InModifyFiles,
+		const TArray<FExternAssetFileInfo>& InDeleteFiles
+	);
+
+protected:
+	static TSharedPtr<FHotPatcherDiffItem> MakeChangeTypeItem(
+		EHotPatcherDiffChange InChange,
+		const FAssetDependenciesInfo& InAssets,
+		const TArray<FExternAssetFileInfo>& InFiles
+	);
+	// filter the assets and files by the text and change type,the empty groups are hidden
+	void ApplyFilter();
+
+	TSharedRef<ITableRow> HandleDiffTreeGenerateRow(TSharedPtr<FHotPatcherDiffItem> InItem, const TSharedRef<STableViewBase>& OwnerTable);
+	void HandleDiffTreeGetChildren(TSharedPtr<FHotPatcherDiffItem> InItem, TArray<TSharedPtr<FHotPatcherDiffItem>>& OutChildren);
+	void HandleFilterTextChanged(const FText& InFilterText);
+	FText HandleHighlightText()const;
+	ECheckBoxState HandleChangeTypeIsChecked(EHotPatcherDiffChange InChange)const;
+	void HandleChangeTypeCheckStateChanged(ECheckBoxState InNewState, EHotPatcherDiffChange InChange);
+	FText HandleSummaryText()const;
+
 private:
 
 	TSharedPtr<SExpandableArea> DiffAreaWidget;
+	TSharedPtr<SWidgetSwitcher> ContentSwitcher;
 	TSharedPtr<SMultiLineEditableText> MulitText;
-};
\ No newline at end of file
+
+	TSharedPtr<STreeView<TSharedPtr<FHotPatcherDiffItem>>> DiffTreeView;
+	// the change type items,Add,Modify,Delete
+	TArray<TSharedPtr<FHotPatcherDiffItem>> DiffItems;
+	TArray<TSharedPtr<FHotPatcherDiffItem>> FilteredDiffItems;
+	FText FilterText;
+	bool bChangeTypeVisible[(uint8)EHotPatcherDiffChange::Num] = { true, true, true };
+};
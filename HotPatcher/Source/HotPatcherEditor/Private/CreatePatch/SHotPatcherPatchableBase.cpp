@@ -20,6 +20,7 @@
 #include "Misc/SecureHash.h"
 #include "Misc/ScopedSlowTask.h"
 #include "HAL/FileManager.h"
+#include "Framework/Notifications/NotificationManager.h"
 
 #define LOCTEXT_NAMESPACE "SHotPatcherCreatePatch"
 
@@ -70,4 +71,72 @@ TArray<FString> SHotPatcherPatchableBase::SaveFileDialog()const
 	return SaveFilenames;
 }
 
-#undef LOCTEXT_NAMESPACE
\ No newline at end of file
+
+void SHotPatcherPatchableBase::RunPipeline(TSharedPtr<FHotPatcherPipeline, ESPMode::ThreadSafe> InPipeline, const FText& InTitle)
+{
+	if (IsPipelineRunning())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s is running."), *RunningPipelineTitle.ToString());
+		return;
+	}
+
+	RunningPipeline = InPipeline;
+	RunningPipelineTitle = InTitle;
+	RunningPipeline->ProgressDelegate.AddSP(this, &SHotPatcherPatchableBase::OnPipelineProgress);
+	RunningPipeline->FinishedDelegate.AddSP(this, &SHotPatcherPatchableBase::OnPipelineFinished);
+
+	if (PendingProgressPtr.IsValid())
+	{
+		PendingProgressPtr.Pin()->ExpireAndFadeout();
+	}
+	FNotificationInfo Info(InTitle);
+	Info.bFireAndForget = false;
+	Info.ButtonDetails.Add(FNotificationButtonInfo(LOCTEXT("PipelineNotificationCancelButton", "Cancel"), FText(),
+		FSimpleDelegate::CreateSP(this, &SHotPatcherPatchableBase::CancelPipeline),
+		SNotificationItem::CS_Pending
+	));
+	PendingProgressPtr = FSlateNotificationManager::Get().AddNotification(Info);
+	if (PendingProgressPtr.IsValid())
+	{
+		PendingProgressPtr.Pin()->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+
+	RunningPipeline->Start();
+}
+
+bool SHotPatcherPatchableBase::IsPipelineRunning()const
+{
+	return RunningPipeline.IsValid() && RunningPipeline->IsRunning();
+}
+
+void SHotPatcherPatchableBase::CancelPipeline()
+{
+	if (IsPipelineRunning())
+	{
+		RunningPipeline->Cancel();
+	}
+}
+
+void SHotPatcherPatchableBase::OnPipelineProgress(const FText& InMsg, float InPercent)
+{
+	TSharedPtr<SNotificationItem> NotificationItem = PendingProgressPtr.Pin();
+	if (NotificationItem.IsValid())
+	{
+		NotificationItem->SetText(FText::Format(LOCTEXT("PipelineNotificationProgress", "{0}: {1} ({2}%)"), RunningPipelineTitle, InMsg, FText::AsNumber(FMath::FloorToInt(InPercent * 100.f))));
+	}
+}
+
+void SHotPatcherPatchableBase::OnPipelineFinished(bool bInSuccessed, const FString& InErrorMsg)
+{
+	TSharedPtr<SNotificationItem> NotificationItem = PendingProgressPtr.Pin();
+	if (NotificationItem.IsValid())
+	{
+		NotificationItem->SetText(FText::Format(bInSuccessed ? LOCTEXT("PipelineSuccessedNotification", "{0} Finished!") : LOCTEXT("PipelineFaildNotification", "{0} Faild!"), RunningPipelineTitle));
+		NotificationItem->SetCompletionState(bInSuccessed ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+		NotificationItem->ExpireAndFadeout();
+		PendingProgressPtr.Reset();
+	}
+	UE_LOG(LogTemp, Log, TEXT("%s is %s."), *RunningPipelineTitle.ToString(), bInSuccessed ? TEXT("Success") : TEXT("FAILD"));
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -7,6 +7,7 @@
 #include "ExportPatchSettings.h"
 #include "SHotPatcherInformations.h"
 #include "IPatchableInterface.h"
+#include "ThreadUtils/FHotPatcherPipeline.hpp"
 
 // engine header
 #include "Interfaces/ITargetPlatform.h"
@@ -14,6 +15,7 @@
 #include "IDetailsView.h"
 #include "PropertyEditorModule.h"
 #include "Widgets/Text/SMultiLineEditableText.h"
+#include "Widgets/Notifications/SNotificationList.h"
 /**
  * Implements the cooked platforms panel.
  */
@@ -43,9 +45,22 @@ public:
 	TArray<FString> OpenFileDialog()const;
 	TArray<FString> SaveFileDialog()const;
 
+	// run the pipeline in the background,the progress is shown in a notification with the cancel button
+	void RunPipeline(TSharedPtr<FHotPatcherPipeline, ESPMode::ThreadSafe> InPipeline, const FText& InTitle);
+	bool IsPipelineRunning()const;
+	void CancelPipeline();
+
+protected:
+	void OnPipelineProgress(const FText& InMsg, float InPercent);
+	virtual void OnPipelineFinished(bool bInSuccessed, const FString& InErrorMsg);
+
 protected:
 
 	TSharedPtr<FHotPatcherCreatePatchModel> mCreatePatchModel;
 
+	TSharedPtr<FHotPatcherPipeline, ESPMode::ThreadSafe> RunningPipeline;
+	FText RunningPipelineTitle;
+	TWeakPtr<SNotificationItem> PendingProgressPtr;
+
 };
 
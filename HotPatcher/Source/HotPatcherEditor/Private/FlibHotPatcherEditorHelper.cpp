@@ -4,6 +4,7 @@
 #include "FlibHotPatcherEditorHelper.h"
 #include "CreatePatch/ExportPatchSettings.h"
 #include "CreatePatch/ExportReleaseSettings.h"
+#include "FHotPatcherProfiler.h"
 
 // engine header
 #include "Misc/SecureHash.h"
@@ -22,6 +23,12 @@ TArray<FString> UFlibHotPatcherEditorHelper::GetAllCookOption()
 
 void UFlibHotPatcherEditorHelper::CreateSaveFileNotify(const FText& InMsg, const FString& InSavedFile)
 {
+	// no slate in the commandlet
+	if (IsRunningCommandlet())
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s %s"), *InMsg.ToString(), *InSavedFile);
+		return;
+	}
 	auto Message = InMsg;
 	FNotificationInfo Info(Message);
 	Info.bFireAndForget = true;
@@ -90,6 +97,7 @@ FHotPatcherVersion UFlibHotPatcherEditorHelper::ExportReleaseVersionInfo(
 	bool InIncludeHasRefAssetsOnly
 )
 {
+	HOTPATCHER_SCOPED_TIMER(TEXT("ExportReleaseVersionInfo"));
 	FHotPatcherVersion ExportVersion;
 	{
 		ExportVersion.VersionId = InVersionId;
@@ -215,6 +223,10 @@ TSharedPtr<UExportPatchSettings> UFlibHotPatcherEditorHelper::DeserializePatchCo
 {
 #define DESERIAL_BOOL_BY_NAME(SettingObject,JsonObject,MemberName) SettingObject->MemberName = JsonObject->GetBoolField(TEXT(#MemberName));
 #define DESERIAL_STRING_BY_NAME(SettingObject,JsonObject,MemberName) SettingObject->MemberName = JsonObject->GetStringField(TEXT(#MemberName));
+// the field may not exist in the old config
+#define TRY_DESERIAL_BOOL_BY_NAME(SettingObject,JsonObject,MemberName) JsonObject->TryGetBoolField(TEXT(#MemberName),SettingObject->MemberName);
+#define TRY_DESERIAL_STRING_BY_NAME(SettingObject,JsonObject,MemberName) JsonObject->TryGetStringField(TEXT(#MemberName),SettingObject->MemberName);
+#define TRY_DESERIAL_INT_BY_NAME(SettingObject,JsonObject,MemberName) JsonObject->TryGetNumberField(TEXT(#MemberName),SettingObject->MemberName);
 	TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(InContent);
 	TSharedPtr<FJsonObject> JsonObject;
 	if (FJsonSerializer::Deserialize(JsonReader, JsonObject))
@@ -245,6 +257,8 @@ TSharedPtr<UExportPatchSettings> UFlibHotPatcherEditorHelper::DeserializePatchCo
 			InNewSetting->AssetIgnoreFilters = ParserAssetFilter(TEXT("AssetIgnoreFilters"));
 
 			DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bIncludeHasRefAssetsOnly);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bCheckInValidAssets);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bForceRefreshAssetRegistry);
 
 			// PatcherSprcifyAsset
 			{
@@ -360,9 +374,24 @@ TSharedPtr<UExportPatchSettings> UFlibHotPatcherEditorHelper::DeserializePatchCo
 				}
 				InNewSetting->PakTargetPlatforms = FinalTargetPlatforms;
 			}
+			TRY_DESERIAL_INT_BY_NAME(InNewSetting, JsonObject, MaxPakProcessNum);
+			TRY_DESERIAL_INT_BY_NAME(InNewSetting, JsonObject, PakProcessMemoryMB);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bUseInProcessPakWriter);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bSkipUnchangedPaks);
+			JsonObject->TryGetStringField(TEXT("PakBuildCacheDir"), InNewSetting->PakBuildCacheDir.Path);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bUsePakBlockCache);
+			JsonObject->TryGetStringField(TEXT("PakBlockCacheDir"), InNewSetting->PakBlockCacheDir.Path);
+			TRY_DESERIAL_INT_BY_NAME(InNewSetting, JsonObject, MaxPakChunkSizeMB);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bSharedPakForIdenticalContent);
+			JsonObject->TryGetStringField(TEXT("PakOrderFile"), InNewSetting->PakOrderFile.FilePath);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bOrderByMapDependencies);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bCreateDeltaFromBasePaks);
+			JsonObject->TryGetStringField(TEXT("DeltaBasePaksDir"), InNewSetting->DeltaBasePaksDir.Path);
 			DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bSavePakList);
 			DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bSaveDiffAnalysis);
 			DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bSavePatchConfig);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bCompressVersionFiles);
+			TRY_DESERIAL_STRING_BY_NAME(InNewSetting, JsonObject, VersionFilesCompressionFormat);
 
 			InNewSetting->SavePath.Path = JsonObject->GetStringField(TEXT("SavePath"));
 		}
@@ -370,6 +399,9 @@ TSharedPtr<UExportPatchSettings> UFlibHotPatcherEditorHelper::DeserializePatchCo
 
 #undef DESERIAL_BOOL_BY_NAME
 #undef DESERIAL_STRING_BY_NAME
+#undef TRY_DESERIAL_BOOL_BY_NAME
+#undef TRY_DESERIAL_STRING_BY_NAME
+#undef TRY_DESERIAL_INT_BY_NAME
 	return InNewSetting;
 }
 
@@ -407,6 +439,8 @@ bool UFlibHotPatcherEditorHelper::SerializePatchConfigToJsonObject(const UExport
 	SerializeArrayLambda(ConvDirPathsToStrings(InPatchSetting->AssetIncludeFilters), TEXT("AssetIncludeFilters"));
 	SerializeArrayLambda(ConvDirPathsToStrings(InPatchSetting->AssetIgnoreFilters), TEXT("AssetIgnoreFilters"));
 	OutJsonObject->SetBoolField(TEXT("bIncludeHasRefAssetsOnly"), InPatchSetting->IsIncludeHasRefAssetsOnly());
+	OutJsonObject->SetBoolField(TEXT("bCheckInValidAssets"), InPatchSetting->IsCheckInValidAssets());
+	OutJsonObject->SetBoolField(TEXT("bForceRefreshAssetRegistry"), InPatchSetting->IsForceRefreshAssetRegistry());
 
 	// serialize specify asset
 	{
@@ -474,10 +508,25 @@ bool UFlibHotPatcherEditorHelper::SerializePatchConfigToJsonObject(const UExport
 		}
 		SerializeArrayLambda(AllPlatforms, TEXT("PakTargetPlatforms"));
 	}
+	OutJsonObject->SetNumberField(TEXT("MaxPakProcessNum"), InPatchSetting->GetMaxPakProcessNum());
+	OutJsonObject->SetNumberField(TEXT("PakProcessMemoryMB"), InPatchSetting->GetPakProcessMemoryMB());
+	OutJsonObject->SetBoolField(TEXT("bUseInProcessPakWriter"), InPatchSetting->IsUseInProcessPakWriter());
+	OutJsonObject->SetBoolField(TEXT("bSkipUnchangedPaks"), InPatchSetting->IsSkipUnchangedPaks());
+	OutJsonObject->SetStringField(TEXT("PakBuildCacheDir"), InPatchSetting->PakBuildCacheDir.Path);
+	OutJsonObject->SetBoolField(TEXT("bUsePakBlockCache"), InPatchSetting->bUsePakBlockCache);
+	OutJsonObject->SetStringField(TEXT("PakBlockCacheDir"), InPatchSetting->PakBlockCacheDir.Path);
+	OutJsonObject->SetNumberField(TEXT("MaxPakChunkSizeMB"), InPatchSetting->GetMaxPakChunkSizeMB());
+	OutJsonObject->SetBoolField(TEXT("bSharedPakForIdenticalContent"), InPatchSetting->IsSharedPakForIdenticalContent());
+	OutJsonObject->SetStringField(TEXT("PakOrderFile"), InPatchSetting->GetPakOrderFile());
+	OutJsonObject->SetBoolField(TEXT("bOrderByMapDependencies"), InPatchSetting->IsOrderByMapDependencies());
+	OutJsonObject->SetBoolField(TEXT("bCreateDeltaFromBasePaks"), InPatchSetting->IsCreateDeltaFromBasePaks());
+	OutJsonObject->SetStringField(TEXT("DeltaBasePaksDir"), InPatchSetting->DeltaBasePaksDir.Path);
 
 	OutJsonObject->SetBoolField(TEXT("bSavePakList"), InPatchSetting->IsSavePakList());
 	OutJsonObject->SetBoolField(TEXT("bSaveDiffAnalysis"), InPatchSetting->IsSaveDiffAnalysis());
 	OutJsonObject->SetBoolField(TEXT("bSavePatchConfig"), InPatchSetting->IsSavePatchConfig());
+	OutJsonObject->SetBoolField(TEXT("bCompressVersionFiles"), InPatchSetting->IsCompressVersionFiles());
+	OutJsonObject->SetStringField(TEXT("VersionFilesCompressionFormat"), InPatchSetting->GetVersionFilesCompressionFormat().ToString());
 	OutJsonObject->SetStringField(TEXT("SavePath"), InPatchSetting->GetSaveAbsPath());
 
 	return true;
@@ -551,6 +600,10 @@ bool UFlibHotPatcherEditorHelper::SerializeReleaseConfigToJsonObject(const UExpo
 	}
 
 	OutJsonObject->SetBoolField(TEXT("bSaveReleaseConfig"), InReleaseSetting->IsSaveConfig());
+	OutJsonObject->SetBoolField(TEXT("bMemoryBoundedAnalysis"), InReleaseSetting->IsMemoryBoundedAnalysis());
+	OutJsonObject->SetNumberField(TEXT("AnalysisMemoryBudgetMB"), InReleaseSetting->AnalysisMemoryBudgetMB);
+	OutJsonObject->SetBoolField(TEXT("bCompressVersionFiles"), InReleaseSetting->IsCompressVersionFiles());
+	OutJsonObject->SetStringField(TEXT("VersionFilesCompressionFormat"), InReleaseSetting->GetVersionFilesCompressionFormat().ToString());
 	OutJsonObject->SetStringField(TEXT("SavePath"), InReleaseSetting->GetSavePath());
 
 	return true;
@@ -560,6 +613,9 @@ TSharedPtr<class UExportReleaseSettings> UFlibHotPatcherEditorHelper::Deserializ
 {
 #define DESERIAL_BOOL_BY_NAME(SettingObject,JsonObject,MemberName) SettingObject->MemberName = JsonObject->GetBoolField(TEXT(#MemberName));
 #define DESERIAL_STRING_BY_NAME(SettingObject,JsonObject,MemberName) SettingObject->MemberName = JsonObject->GetStringField(TEXT(#MemberName));
+// the field may not exist in the old config
+#define TRY_DESERIAL_BOOL_BY_NAME(SettingObject,JsonObject,MemberName) JsonObject->TryGetBoolField(TEXT(#MemberName),SettingObject->MemberName);
+#define TRY_DESERIAL_STRING_BY_NAME(SettingObject,JsonObject,MemberName) JsonObject->TryGetStringField(TEXT(#MemberName),SettingObject->MemberName);
 	TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(InContent);
 	TSharedPtr<FJsonObject> JsonObject;
 	if (FJsonSerializer::Deserialize(JsonReader, JsonObject))
@@ -649,12 +705,18 @@ TSharedPtr<class UExportReleaseSettings> UFlibHotPatcherEditorHelper::Deserializ
 			}
 
 			InNewSetting->bSaveReleaseConfig = JsonObject->GetBoolField(TEXT("bSaveReleaseConfig"));
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bMemoryBoundedAnalysis);
+			JsonObject->TryGetNumberField(TEXT("AnalysisMemoryBudgetMB"), InNewSetting->AnalysisMemoryBudgetMB);
+			TRY_DESERIAL_BOOL_BY_NAME(InNewSetting, JsonObject, bCompressVersionFiles);
+			TRY_DESERIAL_STRING_BY_NAME(InNewSetting, JsonObject, VersionFilesCompressionFormat);
 			InNewSetting->SavePath.Path = JsonObject->GetStringField(TEXT("SavePath"));
 		}
 	}
 
 #undef DESERIAL_BOOL_BY_NAME
 #undef DESERIAL_STRING_BY_NAME
+#undef TRY_DESERIAL_BOOL_BY_NAME
+#undef TRY_DESERIAL_STRING_BY_NAME
 	return InNewSetting;
 }
 
@@ -4,6 +4,8 @@
 #include "HotPatcherStyle.h"
 #include "HotPatcherCommands.h"
 #include "SHotPatcher.h"
+#include "BuildServer/FHotPatcherBuildServer.h"
+#include "FAssetRegistryChangeTracker.h"
 
 #include "Misc/MessageDialog.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
@@ -11,6 +13,8 @@
 #include "LevelEditor.h"
 #include "HAL/FileManager.h"
 #include "Interfaces/IPluginManager.h"
+#include "AssetRegistryModule.h"
+#include "Misc/CommandLine.h"
 
 
 static const FName HotPatcherTabName("HotPatcher");
@@ -21,9 +25,16 @@ void FHotPatcherEditorModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	
+	// the commandlet runs without the editor ui
+	if (IsRunningCommandlet())
+		return;
+
 	FHotPatcherStyle::Initialize();
 	FHotPatcherStyle::ReloadTextures();
 
+	// the asset manager database is only refreshed if the assets changed between exports
+	FAssetRegistryChangeTracker::Get().StartTracking();
+
 	FHotPatcherCommands::Register();
 	
 	PluginCommands = MakeShareable(new FUICommandList);
@@ -52,12 +63,47 @@ void FHotPatcherEditorModule::StartupModule()
 		.SetDisplayName(LOCTEXT("FHotPatcherTabTitle", "HotPatcher"))
 		.SetMenuType(ETabSpawnerMenuType::Hidden);
 
+	// export by the requests of local client in the running editor
+	int32 BuildServerPort = FHotPatcherBuildServer::GetDefaultPort();
+	if (FParse::Param(FCommandLine::Get(), TEXT("HotPatcherBuildServer")) || FParse::Value(FCommandLine::Get(), TEXT("HotPatcherBuildServer="), BuildServerPort))
+	{
+		BuildServer = MakeShareable(new FHotPatcherBuildServer);
+		// the asset registry is ready after the editor started
+		BuildServerTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, BuildServerPort](float)
+		{
+			IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+			if (!AssetRegistry.IsLoadingAssets())
+			{
+				if (!BuildServer->IsRunning() && !BuildServer->Start(BuildServerPort))
+				{
+					BuildServer.Reset();
+					return false;
+				}
+				BuildServer->Tick();
+				if (BuildServer->IsStopRequested())
+				{
+					BuildServer.Reset();
+					return false;
+				}
+			}
+			return true;
+		}));
+	}
+
 }
 
 void FHotPatcherEditorModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	if (IsRunningCommandlet())
+		return;
+	if (BuildServer.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(BuildServerTickHandle);
+		BuildServer.Reset();
+	}
+	FAssetRegistryChangeTracker::Get().StopTracking();
 	FHotPatcherStyle::Shutdown();
 
 	FHotPatcherCommands::Unregister();
@@ -0,0 +1,392 @@
+#pragma once
+#include "FHotPatcherProfiler.h"
+#include "CoreMinimal.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformProcess.h"
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FPipelineProgressDelegate, const FText&, float);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FPipelineFinishedDelegate, bool, const FString&);
+
+// run the stages as a DAG,the stage declare the inputs and outputs,it runs after the stages produce the inputs
+// the independent stages run concurrently on the task graph workers,the game thread stage runs between the editor ticks
+// cancel is checked at the stage boundary,the critical path is logged when finished
+class FHotPatcherPipeline : public TSharedFromThis<FHotPatcherPipeline, ESPMode::ThreadSafe>
+{
+public:
+	// return false to stop the pipeline
+	using FStageFunc = TFunction<bool()>;
+
+	struct FStage
+	{
+		FString Name;
+		bool bGameThread = false;
+		TArray<FName> Inputs;
+		TArray<FName> Outputs;
+		FStageFunc Func;
+
+		// resolved when start
+		TArray<int32> Dependencies;
+		TArray<int32> Dependents;
+		int32 RemainingDependencies = 0;
+		bool bDispatched = false;
+		double BeginTime = 0.0;
+		double EndTime = 0.0;
+	};
+
+	/**
+	 * @param InAmountOfWork same as FScopedSlowTask,the progress is the entered work / InAmountOfWork
+	 */
+	explicit FHotPatcherPipeline(float InAmountOfWork)
+		: mAmountOfWork(FMath::Max(InAmountOfWork, 1.f)), mCompletedWork(0.f), mRunningStageNum(0), mStartTime(0.0), bRunning(false), bCanceled(false), bFailed(false)
+	{}
+	virtual ~FHotPatcherPipeline() {}
+
+	// run after the stages produce the inputs,the input must be the output of a stage added before
+	void AddStage(const FString& InName, bool bInGameThread, const TArray<FName>& InInputs, const TArray<FName>& InOutputs, const FStageFunc& InFunc)
+	{
+		FStage Stage;
+		Stage.Name = InName;
+		Stage.bGameThread = bInGameThread;
+		Stage.Inputs = InInputs;
+		Stage.Outputs = InOutputs;
+		Stage.Func = InFunc;
+		mStages.Add(Stage);
+	}
+
+	// run after the last added stage
+	void AddStage(const FString& InName, bool bInGameThread, const FStageFunc& InFunc)
+	{
+		TArray<FName> Inputs;
+		if (mStages.Num())
+		{
+			Inputs.Add(*mStages.Last().Name);
+		}
+		AddStage(InName, bInGameThread, Inputs, TArray<FName>{ *InName }, InFunc);
+	}
+
+	// must be called on the game thread
+	void Start()
+	{
+		check(IsInGameThread());
+		if (bRunning)
+			return;
+		if (!ResolveDependencies())
+		{
+			FinishedDelegate.Broadcast(false, mErrorMsg);
+			return;
+		}
+		bRunning = true;
+		bCanceled = false;
+		bFailed = false;
+		mCompletedWork = 0.f;
+		mStartTime = FPlatformTime::Seconds();
+		OnStart();
+
+		TArray<int32> ReadyStages;
+		{
+			FScopeLock Lock(&mCriticalSection);
+			for (int32 StageIndex = 0; StageIndex < mStages.Num(); ++StageIndex)
+			{
+				if (!mStages[StageIndex].RemainingDependencies)
+				{
+					mStages[StageIndex].bDispatched = true;
+					ReadyStages.Add(StageIndex);
+				}
+			}
+			mRunningStageNum = ReadyStages.Num();
+		}
+		for (int32 StageIndex : ReadyStages)
+		{
+			DispatchStage(StageIndex);
+		}
+	}
+
+	// block the game thread until finished,the game thread stages are run here
+	// used by the commandlet,there is no editor tick to run them
+	bool RunSynchronously()
+	{
+		check(IsInGameThread());
+		bool bSuccessed = false;
+		FDelegateHandle FinishedHandle = FinishedDelegate.AddLambda([&bSuccessed](bool bInSuccessed, const FString&)
+		{
+			bSuccessed = bInSuccessed;
+		});
+		Start();
+		WaitForPipelines({ AsShared() });
+		FinishedDelegate.Remove(FinishedHandle);
+		return bSuccessed;
+	}
+
+	// block the game thread until all the started pipelines finished
+	static void WaitForPipelines(const TArray<TSharedRef<FHotPatcherPipeline, ESPMode::ThreadSafe>>& InPipelines)
+	{
+		check(IsInGameThread());
+		auto IsAnyRunning = [&InPipelines]()
+		{
+			return InPipelines.ContainsByPredicate([](const TSharedRef<FHotPatcherPipeline, ESPMode::ThreadSafe>& InPipeline) { return InPipeline->IsRunning(); });
+		};
+		while (IsAnyRunning())
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FPlatformProcess::Sleep(0.01f);
+		}
+	}
+
+	// thread safe,the running stage is canceled by the cancel handler
+	void Cancel()
+	{
+		if (!bRunning || bCanceled)
+			return;
+		bCanceled = true;
+		UE_LOG(LogTemp, Warning, TEXT("The pipeline is canceled."));
+
+		// keep locked,the stage can't clear the handler and destroy the work while calling it
+		FScopeLock Lock(&mCriticalSection);
+		for (const auto& CancelHandler : mCancelHandlers)
+		{
+			CancelHandler.Value();
+		}
+	}
+
+	bool IsRunning()const { return bRunning; }
+	bool IsCanceled()const { return bCanceled; }
+
+	// called by the stages,thread safe
+	void EnterProgressFrame(float InWork, const FText& InMsg)
+	{
+		float Percent = 0.f;
+		{
+			FScopeLock Lock(&mCriticalSection);
+			mCompletedWork = FMath::Min(mCompletedWork + InWork, mAmountOfWork);
+			Percent = mCompletedWork / mAmountOfWork;
+		}
+		TWeakPtr<FHotPatcherPipeline, ESPMode::ThreadSafe> WeakThis = AsShared();
+		RunOnGameThread([WeakThis, InMsg, Percent]()
+		{
+			TSharedPtr<FHotPatcherPipeline, ESPMode::ThreadSafe> Pipeline = WeakThis.Pin();
+			if (Pipeline.IsValid())
+			{
+				Pipeline->ProgressDelegate.Broadcast(InMsg, Percent);
+			}
+		});
+	}
+
+	// the error message is passed to the finished delegate
+	void Fail(const FString& InErrorMsg)
+	{
+		FScopeLock Lock(&mCriticalSection);
+		mErrorMsg.Append(InErrorMsg);
+	}
+
+	// the long running work of the calling stage can be stopped when cancel,e.g. kill the UnrealPak process
+	// nullptr to clear the handler
+	void SetCancelHandler(const TFunction<void()>& InCancelHandler)
+	{
+		FScopeLock Lock(&mCriticalSection);
+		const uint32 ThreadId = FPlatformTLS::GetCurrentThreadId();
+		if (InCancelHandler)
+		{
+			mCancelHandlers.Add(ThreadId, InCancelHandler);
+		}
+		else
+		{
+			mCancelHandlers.Remove(ThreadId);
+		}
+	}
+
+	static void RunOnGameThread(const TFunction<void()>& InFunc)
+	{
+		if (IsInGameThread())
+		{
+			InFunc();
+			return;
+		}
+		FFunctionGraphTask::CreateAndDispatchWhenReady(InFunc, TStatId(), nullptr, ENamedThreads::GameThread);
+	}
+
+public:
+	// broadcast on the game thread
+	FPipelineProgressDelegate ProgressDelegate;
+	FPipelineFinishedDelegate FinishedDelegate;
+
+protected:
+	// called on the game thread,before the first stage is dispatched and before the finished delegate is broadcast
+	virtual void OnStart() {}
+	virtual void OnFinish(bool bInSuccessed) {}
+
+	bool ResolveDependencies()
+	{
+		mErrorMsg.Empty();
+		TMap<FName, int32> OutputStageMap;
+		for (int32 StageIndex = 0; StageIndex < mStages.Num(); ++StageIndex)
+		{
+			FStage& Stage = mStages[StageIndex];
+			Stage.Dependencies.Reset();
+			Stage.Dependents.Reset();
+			Stage.bDispatched = false;
+			Stage.BeginTime = Stage.EndTime = 0.0;
+			for (const auto& Input : Stage.Inputs)
+			{
+				const int32* ProducerIndex = OutputStageMap.Find(Input);
+				if (!ProducerIndex)
+				{
+					mErrorMsg = FString::Printf(TEXT("The input %s of stage %s is not produced by the stages before.\n"), *Input.ToString(), *Stage.Name);
+					UE_LOG(LogTemp, Error, TEXT("%s"), *mErrorMsg);
+					return false;
+				}
+				Stage.Dependencies.AddUnique(*ProducerIndex);
+			}
+			for (int32 DependencyIndex : Stage.Dependencies)
+			{
+				mStages[DependencyIndex].Dependents.Add(StageIndex);
+			}
+			Stage.RemainingDependencies = Stage.Dependencies.Num();
+			for (const auto& Output : Stage.Outputs)
+			{
+				OutputStageMap.Add(Output, StageIndex);
+			}
+		}
+		return true;
+	}
+
+	void DispatchStage(int32 InStageIndex)
+	{
+		TSharedRef<FHotPatcherPipeline, ESPMode::ThreadSafe> SharedThis = AsShared();
+		FFunctionGraphTask::CreateAndDispatchWhenReady([SharedThis, InStageIndex]()
+		{
+			SharedThis->RunStage(InStageIndex);
+		},
+		TStatId(), nullptr, mStages[InStageIndex].bGameThread ? ENamedThreads::GameThread : ENamedThreads::AnyBackgroundThreadNormalTask);
+	}
+
+	void RunStage(int32 InStageIndex)
+	{
+		FStage& Stage = mStages[InStageIndex];
+		bool bSuccessed = false;
+		Stage.BeginTime = FPlatformTime::Seconds();
+		if (!bCanceled && !bFailed)
+		{
+			HOTPATCHER_SCOPED_TIMER(Stage.Name);
+			UE_LOG(LogTemp, Log, TEXT("Pipeline stage %s begin."), *Stage.Name);
+			bSuccessed = Stage.Func();
+			SetCancelHandler(nullptr);
+			UE_LOG(LogTemp, Log, TEXT("Pipeline stage %s is %s,take %.2fs."), *Stage.Name, bSuccessed ? TEXT("Success") : TEXT("FAILD"), FPlatformTime::Seconds() - Stage.BeginTime);
+		}
+		Stage.EndTime = FPlatformTime::Seconds();
+
+		// dispatch the stages whose inputs are all ready
+		TArray<int32> ReadyStages;
+		bool bAllFinished = false;
+		{
+			FScopeLock Lock(&mCriticalSection);
+			if (!bSuccessed)
+			{
+				bFailed = true;
+			}
+			if (!bFailed && !bCanceled)
+			{
+				for (int32 DependentIndex : Stage.Dependents)
+				{
+					FStage& Dependent = mStages[DependentIndex];
+					if (!--Dependent.RemainingDependencies && !Dependent.bDispatched)
+					{
+						Dependent.bDispatched = true;
+						ReadyStages.Add(DependentIndex);
+					}
+				}
+			}
+			mRunningStageNum += ReadyStages.Num() - 1;
+			bAllFinished = !mRunningStageNum;
+		}
+
+		for (int32 StageIndex : ReadyStages)
+		{
+			DispatchStage(StageIndex);
+		}
+		if (bAllFinished)
+		{
+			Finish();
+		}
+	}
+
+	// the chain of stages that decide the total time,from the last finished stage back through the latest finished dependency
+	void LogCriticalPath()const
+	{
+		int32 LastStageIndex = INDEX_NONE;
+		for (int32 StageIndex = 0; StageIndex < mStages.Num(); ++StageIndex)
+		{
+			if (mStages[StageIndex].bDispatched && (LastStageIndex == INDEX_NONE || mStages[StageIndex].EndTime > mStages[LastStageIndex].EndTime))
+			{
+				LastStageIndex = StageIndex;
+			}
+		}
+
+		TArray<int32> CriticalPath;
+		for (int32 StageIndex = LastStageIndex; StageIndex != INDEX_NONE;)
+		{
+			CriticalPath.Insert(StageIndex, 0);
+			int32 GateIndex = INDEX_NONE;
+			for (int32 DependencyIndex : mStages[StageIndex].Dependencies)
+			{
+				if (GateIndex == INDEX_NONE || mStages[DependencyIndex].EndTime > mStages[GateIndex].EndTime)
+				{
+					GateIndex = DependencyIndex;
+				}
+			}
+			StageIndex = GateIndex;
+		}
+
+		FString CriticalPathStr;
+		double CriticalPathTime = 0.0;
+		for (int32 StageIndex : CriticalPath)
+		{
+			const FStage& Stage = mStages[StageIndex];
+			CriticalPathTime += Stage.EndTime - Stage.BeginTime;
+			CriticalPathStr.Append(FString::Printf(TEXT("%s%s(%.2fs)"), CriticalPathStr.IsEmpty() ? TEXT("") : TEXT(" -> "), *Stage.Name, Stage.EndTime - Stage.BeginTime));
+		}
+		double TotalStageTime = 0.0;
+		for (const auto& Stage : mStages)
+		{
+			TotalStageTime += Stage.bDispatched ? Stage.EndTime - Stage.BeginTime : 0.0;
+		}
+		UE_LOG(LogTemp, Log, TEXT("Pipeline critical path: %s"), *CriticalPathStr);
+		UE_LOG(LogTemp, Log, TEXT("Pipeline take %.2fs,critical path %.2fs,all stages %.2fs."), FPlatformTime::Seconds() - mStartTime, CriticalPathTime, TotalStageTime);
+	}
+
+	void Finish()
+	{
+		TSharedRef<FHotPatcherPipeline, ESPMode::ThreadSafe> SharedThis = AsShared();
+		RunOnGameThread([SharedThis]()
+		{
+			SharedThis->LogCriticalPath();
+			FString ErrorMsg;
+			{
+				FScopeLock Lock(&SharedThis->mCriticalSection);
+				ErrorMsg = SharedThis->mErrorMsg;
+			}
+			bool bWasCanceled = SharedThis->bCanceled;
+			bool bSuccessed = !bWasCanceled && !SharedThis->bFailed;
+			SharedThis->OnFinish(bSuccessed);
+			SharedThis->bRunning = false;
+			SharedThis->FinishedDelegate.Broadcast(bSuccessed, bWasCanceled ? TEXT("Canceled.") : ErrorMsg);
+		});
+	}
+
+private:
+	TArray<FStage> mStages;
+	float mAmountOfWork;
+	float mCompletedWork;
+	FString mErrorMsg;
+	// the running stages may be canceled at the same time,key is the thread id of the stage
+	TMap<uint32, TFunction<void()>> mCancelHandlers;
+	FCriticalSection mCriticalSection;
+	int32 mRunningStageNum;
+	double mStartTime;
+	volatile bool bRunning;
+	volatile bool bCanceled;
+	volatile bool bFailed;
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include "FProcWorkerThread.hpp"
+#include "CoreMinimal.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/PlatformTime.h"
+#include "Templates/Function.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FProcJobStartedDelegate, const FString&);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FProcJobOutputMsgDelegate, const FString&, const FString&);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FProcJobFinishedDelegate, const FString&, bool);
+
+// run a group of process concurrently,limited by the max process num and the available memory
+class FProcWorkerPool
+{
+public:
+	struct FProcJob
+	{
+		FString JobName;
+		FString ProgramPath;
+		FString Params;
+		TSharedPtr<FProcWorkerThread> Worker;
+		bool bSuccessed = false;
+		double LaunchTime = 0.0;
+	};
+
+	/**
+	 * @param InMaxProcNum max running process,<=0 is the number of cores
+	 * @param InProcMemoryMB the memory expected by one process,a new process only launch when the available physical memory is enough
+	 */
+	explicit FProcWorkerPool(int32 InMaxProcNum, int32 InProcMemoryMB)
+		: mMaxProcNum(InMaxProcNum > 0 ? InMaxProcNum : FPlatformMisc::NumberOfCores()),
+		mProcMemory((uint64)FMath::Max(InProcMemoryMB, 0) * 1024 * 1024),
+		bCanceled(false)
+	{}
+
+	// the running process num shared by many pools,the pools launch process only if the total running num is less than the max process num
+	void SetSharedProcCounter(TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> InSharedProcCounter)
+	{
+		mSharedProcCounter = InSharedProcCounter;
+	}
+
+	void AddJob(const FString& InJobName, const FString& InProgramPath, const FString& InParams)
+	{
+		TSharedPtr<FProcJob> Job = MakeShareable(new FProcJob);
+		Job->JobName = InJobName;
+		Job->ProgramPath = InProgramPath;
+		Job->Params = InParams;
+		mPendingJobs.Add(Job);
+	}
+
+	// block the calling thread until all jobs finished,the finished delegate is broadcast on the calling thread
+	void Run()
+	{
+		while (mPendingJobs.Num() || mRunningJobs.Num())
+		{
+			for (int32 Index = mRunningJobs.Num() - 1; Index >= 0; --Index)
+			{
+				TSharedPtr<FProcJob> Job = mRunningJobs[Index];
+				if (Job->Worker->GetThreadStatus() != EThreadStatus::Busy)
+				{
+					Job->Worker->Join();
+					mRunningJobs.RemoveAt(Index);
+					if (mSharedProcCounter.IsValid())
+					{
+						mSharedProcCounter->Decrement();
+					}
+					JobFinishedDelegate.Broadcast(Job->JobName, Job->bSuccessed);
+				}
+			}
+
+			if (bCanceled)
+			{
+				for (const auto& Job : mRunningJobs)
+				{
+					Job->Worker->Cancel();
+				}
+				for (const auto& Job : mPendingJobs)
+				{
+					JobFinishedDelegate.Broadcast(Job->JobName, false);
+				}
+				mPendingJobs.Empty();
+			}
+
+			while (mPendingJobs.Num() && mRunningJobs.Num() < mMaxProcNum && (!mRunningJobs.Num() || HasEnoughMemory()) && AcquireSharedProc())
+			{
+				TSharedPtr<FProcJob> Job = mPendingJobs[0];
+				mPendingJobs.RemoveAt(0);
+				LaunchJob(Job);
+				mRunningJobs.Add(Job);
+				JobStartedDelegate.Broadcast(Job->JobName);
+			}
+
+			FPlatformProcess::Sleep(0.05f);
+		}
+	}
+
+	// can be called from any thread,the running process are killed by Run
+	void Cancel()
+	{
+		bCanceled = true;
+	}
+
+	bool IsCanceled()const { return bCanceled; }
+
+public:
+	FProcJobStartedDelegate JobStartedDelegate;
+	FProcJobOutputMsgDelegate JobOutputMsgDelegate;
+	FProcJobFinishedDelegate JobFinishedDelegate;
+
+protected:
+	bool AcquireSharedProc()
+	{
+		if (!mSharedProcCounter.IsValid())
+			return true;
+		if (mSharedProcCounter->Increment() > mMaxProcNum)
+		{
+			mSharedProcCounter->Decrement();
+			return false;
+		}
+		return true;
+	}
+
+	// the memory of the process just launched isn't resident yet,it's reserved until the ProcResidentSeconds passed
+	bool HasEnoughMemory()const
+	{
+		uint64 AvailablePhysical = FPlatformMemory::GetStats().AvailablePhysical;
+		double Now = FPlatformTime::Seconds();
+		uint64 ReservedMemory = 0;
+		for (const auto& Job : mRunningJobs)
+		{
+			if (Now - Job->LaunchTime < ProcResidentSeconds)
+			{
+				ReservedMemory += mProcMemory;
+			}
+		}
+		return AvailablePhysical >= ReservedMemory && AvailablePhysical - ReservedMemory >= mProcMemory;
+	}
+
+	void LaunchJob(TSharedPtr<FProcJob> InJob)
+	{
+		FProcJob* JobPtr = InJob.Get();
+		InJob->LaunchTime = FPlatformTime::Seconds();
+		InJob->Worker = MakeShareable(new FProcWorkerThread(*FString::Printf(TEXT("ProcWorker_%s"), *InJob->JobName), InJob->ProgramPath, InJob->Params));
+		InJob->Worker->ProcOutputMsgDelegate.AddLambda([this, JobPtr](const FString& InMsg)
+		{
+			JobOutputMsgDelegate.Broadcast(JobPtr->JobName, InMsg);
+		});
+		InJob->Worker->ProcSuccessedDelegate.AddLambda([JobPtr]()
+		{
+			JobPtr->bSuccessed = true;
+		});
+		InJob->Worker->Execute();
+	}
+
+public:
+	// the time of a new process to allocate its working memory
+	static constexpr double ProcResidentSeconds = 10.0;
+
+private:
+	int32 mMaxProcNum;
+	uint64 mProcMemory;
+	volatile bool bCanceled;
+	TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> mSharedProcCounter;
+	TArray<TSharedPtr<FProcJob>> mPendingJobs;
+	TArray<TSharedPtr<FProcJob>> mRunningJobs;
+};
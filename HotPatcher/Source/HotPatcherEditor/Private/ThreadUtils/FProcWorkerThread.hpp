@@ -55,9 +55,23 @@ public:
 				}
 			}
 
+			// flush the output after process exit
+			{
+				Line += FPlatformProcess::ReadPipe(mReadPipe);
+				TArray<FString> StringArray;
+				Line.ParseIntoArray(StringArray, TEXT("\n"), true);
+				for (auto& LastLine : StringArray)
+				{
+					LastLine.TrimEndInline();
+					ProcOutputMsgDelegate.Broadcast(LastLine);
+				}
+			}
+			FPlatformProcess::ClosePipe(mReadPipe, mWritePipe);
+
 			int32 ProcReturnCode;
 			if (FPlatformProcess::GetProcReturnCode(mProcessHandle,&ProcReturnCode))
 			{
+				mProcReturnCode = ProcReturnCode;
 				if (ProcReturnCode == 0)
 				{
 					ProcSuccessedDelegate.Broadcast();
@@ -97,6 +111,7 @@ public:
 
 	virtual uint32 GetProcesId()const { return mProcessID; }
 	virtual FProcHandle GetProcessHandle()const { return mProcessHandle; }
+	virtual int32 GetProcReturnCode()const { return mProcReturnCode; }
 
 public:
 	FProcStatusDelegate ProcBeginDelegate;
@@ -112,4 +127,5 @@ private:
 	void* mWritePipe;
 	uint32 mProcessID;
 	FProcHandle mProcessHandle;
+	int32 mProcReturnCode = -1;
 };
\ No newline at end of file
@@ -24,23 +24,28 @@ class FThread : public FRunnable
 public:
 	using FCallback = TFunction<void()>;
 	explicit FThread(const TCHAR *InThreadName, const FCallback& InRunFunc)
-		:mThreadName(InThreadName),mRunFunc(InRunFunc),mThreadStatus(EThreadStatus::InActive)
+		:mThreadName(InThreadName),mRunFunc(InRunFunc),mThread(nullptr),mThreadStatus(EThreadStatus::InActive)
 	{}
 
 	virtual void Execute()
 	{
 		if (GetThreadStatus() == EThreadStatus::InActive)
 		{
+			// set busy before the thread start,the Run may be finished before Create return
+			mThreadStatus = EThreadStatus::Busy;
 			mThread = FRunnableThread::Create(this, *mThreadName);
-			if (mThread)
+			if (!mThread)
 			{
-				mThreadStatus = EThreadStatus::Busy;
+				mThreadStatus = EThreadStatus::InActive;
 			}
 		}
 	}
 	virtual void Join()
 	{
-		mThread->WaitForCompletion();
+		if (mThread)
+		{
+			mThread->WaitForCompletion();
+		}
 	}
 
 	virtual uint32 Run()override
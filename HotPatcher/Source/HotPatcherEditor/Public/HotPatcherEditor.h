@@ -4,9 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Containers/Ticker.h"
 
 class FToolBarBuilder;
 class FMenuBuilder;
+class FHotPatcherBuildServer;
 
 class FHotPatcherEditorModule : public IModuleInterface
 {
@@ -28,4 +30,7 @@ private:
 	TSharedRef<class SDockTab> OnSpawnPluginTab(const class FSpawnTabArgs& InSpawnTabArgs);
 private:
 	TSharedPtr<class FUICommandList> PluginCommands;
+	// started by -HotPatcherBuildServer[=PORT]
+	TSharedPtr<FHotPatcherBuildServer> BuildServer;
+	FDelegateHandle BuildServerTickHandle;
 };
@@ -0,0 +1,387 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FHotPatcherDelta.h"
+
+// engine header
+#include "HAL/FileManager.h"
+#include "Misc/SecureHash.h"
+#include "Templates/UniquePtr.h"
+
+namespace HotPatcherDelta
+{
+	// max bytes of a add operation,the pending bytes in memory is bounded by it
+	const int32 MaxAddSize = 1024 * 1024;
+	const int32 ReadBufferSize = 8 * 1024 * 1024;
+	const int32 CopyBufferSize = 1024 * 1024;
+
+	struct FBlockDigest
+	{
+		uint8 Digest[16];
+	};
+
+	// rsync rolling checksum
+	FORCEINLINE void CalcRollingHash(const uint8* InData, int32 InSize, uint32& OutA, uint32& OutB)
+	{
+		OutA = 0;
+		OutB = 0;
+		for (int32 Index = 0; Index < InSize; ++Index)
+		{
+			OutA += InData[Index];
+			OutB += (uint32)(InSize - Index) * InData[Index];
+		}
+		OutA &= 0xffff;
+		OutB &= 0xffff;
+	}
+
+	FORCEINLINE uint32 GetWeakHash(uint32 InA, uint32 InB)
+	{
+		return (InA & 0xffff) | (InB << 16);
+	}
+
+	FORCEINLINE void CalcDigest(const uint8* InData, int32 InSize, FBlockDigest& OutDigest)
+	{
+		FMD5 Md5;
+		Md5.Update(InData, InSize);
+		Md5.Final(OutDigest.Digest);
+	}
+
+	bool HashFile(FArchive& InReader, uint8 OutHash[20])
+	{
+		TArray<uint8> Buffer;
+		Buffer.SetNumUninitialized(CopyBufferSize);
+		FSHA1 FileHash;
+		InReader.Seek(0);
+		int64 Remaining = InReader.TotalSize();
+		while (Remaining > 0 && !InReader.IsError())
+		{
+			int32 ReadSize = (int32)FMath::Min<int64>(Remaining, Buffer.Num());
+			InReader.Serialize(Buffer.GetData(), ReadSize);
+			FileHash.Update(Buffer.GetData(), ReadSize);
+			Remaining -= ReadSize;
+		}
+		FileHash.Final();
+		FileHash.GetHash(OutHash);
+		return !InReader.IsError();
+	}
+}
+
+void FHotPatcherDelta::FDeltaHeader::Serialize(FArchive& Ar)
+{
+	Ar << Magic;
+	Ar << Version;
+	Ar << BlockSize;
+	Ar << BaseSize;
+	Ar.Serialize(BaseHash, sizeof(BaseHash));
+	Ar << NewSize;
+	Ar.Serialize(NewHash, sizeof(NewHash));
+}
+
+bool FHotPatcherDelta::CreateDelta(const FString& InBaseFile, const FString& InNewFile, const FString& InDeltaFile, int32 InBlockSize)
+{
+	using namespace HotPatcherDelta;
+
+	TUniquePtr<FArchive> BaseReader(IFileManager::Get().CreateFileReader(*InBaseFile));
+	TUniquePtr<FArchive> NewReader(IFileManager::Get().CreateFileReader(*InNewFile));
+	if (!BaseReader || !NewReader)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't open %s or %s to create delta."), *InBaseFile, *InNewFile);
+		return false;
+	}
+
+	FDeltaHeader Header;
+	Header.BlockSize = InBlockSize > 64 ? InBlockSize : 64;
+	Header.BaseSize = BaseReader->TotalSize();
+	Header.NewSize = NewReader->TotalSize();
+	const int32 BlockSize = Header.BlockSize;
+
+	// signatures of the full blocks in base file
+	TMap<uint32, TArray<int32>> WeakHashBlocks;
+	TArray<FBlockDigest> BlockDigests;
+	{
+		TArray<uint8> Block;
+		Block.SetNumUninitialized(BlockSize);
+		FSHA1 BaseHash;
+		for (int64 BlockOffset = 0; BlockOffset < Header.BaseSize; BlockOffset += BlockSize)
+		{
+			int32 ReadSize = (int32)FMath::Min<int64>(BlockSize, Header.BaseSize - BlockOffset);
+			BaseReader->Serialize(Block.GetData(), ReadSize);
+			BaseHash.Update(Block.GetData(), ReadSize);
+			if (ReadSize == BlockSize)
+			{
+				uint32 A, B;
+				CalcRollingHash(Block.GetData(), BlockSize, A, B);
+				WeakHashBlocks.FindOrAdd(GetWeakHash(A, B)).Add(BlockDigests.Num());
+				CalcDigest(Block.GetData(), BlockSize, BlockDigests[BlockDigests.AddUninitialized()]);
+			}
+		}
+		BaseHash.Final();
+		BaseHash.GetHash(Header.BaseHash);
+		if (BaseReader->IsError())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Read %s faild."), *InBaseFile);
+			return false;
+		}
+	}
+	BaseReader.Reset();
+
+	TUniquePtr<FArchive> DeltaWriter(IFileManager::Get().CreateFileWriter(*InDeltaFile));
+	if (!DeltaWriter)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't create delta file %s."), *InDeltaFile);
+		return false;
+	}
+	// rewrite after the new file hash is known
+	Header.Serialize(*DeltaWriter);
+
+	// the bytes of new file in [BufferStart,BufferStart + Buffer.Num())
+	TArray<uint8> Buffer;
+	int64 BufferStart = 0;
+	int64 Pos = 0;
+	int64 AddStart = 0;
+	FSHA1 NewHash;
+
+	// read forward,only keep the bytes from the pending add operation
+	auto EnsureBuffer = [&](int64 InEnd)->bool
+	{
+		InEnd = FMath::Min(InEnd, Header.NewSize);
+		if (InEnd <= BufferStart + Buffer.Num())
+			return true;
+
+		Buffer.RemoveAt(0, (int32)(AddStart - BufferStart), false);
+		BufferStart = AddStart;
+
+		int64 BufferEnd = BufferStart + Buffer.Num();
+		int32 ReadSize = (int32)(FMath::Min(Header.NewSize, FMath::Max(InEnd, BufferEnd + ReadBufferSize)) - BufferEnd);
+		int32 OldNum = Buffer.Num();
+		Buffer.AddUninitialized(ReadSize);
+		NewReader->Serialize(Buffer.GetData() + OldNum, ReadSize);
+		NewHash.Update(Buffer.GetData() + OldNum, ReadSize);
+		return !NewReader->IsError();
+	};
+
+	int64 PendingCopyOffset = 0;
+	int64 PendingCopySize = 0;
+	auto FlushCopy = [&]()
+	{
+		if (PendingCopySize > 0)
+		{
+			uint8 Op = (uint8)EDeltaOp::Copy;
+			*DeltaWriter << Op;
+			*DeltaWriter << PendingCopyOffset;
+			*DeltaWriter << PendingCopySize;
+			PendingCopySize = 0;
+		}
+	};
+	auto FlushAdd = [&](int64 InEnd)
+	{
+		if (InEnd > AddStart)
+		{
+			FlushCopy();
+			uint8 Op = (uint8)EDeltaOp::Add;
+			int32 AddSize = (int32)(InEnd - AddStart);
+			*DeltaWriter << Op;
+			*DeltaWriter << AddSize;
+			DeltaWriter->Serialize(Buffer.GetData() + (AddStart - BufferStart), AddSize);
+		}
+		AddStart = InEnd;
+	};
+
+	bool bRunStatus = true;
+	bool bHashValid = false;
+	uint32 A = 0;
+	uint32 B = 0;
+	while (bRunStatus && Pos + BlockSize <= Header.NewSize)
+	{
+		// one more byte for rolling
+		if (!EnsureBuffer(Pos + BlockSize + 1))
+		{
+			bRunStatus = false;
+			break;
+		}
+		const uint8* Window = Buffer.GetData() + (Pos - BufferStart);
+		if (!bHashValid)
+		{
+			CalcRollingHash(Window, BlockSize, A, B);
+			bHashValid = true;
+		}
+
+		int32 MatchedBlock = INDEX_NONE;
+		if (const TArray<int32>* Candidates = WeakHashBlocks.Find(GetWeakHash(A, B)))
+		{
+			FBlockDigest WindowDigest;
+			CalcDigest(Window, BlockSize, WindowDigest);
+			for (int32 Candidate : *Candidates)
+			{
+				if (!FMemory::Memcmp(BlockDigests[Candidate].Digest, WindowDigest.Digest, sizeof(WindowDigest.Digest)))
+				{
+					MatchedBlock = Candidate;
+					break;
+				}
+			}
+		}
+
+		if (MatchedBlock != INDEX_NONE)
+		{
+			FlushAdd(Pos);
+			int64 BlockOffset = (int64)MatchedBlock * BlockSize;
+			if (PendingCopySize > 0 && PendingCopyOffset + PendingCopySize == BlockOffset)
+			{
+				PendingCopySize += BlockSize;
+			}
+			else
+			{
+				FlushCopy();
+				PendingCopyOffset = BlockOffset;
+				PendingCopySize = BlockSize;
+			}
+			Pos += BlockSize;
+			AddStart = Pos;
+			bHashValid = false;
+			continue;
+		}
+
+		if (Pos + BlockSize < Header.NewSize)
+		{
+			uint32 OutByte = Window[0];
+			uint32 InByte = Window[BlockSize];
+			A = (A - OutByte + InByte) & 0xffff;
+			B = (B - (uint32)BlockSize * OutByte + A) & 0xffff;
+		}
+		++Pos;
+		if (Pos - AddStart >= MaxAddSize)
+		{
+			FlushAdd(Pos);
+		}
+	}
+
+	if (bRunStatus)
+	{
+		bRunStatus = EnsureBuffer(Header.NewSize);
+		FlushAdd(Header.NewSize);
+		FlushCopy();
+		uint8 Op = (uint8)EDeltaOp::End;
+		*DeltaWriter << Op;
+
+		NewHash.Final();
+		NewHash.GetHash(Header.NewHash);
+		DeltaWriter->Seek(0);
+		Header.Serialize(*DeltaWriter);
+	}
+
+	bRunStatus = bRunStatus && !DeltaWriter->IsError();
+	DeltaWriter->Close();
+	if (!bRunStatus)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Create delta %s faild."), *InDeltaFile);
+		IFileManager::Get().Delete(*InDeltaFile);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Created delta %s(%lld bytes) from %s to %s(%lld bytes)."), *InDeltaFile, IFileManager::Get().FileSize(*InDeltaFile), *InBaseFile, *InNewFile, Header.NewSize);
+	return true;
+}
+
+bool FHotPatcherDelta::ApplyDelta(const FString& InBaseFile, const FString& InDeltaFile, const FString& InOutputFile)
+{
+	using namespace HotPatcherDelta;
+
+	TUniquePtr<FArchive> DeltaReader(IFileManager::Get().CreateFileReader(*InDeltaFile));
+	TUniquePtr<FArchive> BaseReader(IFileManager::Get().CreateFileReader(*InBaseFile));
+	if (!DeltaReader || !BaseReader)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't open %s or %s to apply delta."), *InBaseFile, *InDeltaFile);
+		return false;
+	}
+
+	FDeltaHeader Header;
+	Header.Serialize(*DeltaReader);
+	if (DeltaReader->IsError() || Header.Magic != DeltaMagic || Header.Version > DeltaVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a valid delta file."), *InDeltaFile);
+		return false;
+	}
+
+	// the base file must be the file used to create the delta
+	uint8 BaseHash[20];
+	if (BaseReader->TotalSize() != Header.BaseSize || !HashFile(*BaseReader, BaseHash) || FMemory::Memcmp(BaseHash, Header.BaseHash, sizeof(BaseHash)))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not the base file of delta %s."), *InBaseFile, *InDeltaFile);
+		return false;
+	}
+
+	TUniquePtr<FArchive> OutputWriter(IFileManager::Get().CreateFileWriter(*InOutputFile));
+	if (!OutputWriter)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't create %s."), *InOutputFile);
+		return false;
+	}
+
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(CopyBufferSize);
+	FSHA1 OutputHash;
+	auto CopyData = [&](FArchive& InReader, int64 InSize)
+	{
+		while (InSize > 0 && !InReader.IsError())
+		{
+			int32 ReadSize = (int32)FMath::Min<int64>(InSize, Buffer.Num());
+			InReader.Serialize(Buffer.GetData(), ReadSize);
+			OutputWriter->Serialize(Buffer.GetData(), ReadSize);
+			OutputHash.Update(Buffer.GetData(), ReadSize);
+			InSize -= ReadSize;
+		}
+	};
+
+	bool bRunStatus = false;
+	while (!DeltaReader->IsError() && !BaseReader->IsError() && !DeltaReader->AtEnd())
+	{
+		uint8 Op;
+		*DeltaReader << Op;
+		if (Op == (uint8)EDeltaOp::Copy)
+		{
+			int64 BaseOffset;
+			int64 CopySize;
+			*DeltaReader << BaseOffset;
+			*DeltaReader << CopySize;
+			if (BaseOffset < 0 || CopySize < 0 || BaseOffset + CopySize > Header.BaseSize)
+				break;
+			BaseReader->Seek(BaseOffset);
+			CopyData(*BaseReader, CopySize);
+		}
+		else if (Op == (uint8)EDeltaOp::Add)
+		{
+			int32 AddSize;
+			*DeltaReader << AddSize;
+			if (AddSize < 0)
+				break;
+			CopyData(*DeltaReader, AddSize);
+		}
+		else
+		{
+			bRunStatus = Op == (uint8)EDeltaOp::End;
+			break;
+		}
+	}
+
+	uint8 NewHash[20];
+	OutputHash.Final();
+	OutputHash.GetHash(NewHash);
+	bRunStatus = bRunStatus && !DeltaReader->IsError() && !BaseReader->IsError() && !OutputWriter->IsError() &&
+		OutputWriter->TotalSize() == Header.NewSize && !FMemory::Memcmp(NewHash, Header.NewHash, sizeof(NewHash));
+	bRunStatus = OutputWriter->Close() && bRunStatus;
+	if (!bRunStatus)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Apply delta %s to %s faild."), *InDeltaFile, *InBaseFile);
+		IFileManager::Get().Delete(*InOutputFile);
+	}
+	return bRunStatus;
+}
+
+bool FHotPatcherDelta::IsDeltaFile(const FString& InFile)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InFile));
+	if (!Reader || Reader->TotalSize() < (int64)sizeof(uint32))
+		return false;
+	uint32 Magic = 0;
+	*Reader << Magic;
+	return Magic == DeltaMagic;
+}
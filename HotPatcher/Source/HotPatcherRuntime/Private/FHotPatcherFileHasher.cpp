@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FHotPatcherFileHasher.h"
+#include "FHotPatcherProfiler.h"
+
+// engine header
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/FileManager.h"
+#include "Templates/UniquePtr.h"
+
+FHotPatcherFileHasher::FHotPatcherFileHasher(int32 InChunkSize)
+	: ChunkSize(InChunkSize > 0 ? InChunkSize : (int32)DefaultChunkSize), ChunkOffset(0), TotalSize(0)
+{}
+
+void FHotPatcherFileHasher::Update(const uint8* InData, int64 InSize)
+{
+	FileMd5.Update(InData, InSize);
+	TotalSize += InSize;
+
+	while (InSize > 0)
+	{
+		int64 UpdateSize = FMath::Min<int64>(InSize, ChunkSize - ChunkOffset);
+		ChunkMd5.Update(InData, UpdateSize);
+		ChunkOffset += UpdateSize;
+		InData += UpdateSize;
+		InSize -= UpdateSize;
+
+		if (ChunkOffset == ChunkSize)
+		{
+			FMD5Hash ChunkHash;
+			ChunkHash.Set(ChunkMd5);
+			ChunkHashes.Add(LexToString(ChunkHash));
+			ChunkMd5 = FMD5();
+			ChunkOffset = 0;
+		}
+	}
+}
+
+void FHotPatcherFileHasher::Final(FString& OutFileHash, TArray<FString>& OutChunkHashes)
+{
+	if (ChunkOffset > 0)
+	{
+		FMD5Hash ChunkHash;
+		ChunkHash.Set(ChunkMd5);
+		ChunkHashes.Add(LexToString(ChunkHash));
+		ChunkOffset = 0;
+	}
+	FMD5Hash FileHash;
+	FileHash.Set(FileMd5);
+	OutFileHash = LexToString(FileHash);
+	OutChunkHashes = ChunkHashes;
+}
+
+bool FHotPatcherFileHasher::HashFile(const FString& InFile, FString& OutFileHash, TArray<FString>& OutChunkHashes, int32 InChunkSize)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InFile));
+	if (!Reader)
+		return false;
+
+	FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::FilesHashed);
+	FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesRead, Reader->TotalSize());
+
+	FHotPatcherFileHasher Hasher(InChunkSize);
+	const int32 BufferSize = FMath::Min(Hasher.GetChunkSize(), 8 * 1024 * 1024);
+	TArray<uint8> Buffers[2];
+	Buffers[0].SetNumUninitialized(BufferSize);
+	Buffers[1].SetNumUninitialized(BufferSize);
+
+	// hash the last buffer on the task graph when read the next one
+	FGraphEventRef HashTask;
+	int64 Remaining = Reader->TotalSize();
+	int32 BufferIndex = 0;
+	while (Remaining > 0 && !Reader->IsError())
+	{
+		int32 ReadSize = (int32)FMath::Min<int64>(Remaining, BufferSize);
+		Reader->Serialize(Buffers[BufferIndex].GetData(), ReadSize);
+		Remaining -= ReadSize;
+
+		if (HashTask.IsValid())
+		{
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(HashTask);
+		}
+		const uint8* HashData = Buffers[BufferIndex].GetData();
+		HashTask = FFunctionGraphTask::CreateAndDispatchWhenReady([&Hasher, HashData, ReadSize]()
+		{
+			Hasher.Update(HashData, ReadSize);
+		}, TStatId());
+		BufferIndex = 1 - BufferIndex;
+	}
+	if (HashTask.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(HashTask);
+	}
+
+	if (Reader->IsError())
+		return false;
+	Hasher.Final(OutFileHash, OutChunkHashes);
+	return true;
+}
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FHotPatcherPakListWriter.h"
+#include "FHotPatcherProfiler.h"
+
+// engine header
+#include "HAL/FileManager.h"
+#include "Misc/CString.h"
+
+namespace
+{
+	const TCHAR PakCommandQuote[] = TEXT("\"");
+	const TCHAR PakCommandSeparator[] = TEXT("\" \"");
+	const TCHAR CookedMountPathPrefix[] = TEXT("\" \"../../../");
+}
+
+FHotPatcherPakListWriter::FHotPatcherPakListWriter(const FString& InPakListFile)
+	: PakListFile(InPakListFile), LineNum(0)
+{
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*PakListFile));
+	if (!Writer)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't create pak list file %s."), *PakListFile);
+	}
+	Buffer.Reserve(BufferSize + 4096);
+}
+
+FHotPatcherPakListWriter::~FHotPatcherPakListWriter()
+{
+	Close();
+}
+
+void FHotPatcherPakListWriter::SetCookedRootDir(const FString& InCookedRootDir)
+{
+	CookedAbsPathPrefix = PakCommandQuote + InCookedRootDir;
+	if (!CookedAbsPathPrefix.EndsWith(TEXT("/")))
+	{
+		CookedAbsPathPrefix.AppendChar(TEXT('/'));
+	}
+}
+
+void FHotPatcherPakListWriter::AddCookedFile(const FString& InCookedRelativeFile)
+{
+	Append(CookedAbsPathPrefix);
+	Append(InCookedRelativeFile);
+	Append(CookedMountPathPrefix, ARRAY_COUNT(CookedMountPathPrefix) - 1);
+	Append(InCookedRelativeFile);
+	Append(PakCommandQuote, ARRAY_COUNT(PakCommandQuote) - 1);
+	EndLine();
+}
+
+void FHotPatcherPakListWriter::AddPakCommand(const FString& InAbsPath, const FString& InMountPath)
+{
+	Append(PakCommandQuote, ARRAY_COUNT(PakCommandQuote) - 1);
+	Append(InAbsPath);
+	Append(PakCommandSeparator, ARRAY_COUNT(PakCommandSeparator) - 1);
+	Append(InMountPath);
+	Append(PakCommandQuote, ARRAY_COUNT(PakCommandQuote) - 1);
+	EndLine();
+}
+
+void FHotPatcherPakListWriter::AddLine(const FString& InLine)
+{
+	Append(InLine);
+	EndLine();
+}
+
+void FHotPatcherPakListWriter::Append(const TCHAR* InStr, int32 InLen)
+{
+	if (!Writer || InLen <= 0)
+		return;
+
+	// the paths are almost ascii,copy them directly
+	const int32 StartIndex = Buffer.AddUninitialized(InLen);
+	ANSICHAR* Dest = Buffer.GetData() + StartIndex;
+	int32 Index = 0;
+	for (; Index < InLen && InStr[Index] < 0x80; ++Index)
+	{
+		Dest[Index] = (ANSICHAR)InStr[Index];
+	}
+	if (Index < InLen)
+	{
+		Buffer.SetNum(StartIndex + Index, false);
+		FTCHARToUTF8 Converter(InStr + Index, InLen - Index);
+		Buffer.Append(Converter.Get(), Converter.Length());
+	}
+
+	if (Buffer.Num() >= BufferSize)
+	{
+		Flush();
+	}
+}
+
+void FHotPatcherPakListWriter::EndLine()
+{
+	Append(LINE_TERMINATOR, FCString::Strlen(LINE_TERMINATOR));
+	++LineNum;
+}
+
+void FHotPatcherPakListWriter::Flush()
+{
+	if (Writer && Buffer.Num())
+	{
+		Writer->Serialize(Buffer.GetData(), Buffer.Num());
+		FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesWritten, Buffer.Num());
+	}
+	Buffer.Reset();
+}
+
+bool FHotPatcherPakListWriter::Close()
+{
+	if (!Writer)
+		return false;
+
+	Flush();
+	bool bRunStatus = !Writer->IsError();
+	bRunStatus = Writer->Close() && bRunStatus;
+	Writer.Reset();
+	if (!bRunStatus)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Write pak list file %s faild."), *PakListFile);
+	}
+	return bRunStatus;
+}
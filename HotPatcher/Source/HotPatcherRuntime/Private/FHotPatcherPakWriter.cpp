@@ -0,0 +1,479 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FHotPatcherPakWriter.h"
+#include "FHotPatcherFileHasher.h"
+#include "FHotPatcherProfiler.h"
+
+// engine header
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/ArchiveProxy.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Templates/UniquePtr.h"
+
+namespace
+{
+	// the pak is written in order without seek,so the written bytes can be hashed on the fly
+	class FHashingArchive : public FArchiveProxy
+	{
+	public:
+		FHashingArchive(FArchive& InInnerArchive, FHotPatcherFileHasher& InHasher)
+			: FArchiveProxy(InInnerArchive), Hasher(InHasher) {}
+
+		virtual void Serialize(void* V, int64 Length) override
+		{
+			InnerArchive.Serialize(V, Length);
+			Hasher.Update((const uint8*)V, Length);
+		}
+
+	private:
+		FHotPatcherFileHasher& Hasher;
+	};
+}
+
+FHotPatcherPakWriter::FHotPatcherPakWriter(const FString& InPakFile, const FPakWriterOptions& InOptions)
+	: PakFile(InPakFile), Options(InOptions)
+{
+	if (Options.bCompress && !FCompression::IsFormatValid(Options.CompressionFormat))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Compression format %s is not available,use Zlib."), *Options.CompressionFormat.ToString());
+		Options.CompressionFormat = NAME_Zlib;
+	}
+	if (Options.CompressionBlockSize <= 0)
+	{
+		Options.CompressionBlockSize = FPakInfo::MaxChunkDataSize;
+	}
+}
+
+bool FHotPatcherPakWriter::Write(const TArray<FPakWriteEntry>& InEntries)
+{
+	if (!InEntries.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("No files to add to %s."), *PakFile);
+		return false;
+	}
+
+	const FString MountPoint = FHotPatcherPakWriter::GetCommonMountPoint(InEntries);
+
+	TUniquePtr<FArchive> PakWriter(IFileManager::Get().CreateFileWriter(*PakFile));
+	if (!PakWriter)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't create pak file %s."), *PakFile);
+		return false;
+	}
+
+	FHotPatcherFileHasher Hasher;
+	FHashingArchive HashingWriter(*PakWriter, Hasher);
+
+	TArray<FString> IndexFilenames;
+	TArray<FPakEntry> IndexEntries;
+	TSet<FString> AddedFiles;
+
+	int32 EntryIndex = 0;
+	while (EntryIndex < InEntries.Num())
+	{
+		// collect a batch of files limited by MaxBatchSize
+		TArray<FEntryPayload> Batch;
+		int64 BatchSize = 0;
+		while (EntryIndex < InEntries.Num() && (!Batch.Num() || BatchSize < Options.MaxBatchSize))
+		{
+			const FPakWriteEntry& Entry = InEntries[EntryIndex++];
+			if (AddedFiles.Contains(Entry.DestFile))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s is already added to pak,ignore %s."), *Entry.DestFile, *Entry.SourceFile);
+				continue;
+			}
+			AddedFiles.Add(Entry.DestFile);
+
+			int32 PayloadIndex = Batch.AddDefaulted();
+			Batch[PayloadIndex].Entry = &Entry;
+			BatchSize += FMath::Max<int64>(IFileManager::Get().FileSize(*Entry.SourceFile), 0);
+		}
+
+		if (!LoadAndCompressBatch(Batch))
+		{
+			PakWriter->Close();
+			IFileManager::Get().Delete(*PakFile);
+			return false;
+		}
+
+		for (auto& Payload : Batch)
+		{
+			FPakEntry PakEntry;
+			if (!WritePayload(HashingWriter, Payload, PakEntry))
+			{
+				UE_LOG(LogTemp, Error, TEXT("Write %s to pak faild."), *Payload.Entry->SourceFile);
+				PakWriter->Close();
+				IFileManager::Get().Delete(*PakFile);
+				return false;
+			}
+			IndexFilenames.Add(Payload.Entry->DestFile.Mid(MountPoint.Len()));
+			IndexEntries.Add(PakEntry);
+		}
+	}
+
+	// serialize pak index
+	TArray<uint8> IndexData;
+	{
+		FMemoryWriter IndexWriter(IndexData);
+		FString IndexMountPoint = MountPoint;
+		IndexWriter << IndexMountPoint;
+		int32 NumEntries = IndexEntries.Num();
+		IndexWriter << NumEntries;
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			IndexWriter << IndexFilenames[Index];
+			IndexEntries[Index].Serialize(IndexWriter, FPakInfo::PakFile_Version_Latest);
+		}
+	}
+
+	Info.IndexOffset = HashingWriter.Tell();
+	Info.IndexSize = IndexData.Num();
+	FSHA1::HashBuffer(IndexData.GetData(), IndexData.Num(), Info.IndexHash);
+	HashingWriter.Serialize(IndexData.GetData(), IndexData.Num());
+	Info.Serialize(HashingWriter, FPakInfo::PakFile_Version_Latest);
+
+	bool bRunStatus = !PakWriter->IsError();
+	bRunStatus = PakWriter->Close() && bRunStatus;
+	HashChunkSize = Hasher.GetChunkSize();
+	WrittenSize = Hasher.GetTotalSize();
+	FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesWritten, WrittenSize);
+	Hasher.Final(PakHash, ChunkHashes);
+	UE_LOG(LogTemp, Log, TEXT("Added %d files to %s,mount point is %s."), IndexEntries.Num(), *PakFile, *MountPoint);
+	return bRunStatus;
+}
+
+bool FHotPatcherPakWriter::LoadAndCompressBatch(TArray<FEntryPayload>& InOutBatch)const
+{
+	ParallelFor(InOutBatch.Num(), [&InOutBatch](int32 PayloadIndex)
+	{
+		FEntryPayload& Payload = InOutBatch[PayloadIndex];
+		Payload.bReadSuccessed = FFileHelper::LoadFileToArray(Payload.UncompressedData, *Payload.Entry->SourceFile);
+		FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesRead, Payload.UncompressedData.Num());
+	});
+
+	for (const auto& Payload : InOutBatch)
+	{
+		if (!Payload.bReadSuccessed)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Can't read %s."), *Payload.Entry->SourceFile);
+			return false;
+		}
+	}
+
+	if (!Options.bCompress)
+		return true;
+
+	// reuse the compressed blocks of unchanged files
+	const bool bUseBlockCache = !Options.BlockCacheDir.IsEmpty();
+	if (bUseBlockCache)
+	{
+		ParallelFor(InOutBatch.Num(), [this, &InOutBatch](int32 PayloadIndex)
+		{
+			FEntryPayload& Payload = InOutBatch[PayloadIndex];
+			if (Payload.UncompressedData.Num() >= FHotPatcherPakWriter::MinCachedFileSize)
+			{
+				FSHA1 DataHash;
+				DataHash.Update(Payload.UncompressedData.GetData(), Payload.UncompressedData.Num());
+				DataHash.Final();
+				uint8 Digest[20];
+				DataHash.GetHash(Digest);
+				Payload.CacheKey = FString::Printf(TEXT("%s_%s_%d"), *BytesToHex(Digest, sizeof(Digest)), *Options.CompressionFormat.ToString(), Options.CompressionBlockSize);
+				Payload.bCacheHit = LoadCachedBlocks(Payload);
+			}
+		});
+	}
+
+	// flatten all blocks of the batch,so large and small files share the worker pool
+	struct FBlockTask
+	{
+		int32 PayloadIndex;
+		int32 BlockIndex;
+	};
+	TArray<FBlockTask> BlockTasks;
+	for (int32 PayloadIndex = 0; PayloadIndex < InOutBatch.Num(); ++PayloadIndex)
+	{
+		FEntryPayload& Payload = InOutBatch[PayloadIndex];
+		if (Payload.bCacheHit)
+			continue;
+		int32 BlockNum = FMath::DivideAndRoundUp(Payload.UncompressedData.Num(), Options.CompressionBlockSize);
+		Payload.CompressedBlocks.SetNum(BlockNum);
+		for (int32 BlockIndex = 0; BlockIndex < BlockNum; ++BlockIndex)
+		{
+			BlockTasks.Add(FBlockTask{ PayloadIndex, BlockIndex });
+		}
+	}
+
+	TArray<bool> BlockStatus;
+	BlockStatus.SetNumZeroed(BlockTasks.Num());
+	const FName CompressionFormat = Options.CompressionFormat;
+	const int32 BlockSize = Options.CompressionBlockSize;
+	ParallelFor(BlockTasks.Num(), [&](int32 TaskIndex)
+	{
+		FEntryPayload& Payload = InOutBatch[BlockTasks[TaskIndex].PayloadIndex];
+		const int32 BlockIndex = BlockTasks[TaskIndex].BlockIndex;
+		const int32 BlockOffset = BlockIndex * BlockSize;
+		const int32 UncompressedBlockSize = FMath::Min(BlockSize, Payload.UncompressedData.Num() - BlockOffset);
+
+		TArray<uint8>& CompressedBlock = Payload.CompressedBlocks[BlockIndex];
+		int32 CompressedSize = FCompression::CompressMemoryBound(CompressionFormat, UncompressedBlockSize);
+		CompressedBlock.SetNumUninitialized(CompressedSize);
+		BlockStatus[TaskIndex] = FCompression::CompressMemory(CompressionFormat, CompressedBlock.GetData(), CompressedSize, Payload.UncompressedData.GetData() + BlockOffset, UncompressedBlockSize);
+		CompressedBlock.SetNum(CompressedSize, false);
+	});
+
+	for (int32 TaskIndex = 0; TaskIndex < BlockTasks.Num(); ++TaskIndex)
+	{
+		if (!BlockStatus[TaskIndex])
+		{
+			// store the file without compression
+			InOutBatch[BlockTasks[TaskIndex].PayloadIndex].CompressedBlocks.Empty();
+		}
+	}
+
+	for (auto& Payload : InOutBatch)
+	{
+		if (Payload.bCacheHit)
+			continue;
+		int64 TotalCompressedSize = 0;
+		for (const auto& CompressedBlock : Payload.CompressedBlocks)
+		{
+			TotalCompressedSize += CompressedBlock.Num();
+		}
+		// same as UnrealPak,keep the uncompressed data when compression is no benefit
+		Payload.bCompressed = Payload.CompressedBlocks.Num() > 0 && TotalCompressedSize < Payload.UncompressedData.Num();
+		if (!Payload.bCompressed)
+		{
+			Payload.CompressedBlocks.Empty();
+		}
+	}
+
+	if (bUseBlockCache)
+	{
+		ParallelFor(InOutBatch.Num(), [this, &InOutBatch](int32 PayloadIndex)
+		{
+			const FEntryPayload& Payload = InOutBatch[PayloadIndex];
+			if (!Payload.CacheKey.IsEmpty() && !Payload.bCacheHit)
+			{
+				SaveCachedBlocks(Payload);
+			}
+		});
+	}
+	return true;
+}
+
+FString FHotPatcherPakWriter::GetBlockCacheFile(const FString& InCacheKey)const
+{
+	return FPaths::Combine(Options.BlockCacheDir, InCacheKey.Left(2), InCacheKey + TEXT(".blocks"));
+}
+
+bool FHotPatcherPakWriter::LoadCachedBlocks(FEntryPayload& InOutPayload)const
+{
+	FString CacheFile = GetBlockCacheFile(InOutPayload.CacheKey);
+	TArray<uint8> CacheData;
+	if (!FPaths::FileExists(CacheFile) || !FFileHelper::LoadFileToArray(CacheData, *CacheFile))
+		return false;
+
+	FMemoryReader CacheReader(CacheData);
+	uint32 Magic = 0;
+	int64 UncompressedSize = 0;
+	TArray<TArray<uint8>> CompressedBlocks;
+	CacheReader << Magic;
+	CacheReader << UncompressedSize;
+	CacheReader << CompressedBlocks;
+	if (CacheReader.IsError() || Magic != FHotPatcherPakWriter::BlockCacheMagic || UncompressedSize != InOutPayload.UncompressedData.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid block cache %s."), *CacheFile);
+		return false;
+	}
+
+	// no blocks means the file is not compressible
+	InOutPayload.CompressedBlocks = MoveTemp(CompressedBlocks);
+	InOutPayload.bCompressed = InOutPayload.CompressedBlocks.Num() > 0;
+	return true;
+}
+
+bool FHotPatcherPakWriter::SaveCachedBlocks(const FEntryPayload& InPayload)const
+{
+	TArray<uint8> CacheData;
+	{
+		FMemoryWriter CacheWriter(CacheData);
+		uint32 Magic = FHotPatcherPakWriter::BlockCacheMagic;
+		int64 UncompressedSize = InPayload.UncompressedData.Num();
+		TArray<TArray<uint8>> CompressedBlocks = InPayload.CompressedBlocks;
+		CacheWriter << Magic;
+		CacheWriter << UncompressedSize;
+		CacheWriter << CompressedBlocks;
+	}
+
+	// write to a temp file and move,the cache may be shared by parallel builds
+	FString CacheFile = GetBlockCacheFile(InPayload.CacheKey);
+	FString TempCacheFile = FString::Printf(TEXT("%s.%s.tmp"), *CacheFile, *FGuid::NewGuid().ToString());
+	bool bRunStatus = FFileHelper::SaveArrayToFile(CacheData, *TempCacheFile) && IFileManager::Get().Move(*CacheFile, *TempCacheFile, true);
+	if (!bRunStatus)
+	{
+		IFileManager::Get().Delete(*TempCacheFile, false, false, true);
+	}
+	return bRunStatus;
+}
+
+bool FHotPatcherPakWriter::WritePayload(FArchive& InPakWriter, FEntryPayload& InPayload, FPakEntry& OutEntry)
+{
+	const int64 EntryOffset = InPakWriter.Tell();
+
+	// the offset of the entry header in the file is always 0
+	OutEntry.Offset = 0;
+	OutEntry.UncompressedSize = InPayload.UncompressedData.Num();
+	OutEntry.Flags = FPakEntry::Flag_None;
+
+	if (InPayload.bCompressed)
+	{
+		OutEntry.CompressionMethodIndex = Info.GetCompressionMethodIndex(Options.CompressionFormat);
+		OutEntry.CompressionBlockSize = (uint32)FMath::Min<int64>(Options.CompressionBlockSize, OutEntry.UncompressedSize);
+		OutEntry.CompressionBlocks.SetNum(InPayload.CompressedBlocks.Num());
+
+		// block offset is relative to the entry header
+		int64 BlockStart = OutEntry.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
+		FSHA1 EntryHash;
+		for (int32 BlockIndex = 0; BlockIndex < InPayload.CompressedBlocks.Num(); ++BlockIndex)
+		{
+			const TArray<uint8>& CompressedBlock = InPayload.CompressedBlocks[BlockIndex];
+			OutEntry.CompressionBlocks[BlockIndex].CompressedStart = BlockStart;
+			BlockStart += CompressedBlock.Num();
+			OutEntry.CompressionBlocks[BlockIndex].CompressedEnd = BlockStart;
+			EntryHash.Update(CompressedBlock.GetData(), CompressedBlock.Num());
+		}
+		EntryHash.Final();
+		EntryHash.GetHash(OutEntry.Hash);
+		OutEntry.Size = BlockStart - OutEntry.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
+
+		OutEntry.Serialize(InPakWriter, FPakInfo::PakFile_Version_Latest);
+		for (const auto& CompressedBlock : InPayload.CompressedBlocks)
+		{
+			InPakWriter.Serialize((void*)CompressedBlock.GetData(), CompressedBlock.Num());
+		}
+	}
+	else
+	{
+		OutEntry.CompressionMethodIndex = 0;
+		OutEntry.CompressionBlockSize = 0;
+		OutEntry.Size = OutEntry.UncompressedSize;
+		FSHA1::HashBuffer(InPayload.UncompressedData.GetData(), InPayload.UncompressedData.Num(), OutEntry.Hash);
+
+		OutEntry.Serialize(InPakWriter, FPakInfo::PakFile_Version_Latest);
+		InPakWriter.Serialize(InPayload.UncompressedData.GetData(), InPayload.UncompressedData.Num());
+	}
+	OutEntry.Offset = EntryOffset;
+
+	// release the memory of the written file
+	InPayload.UncompressedData.Empty();
+	InPayload.CompressedBlocks.Empty();
+	return !InPakWriter.IsError();
+}
+
+bool FHotPatcherPakWriter::ParseUnrealPakOptions(const TArray<FString>& InOptions, FPakWriterOptions& OutOptions)
+{
+	FPakWriterOptions Result;
+	for (const auto& Option : InOptions)
+	{
+		FString TrimedOption = Option.TrimStartAndEnd();
+		if (TrimedOption.IsEmpty())
+			continue;
+		if (TrimedOption.Equals(TEXT("-compress"), ESearchCase::IgnoreCase))
+		{
+			Result.bCompress = true;
+			continue;
+		}
+		FString Formats;
+		if (FParse::Value(*TrimedOption, TEXT("-compressionformats="), Formats) || FParse::Value(*TrimedOption, TEXT("-compressionformat="), Formats))
+		{
+			TArray<FString> FormatList;
+			Formats.ParseIntoArray(FormatList, TEXT(","), true);
+			for (const auto& Format : FormatList)
+			{
+				if (FCompression::IsFormatValid(*Format))
+				{
+					Result.CompressionFormat = *Format;
+					break;
+				}
+			}
+			continue;
+		}
+		// e.g. -encrypt,-encryptindex,-sign,-cryptokeys=,the pak must be created by UnrealPak
+		UE_LOG(LogTemp, Warning, TEXT("The UnrealPak option %s is not supported by the in process pak writer."), *TrimedOption);
+		return false;
+	}
+	OutOptions = Result;
+	return true;
+}
+
+bool FHotPatcherPakWriter::ParsePakCommand(const FString& InPakCommand, FPakWriteEntry& OutEntry)
+{
+	const TCHAR* CommandStream = *InPakCommand;
+	FString SourceFile;
+	FString DestFile;
+	if (!FParse::Token(CommandStream, SourceFile, false) || !FParse::Token(CommandStream, DestFile, false))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid pak command: %s"), *InPakCommand);
+		return false;
+	}
+	FPaths::NormalizeFilename(DestFile);
+	OutEntry = FPakWriteEntry(SourceFile, DestFile);
+	return true;
+}
+
+bool FHotPatcherPakWriter::ParsePakCommands(const TArray<FString>& InPakCommands, TArray<FPakWriteEntry>& OutEntries)
+{
+	bool bRunStatus = true;
+	for (const auto& PakCommand : InPakCommands)
+	{
+		FPakWriteEntry Entry;
+		if (!FHotPatcherPakWriter::ParsePakCommand(PakCommand, Entry))
+		{
+			bRunStatus = false;
+			continue;
+		}
+		OutEntries.Add(Entry);
+	}
+	return bRunStatus;
+}
+
+FString FHotPatcherPakWriter::GetDefaultBlockCacheDir()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HotPatcher/PakCache")));
+}
+
+FString FHotPatcherPakWriter::GetCommonMountPoint(const TArray<FPakWriteEntry>& InEntries)
+{
+	if (!InEntries.Num())
+		return TEXT("");
+
+	FString CommonPath = InEntries[0].DestFile;
+	for (const auto& Entry : InEntries)
+	{
+		int32 MaxLen = FMath::Min(CommonPath.Len(), Entry.DestFile.Len());
+		int32 CommonLen = 0;
+		while (CommonLen < MaxLen && CommonPath[CommonLen] == Entry.DestFile[CommonLen])
+		{
+			++CommonLen;
+		}
+		CommonPath.LeftInline(CommonLen, false);
+	}
+
+	int32 LastSlashIndex;
+	if (CommonPath.FindLastChar('/', LastSlashIndex))
+	{
+		CommonPath.LeftInline(LastSlashIndex + 1, false);
+	}
+	else
+	{
+		CommonPath = TEXT("/");
+	}
+	return CommonPath;
+}
@@ -2,6 +2,10 @@
 
 
 #include "FlibPakHelper.h"
+#include "FHotPatcherPakWriter.h"
+#include "FHotPatcherDelta.h"
+#include "FHotPatcherProfiler.h"
+#include "HotPatcherTrace.h"
 #include "IPlatformFilePak.h"
 #include "PlatformFilemanager.h"
 #include "AssetManager/FFileArrayDirectoryVisitor.hpp"
@@ -19,6 +23,7 @@ void UFlibPakHelper::ExecMountPak(FString InPakPath, int32 InPakOrder, FString I
 
 bool UFlibPakHelper::MountPak(const FString& PakPath, int32 PakOrder, const FString& InMountPoint)
 {
+	HOTPATCHER_TRACE_SCOPE(MountPak);
 	bool bMounted = false;
 
 	FPakPlatformFile* PakFileMgr = (FPakPlatformFile*)FPlatformFileManager::Get().GetPlatformFile(FPakPlatformFile::GetTypeName());
@@ -30,6 +35,7 @@ bool UFlibPakHelper::MountPak(const FString& PakPath, int32 PakOrder, const FStr
 
 	PakOrder = FMath::Max(0, PakOrder);
 
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if (FPaths::FileExists(PakPath) && FPaths::GetExtension(PakPath) == TEXT("pak"))
 	{
 		bool bIsEmptyMountPoint = InMountPoint.IsEmpty();
@@ -55,6 +61,7 @@ bool UFlibPakHelper::MountPak(const FString& PakPath, int32 PakOrder, const FStr
 
 bool UFlibPakHelper::UnMountPak(const FString& PakPath)
 {
+	HOTPATCHER_TRACE_SCOPE(UnMountPak);
 	bool bMounted = false;
 
 	FPakPlatformFile* PakFileMgr = (FPakPlatformFile*)FPlatformFileManager::Get().GetPlatformFile(FPakPlatformFile::GetTypeName());
@@ -64,6 +71,7 @@ bool UFlibPakHelper::UnMountPak(const FString& PakPath)
 		return false;
 	}
 
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if (!FPaths::FileExists(PakPath))
 		return false;
 	return PakFileMgr->Unmount(*PakPath);
@@ -88,10 +96,12 @@ bool UFlibPakHelper::CreateFileByBytes(const FString& InFile, const TArray<uint8
 
 bool UFlibPakHelper::ScanPlatformDirectory(const FString& InRelativePath, bool bIncludeFile, bool bIncludeDir, bool bRecursively, TArray<FString>& OutResault)
 {
+	HOTPATCHER_TRACE_SCOPE(ScanPlatformDirectory);
 	bool bRunStatus = false;
 	OutResault.Reset();
 
 	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if(PlatformFile.DirectoryExists(*InRelativePath))
 	{
 		TArray<FString> Files;
@@ -100,10 +110,12 @@ bool UFlibPakHelper::ScanPlatformDirectory(const FString& InRelativePath, bool b
 		FFillArrayDirectoryVisitor FallArrayDirVisitor;
 		if (bRecursively)
 		{
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 			PlatformFile.IterateDirectoryRecursively(*InRelativePath, FallArrayDirVisitor);
 		}
 		else 
 		{
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 			PlatformFile.IterateDirectory(*InRelativePath, FallArrayDirVisitor);
 		}
 		Files = FallArrayDirVisitor.Files;
@@ -133,6 +145,7 @@ bool UFlibPakHelper::SerializePakVersionToString(const FPakVersion& InPakVersion
 	bool bRunStatus = false;
 	OutString = TEXT("");
 
+	HOTPATCHER_TRACE_COUNT(JsonAllocations);
 	TSharedPtr<FJsonObject> RootJsonObject = MakeShareable(new FJsonObject);
 	if (UFlibPakHelper::SerializePakVersionToJsonObject(InPakVersion, RootJsonObject))
 	{
@@ -151,6 +164,7 @@ bool UFlibPakHelper::SerializePakVersionToJsonObject(const FPakVersion& InPakVer
 
 	if(OutJsonObject.IsValid())
 	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
 	}
 
@@ -240,6 +254,7 @@ TArray<FString> UFlibPakHelper::ScanExtenPakFiles()
 
 bool UFlibPakHelper::LoadPakDoSomething(const FString& InPakFile, TFunction<bool(const FPakFile*)> InDoSomething)
 {
+	HOTPATCHER_TRACE_SCOPE(LoadPakDoSomething);
 	bool bRunStatus = false;
 	bool bMounted = false;
 	FPakPlatformFile* PakPlatform = (FPakPlatformFile*)&FPlatformFileManager::Get().GetPlatformFile();
@@ -249,6 +264,7 @@ bool UFlibPakHelper::LoadPakDoSomething(const FString& InPakFile, TFunction<bool
 
 	TSharedPtr<FPakFile> PakFile = MakeShareable(new FPakFile(PakPlatform->GetLowerLevel(), *StandardFileName, false));
 
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if (PakPlatform->FileExists(*StandardFileName))
 	{
 		FString MountPoint = PakFile->GetMountPoint();
@@ -285,6 +301,7 @@ bool UFlibPakHelper::LoadPakDoSomething(const FString& InPakFile, TFunction<bool
 
 bool UFlibPakHelper::LoadFilesByPak(const FString& InPakFile, TArray<FString>& OutFiles)
 {
+	HOTPATCHER_TRACE_SCOPE(LoadFilesByPak);
 	bool bRunStatus = false;
 	TArray<FString> AllFiles;
 	auto ScanAllFilesLambda = [&AllFiles](const FPakFile* InPakFileIns)->bool
@@ -292,6 +309,7 @@ bool UFlibPakHelper::LoadFilesByPak(const FString& InPakFile, TArray<FString>& O
 		bool bLambdaRunStatus = false;
 		if (InPakFileIns)
 		{
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 			InPakFileIns->FindFilesAtPath(AllFiles, *InPakFileIns->GetMountPoint(), true, false, true);
 			bLambdaRunStatus = true;
 		}
@@ -304,6 +322,7 @@ bool UFlibPakHelper::LoadFilesByPak(const FString& InPakFile, TArray<FString>& O
 
 bool UFlibPakHelper::LoadVersionInfoByPak(const FString& InPakFile, FPakVersion& OutVersion)
 {
+	HOTPATCHER_TRACE_SCOPE(LoadVersionInfoByPak);
 	bool bRunStatus = false;
 	
 	TArray<FPakVersion> AllVersionInfo;
@@ -316,6 +335,7 @@ bool UFlibPakHelper::LoadVersionInfoByPak(const FString& InPakFile, FPakVersion&
 			TArray<FString> AllVersionDescribleFiles;
 			FString PakMountPoint = InPakFile->GetMountPoint();
 
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 			InPakFile->FindFilesAtPath(AllVersionDescribleFiles, *InPakFile->GetMountPoint(), true, false, true);
 
 			// UE_LOG(LogTemp, Log, TEXT("Scan All Files Lambda:  FindFilesAtPath num is %d."),AllVersionDescribleFiles.Num());
@@ -362,3 +382,40 @@ TArray<FString> UFlibPakHelper::GetAllMountedPaks()
 	return Resault;
 }
 
+bool UFlibPakHelper::CreatePakFile(const FString& InPakFile, const TArray<FString>& InPakCommands, const TArray<FString>& InUnrealPakOptions, const FString& InBlockCacheDir)
+{
+	FPakFileInfo PakFileInfo;
+	return UFlibPakHelper::CreatePakFileWithInfo(InPakFile, InPakCommands, InUnrealPakOptions, InBlockCacheDir, PakFileInfo);
+}
+
+bool UFlibPakHelper::CreatePakFileWithInfo(const FString& InPakFile, const TArray<FString>& InPakCommands, const TArray<FString>& InUnrealPakOptions, const FString& InBlockCacheDir, FPakFileInfo& OutPakFileInfo)
+{
+	HOTPATCHER_TRACE_SCOPE(CreatePakFileWithInfo);
+	HOTPATCHER_SCOPED_TIMER(FString::Printf(TEXT("PakWriter %s"), *FPaths::GetBaseFilename(InPakFile)));
+	// never write an unencrypted or unsigned pak for the options of UnrealPak
+	FPakWriterOptions PakWriterOptions;
+	if (!FHotPatcherPakWriter::ParseUnrealPakOptions(InUnrealPakOptions, PakWriterOptions))
+		return false;
+
+	TArray<FPakWriteEntry> PakEntries;
+	if (!FHotPatcherPakWriter::ParsePakCommands(InPakCommands, PakEntries))
+		return false;
+
+	PakWriterOptions.BlockCacheDir = InBlockCacheDir;
+	FHotPatcherPakWriter PakWriter(InPakFile, PakWriterOptions);
+	if (!PakWriter.Write(PakEntries))
+		return false;
+
+	OutPakFileInfo.FileName = FPaths::GetCleanFilename(InPakFile);
+	OutPakFileInfo.Hash = PakWriter.GetPakHash();
+	OutPakFileInfo.FileSize = PakWriter.GetWrittenSize();
+	OutPakFileInfo.HashChunkSize = PakWriter.GetHashChunkSize();
+	OutPakFileInfo.ChunkHashes = PakWriter.GetChunkHashes();
+	return true;
+}
+
+bool UFlibPakHelper::ApplyDeltaFile(const FString& InBaseFile, const FString& InDeltaFile, const FString& InOutputFile)
+{
+	HOTPATCHER_TRACE_SCOPE(ApplyDeltaFile);
+	return FHotPatcherDelta::ApplyDelta(InBaseFile, InDeltaFile, InOutputFile);
+}
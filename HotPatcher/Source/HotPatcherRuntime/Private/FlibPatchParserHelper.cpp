@@ -3,6 +3,11 @@
 // project header
 #include "FlibPatchParserHelper.h"
 #include "FlibAssetManageHelperEx.h"
+#include "FHotPatcherPakWriter.h"
+#include "FHotPatcherFileHasher.h"
+#include "FHotPatcherPakListWriter.h"
+#include "FHotPatcherProfiler.h"
+#include "HotPatcherTrace.h"
 #include "Struct/AssetManager/FFileArrayDirectoryVisitor.hpp"
 
 // engine header
@@ -14,6 +19,9 @@
 #include "HAL/FileManager.h"
 #include "Engine/EngineTypes.h"
 #include "Misc/Paths.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
 
 TArray<FString> UFlibPatchParserHelper::GetAvailableMaps(FString GameName, bool IncludeEngineMaps, bool Sorted)
 {
@@ -24,11 +32,13 @@ TArray<FString> UFlibPatchParserHelper::GetAvailableMaps(FString GameName, bool
 	const FString WildCard = FString::Printf(TEXT("*%s"), *FPackageName::GetMapPackageExtension());
 
 	// Scan all Content folder, because not all projects follow Content/Maps convention
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	IFileManager::Get().FindFilesRecursive(ProjectMapNames, *FPaths::Combine(*FPaths::RootDir(), *GameName, TEXT("Content")), *WildCard, true, false);
 
 	// didn't find any, let's check the base GameName just in case it is a full path
 	if (ProjectMapNames.Num() == 0)
 	{
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		IFileManager::Get().FindFilesRecursive(ProjectMapNames, *FPaths::Combine(*GameName, TEXT("Content")), *WildCard, true, false);
 	}
 
@@ -39,6 +49,7 @@ TArray<FString> UFlibPatchParserHelper::GetAvailableMaps(FString GameName, bool
 
 	if (IncludeEngineMaps)
 	{
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		IFileManager::Get().FindFilesRecursive(EnginemapNames, *FPaths::Combine(*FPaths::RootDir(), TEXT("Engine"), TEXT("Content"), TEXT("Maps")), *WildCard, true, false);
 
 		for (int32 i = 0; i < EnginemapNames.Num(); i++)
@@ -116,6 +127,7 @@ FString UFlibPatchParserHelper::GetUE4CmdBinary()
 
 bool UFlibPatchParserHelper::SerializeHotPatcherVersionToString(const FHotPatcherVersion& InVersion, FString& OutResault)
 {
+	HOTPATCHER_SCOPED_TIMER(TEXT("SerializeHotPatcherVersion"));
 	bool bRunStatus = false;
 
 	{
@@ -132,7 +144,9 @@ bool UFlibPatchParserHelper::SerializeHotPatcherVersionToString(const FHotPatche
 
 bool UFlibPatchParserHelper::SerializeHotPatcherVersionToJsonObject(const FHotPatcherVersion& InVersion, TSharedPtr<FJsonObject>& OutJsonObject)
 {
+	HOTPATCHER_TRACE_SCOPE(SerializeHotPatcherVersionToJsonObject);
 	bool bRunStatus = false;
+	HOTPATCHER_TRACE_COUNT(JsonAllocations);
 	TSharedPtr<FJsonObject> RootJsonObject = MakeShareable(new FJsonObject);
 	{
 		RootJsonObject->SetStringField(TEXT("VersionId"), InVersion.VersionId);
@@ -144,6 +158,7 @@ bool UFlibPatchParserHelper::SerializeHotPatcherVersionToJsonObject(const FHotPa
 			TArray<TSharedPtr<FJsonValue>> AllIncludeFilterJsonObj;
 			for (const auto& Filter : InVersion.IncludeFilter)
 			{
+				HOTPATCHER_TRACE_COUNT(JsonAllocations);
 				AllIncludeFilterJsonObj.Add(MakeShareable(new FJsonValueString(Filter)));
 			}
 			RootJsonObject->SetArrayField(TEXT("IncludeFilter"), AllIncludeFilterJsonObj);
@@ -154,6 +169,7 @@ bool UFlibPatchParserHelper::SerializeHotPatcherVersionToJsonObject(const FHotPa
 			TArray<TSharedPtr<FJsonValue>> AllIgnoreFilterJsonObj;
 			for (const auto& Filter : InVersion.IgnoreFilter)
 			{
+				HOTPATCHER_TRACE_COUNT(JsonAllocations);
 				AllIgnoreFilterJsonObj.Add(MakeShareable(new FJsonValueString(Filter)));
 			}
 			RootJsonObject->SetArrayField(TEXT("IgnoreFilter"), AllIgnoreFilterJsonObj);
@@ -166,18 +182,21 @@ bool UFlibPatchParserHelper::SerializeHotPatcherVersionToJsonObject(const FHotPa
 			TArray<TSharedPtr<FJsonValue>> AllSpecifyJsonObj;
 			for(const auto& SpeficyAsset: InVersion.IncludeSpecifyAssets)
 			{
+				HOTPATCHER_TRACE_COUNT(JsonAllocations);
 				TSharedPtr<FJsonObject> SpecifyJsonObj = MakeShareable(new FJsonObject);
 				FString LongPackageName;
 				bool bConvStatus = UFLibAssetManageHelperEx::ConvPackagePathToLongPackageName(SpeficyAsset.Asset.ToString(), LongPackageName);
 				SpecifyJsonObj->SetStringField(TEXT("Asset"), bConvStatus?LongPackageName:SpeficyAsset.Asset.ToString());
 				SpecifyJsonObj->SetBoolField(TEXT("bAnalysisAssetDependencies"), SpeficyAsset.bAnalysisAssetDependencies);
+				HOTPATCHER_TRACE_COUNT(JsonAllocations);
 				AllSpecifyJsonObj.Add(MakeShareable(new FJsonValueObject(SpecifyJsonObj)));
 			}
 			RootJsonObject->SetArrayField(TEXT("IncludeSpecifyAssets"), AllSpecifyJsonObj);
 		}
 
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		TSharedPtr<FJsonObject> AssetInfoJsonObject = MakeShareable(new FJsonObject);
-		bool bSerializeAssetInfoStatus = UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(InVersion.AssetInfo, AssetInfoJsonObject, TArray<FString>{TEXT("Script")});
+		bool bSerializeAssetInfoStatus = UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(InVersion.AssetInfo, AssetInfoJsonObject);
 
 		RootJsonObject->SetObjectField(TEXT("AssetInfo"), AssetInfoJsonObject);
 
@@ -192,6 +211,7 @@ bool UFlibPatchParserHelper::SerializeHotPatcherVersionToJsonObject(const FHotPa
 				TSharedPtr<FJsonObject> CurrentFile;
 				if (UFlibPatchParserHelper::SerializeExAssetFileInfoToJsonObject(*InVersion.ExternalFiles.Find(ExFile), CurrentFile))
 				{
+					HOTPATCHER_TRACE_COUNT(JsonAllocations);
 					ExternalFilesJsonObJList.Add(MakeShareable(new FJsonValueObject(CurrentFile)));
 				}
 			}
@@ -217,6 +237,7 @@ bool UFlibPatchParserHelper::DeserializeHotPatcherVersionFromString(const FStrin
 
 bool UFlibPatchParserHelper::DeSerializeHotPatcherVersionFromJsonObject(const TSharedPtr<FJsonObject>& InJsonObject, FHotPatcherVersion& OutVersion)
 {
+	HOTPATCHER_TRACE_SCOPE(DeSerializeHotPatcherVersionFromJsonObject);
 	bool bRunStatus = false;
 	if (InJsonObject.IsValid())
 	{
@@ -284,6 +305,8 @@ bool UFlibPatchParserHelper::DiffVersionAssets(
 	FAssetDependenciesInfo& OutDeleteAsset
 )
 {
+	HOTPATCHER_TRACE_SCOPE(DiffVersionAssets);
+	HOTPATCHER_SCOPED_TIMER(TEXT("DiffVersionAssets"));
 	FAssetDependenciesInfo result;
 	TArray<FString> AddAsset;
 	TArray<FString> ModifyAsset;
@@ -306,11 +329,8 @@ bool UFlibPatchParserHelper::DiffVersionAssets(
 				continue;
 			}
 			{
-				TArray<FString> NewVersionDependAssetsList;
-				InNewVersion.mDependencies.Find(NewVersionAssetModule)->mDependAssetDetails.GetKeys(NewVersionDependAssetsList);
-
-				TArray<FString> BaseVersionDependAssetsList;
-				InBaseVersion.mDependencies.Find(NewVersionAssetModule)->mDependAssetDetails.GetKeys(BaseVersionDependAssetsList);
+				// lookup by the map,the keys array is O(n) per asset
+				const TMap<FString, FAssetDetail>& BaseVersionAssetModuleDetail = InBaseVersion.mDependencies.Find(NewVersionAssetModule)->mDependAssetDetails;
 
 				const TMap<FString,FAssetDetail>& NewVersionAssetModuleDetail = InNewVersion.mDependencies.Find(NewVersionAssetModule)->mDependAssetDetails;
 				TArray<FString> CurrentModuleAssetList;
@@ -319,7 +339,7 @@ bool UFlibPatchParserHelper::DiffVersionAssets(
 				// add to TArray<FString>
 				for (const auto& NewAssetItem : CurrentModuleAssetList)
 				{
-					if (!BaseVersionDependAssetsList.Contains(NewAssetItem))
+					if (!BaseVersionAssetModuleDetail.Contains(NewAssetItem))
 					{
 						FString BelongModuneName = UFLibAssetManageHelperEx::GetAssetBelongModuleName(NewAssetItem);
 						if (!OutAddAsset.mDependencies.Contains(BelongModuneName))
@@ -337,11 +357,17 @@ bool UFlibPatchParserHelper::DiffVersionAssets(
 		for (const auto& BaseVersionAssetModule : InBaseAssetModuleKeysList)
 		{
 			const FAssetDependenciesDetail& BaseVersionModuleAssetsDetail = *InBaseVersion.mDependencies.Find(BaseVersionAssetModule);
-			const FAssetDependenciesDetail& NewVersionModuleAssetsDetail = *InNewVersion.mDependencies.Find(BaseVersionAssetModule);
+			const FAssetDependenciesDetail* NewVersionModuleAssetsDetailPtr = InNewVersion.mDependencies.Find(BaseVersionAssetModule);
 
+			// the whole module is deleted
+			if (!NewVersionModuleAssetsDetailPtr)
+			{
+				OutDeleteAsset.mDependencies.Add(BaseVersionAssetModule, BaseVersionModuleAssetsDetail);
+				continue;
+			}
 
-			if (InNewVersion.mDependencies.Contains(BaseVersionAssetModule))
 			{
+				const FAssetDependenciesDetail& NewVersionModuleAssetsDetail = *NewVersionModuleAssetsDetailPtr;
 				TArray<FString> BeseVersionCurrentModuleAssetListKeys;
 				BaseVersionModuleAssetsDetail.mDependAssetDetails.GetKeys(BeseVersionCurrentModuleAssetListKeys);
 
@@ -384,6 +410,7 @@ bool UFlibPatchParserHelper::DiffVersionExFiles(
 	TArray<FExternAssetFileInfo>& OutDeleteFiles
 )
 {
+	HOTPATCHER_TRACE_SCOPE(DiffVersionExFiles);
 	OutAddFiles.Empty();
 	OutModifyFiles.Empty();
 	OutDeleteFiles.Empty();
@@ -469,12 +496,27 @@ bool UFlibPatchParserHelper::SerializePakFileInfoToJsonObject(const FPakFileInfo
 	bool RunStatus = false;
 	
 	if (!OutJsonObject.IsValid())
+	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
+	}
 	
 	OutJsonObject->SetStringField(TEXT("File"), InFileInfo.FileName);
 	OutJsonObject->SetStringField(TEXT("HASH"),InFileInfo.Hash);
 	OutJsonObject->SetNumberField(TEXT("Size"), InFileInfo.FileSize);
+	if (InFileInfo.ChunkHashes.Num())
+	{
+		OutJsonObject->SetNumberField(TEXT("HashChunkSize"), InFileInfo.HashChunkSize);
+		TArray<TSharedPtr<FJsonValue>> ChunkHashesJsonList;
+		for (const auto& ChunkHash : InFileInfo.ChunkHashes)
+		{
+			HOTPATCHER_TRACE_COUNT(JsonAllocations);
+			ChunkHashesJsonList.Add(MakeShareable(new FJsonValueString(ChunkHash)));
+		}
+		OutJsonObject->SetArrayField(TEXT("ChunkHashes"), ChunkHashesJsonList);
+	}
 
+	HOTPATCHER_TRACE_COUNT(JsonAllocations);
 	TSharedPtr<FJsonObject> PakVersionJsonObject = MakeShareable(new FJsonObject);
 	if (UFlibPakHelper::SerializePakVersionToJsonObject(InFileInfo.PakVersion, PakVersionJsonObject))
 	{
@@ -488,9 +530,11 @@ bool UFlibPatchParserHelper::SerializePakFileInfoListToJsonObject(const TArray<F
 {
 	bool bRunStatus = false;
 
+	HOTPATCHER_TRACE_COUNT(JsonAllocations);
 	TSharedPtr<FJsonObject> RootJsonObj = MakeShareable(new FJsonObject);
 	for (const auto& FileInfoItem : InFileInfoList)
 	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		TSharedPtr<FJsonObject> CurrentFileJsonObj = MakeShareable(new FJsonObject);
 		if (UFlibPatchParserHelper::SerializePakFileInfoToJsonObject(FileInfoItem, CurrentFileJsonObj))
 		{
@@ -502,9 +546,11 @@ bool UFlibPatchParserHelper::SerializePakFileInfoListToJsonObject(const TArray<F
 	return bRunStatus;
 }
 
-bool UFlibPatchParserHelper::SerializePlatformPakInfoToString(const TMap<FString, FPakFileInfo>& InPakFilesMap, FString& OutString)
+bool UFlibPatchParserHelper::SerializePlatformPakInfoToString(const TMap<FString, TArray<FPakFileInfo>>& InPakFilesMap, FString& OutString)
 {
+	HOTPATCHER_SCOPED_TIMER(TEXT("SerializePlatformPakInfo"));
 	bool bRunStatus = false;
+	HOTPATCHER_TRACE_COUNT(JsonAllocations);
 	TSharedPtr<FJsonObject> RootJsonObj = MakeShareable(new FJsonObject);
 
 	bRunStatus = UFlibPatchParserHelper::SerializePlatformPakInfoToJsonObject(InPakFilesMap, RootJsonObj);
@@ -515,11 +561,13 @@ bool UFlibPatchParserHelper::SerializePlatformPakInfoToString(const TMap<FString
 	return bRunStatus;
 }
 
-bool UFlibPatchParserHelper::SerializePlatformPakInfoToJsonObject(const TMap<FString, FPakFileInfo>& InPakFilesMap, TSharedPtr<FJsonObject>& OutJsonObject)
+bool UFlibPatchParserHelper::SerializePlatformPakInfoToJsonObject(const TMap<FString, TArray<FPakFileInfo>>& InPakFilesMap, TSharedPtr<FJsonObject>& OutJsonObject)
 {
+	HOTPATCHER_TRACE_SCOPE(SerializePlatformPakInfoToJsonObject);
 	bool bRunStatus = false;
 	if (!OutJsonObject.IsValid())
 	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
 	}
 
@@ -530,11 +578,29 @@ bool UFlibPatchParserHelper::SerializePlatformPakInfoToJsonObject(const TMap<FSt
 
 		for (const auto& PakPlatformKey : PakPlatformKeys)
 		{
+			const TArray<FPakFileInfo>& PlatformPakFiles = *InPakFilesMap.Find(PakPlatformKey);
+			if (!PlatformPakFiles.Num())
+				continue;
+
+			// the platform is the first pak as before,the chunk paks of platform in order are in "Chunks",001_P,002_P...
 			TSharedPtr<FJsonObject> CurrentPlatformPakJsonObj;
-			if (UFlibPatchParserHelper::SerializePakFileInfoToJsonObject(*InPakFilesMap.Find(PakPlatformKey), CurrentPlatformPakJsonObj))
+			if (!UFlibPatchParserHelper::SerializePakFileInfoToJsonObject(PlatformPakFiles[0], CurrentPlatformPakJsonObj))
+				continue;
+			if (PlatformPakFiles.Num() > 1)
 			{
-				OutJsonObject->SetObjectField(PakPlatformKey, CurrentPlatformPakJsonObj);
+				TArray<TSharedPtr<FJsonValue>> ChunkPakJsonList;
+				for (const auto& PakFileInfo : PlatformPakFiles)
+				{
+					TSharedPtr<FJsonObject> ChunkPakJsonObj;
+					if (UFlibPatchParserHelper::SerializePakFileInfoToJsonObject(PakFileInfo, ChunkPakJsonObj))
+					{
+						HOTPATCHER_TRACE_COUNT(JsonAllocations);
+						ChunkPakJsonList.Add(MakeShareable(new FJsonValueObject(ChunkPakJsonObj)));
+					}
+				}
+				CurrentPlatformPakJsonObj->SetArrayField(TEXT("Chunks"), ChunkPakJsonList);
 			}
+			OutJsonObject->SetObjectField(PakPlatformKey, CurrentPlatformPakJsonObj);
 		}
 		bRunStatus = true;
 	}
@@ -546,8 +612,12 @@ bool UFlibPatchParserHelper::SerializeDiffAssetsInfomationToJsonObject(const FAs
 	const FAssetDependenciesInfo& InDeleteAsset,
 	 TSharedPtr<FJsonObject>& OutJsonObject)
 {
+	HOTPATCHER_TRACE_SCOPE(SerializeDiffAssetsInfomationToJsonObject);
 	if(!OutJsonObject.IsValid())
+	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
+	}
 
 	{
 		// is empty Info
@@ -564,8 +634,9 @@ bool UFlibPatchParserHelper::SerializeDiffAssetsInfomationToJsonObject(const FAs
 			bool bRunStatus = false;
 			if (!IsEmptyInfo(InAssetInfo))
 			{
+				HOTPATCHER_TRACE_COUNT(JsonAllocations);
 				TSharedPtr<FJsonObject> AssetsJsonObject = MakeShareable(new FJsonObject);
-				bRunStatus = UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(InAssetInfo, AssetsJsonObject, TArray<FString>{"Script"});
+				bRunStatus = UFLibAssetManageHelperEx::SerializeAssetDependenciesToJsonObject(InAssetInfo, AssetsJsonObject);
 				if (bRunStatus)
 				{
 					OutJsonObject->SetObjectField(InDescrible, AssetsJsonObject);
@@ -586,6 +657,7 @@ FString UFlibPatchParserHelper::SerializeDiffAssetsInfomationToString(const FAss
 	const FAssetDependenciesInfo& InModifyAsset,
 	const FAssetDependenciesInfo& InDeleteAsset)
 {
+	HOTPATCHER_SCOPED_TIMER(TEXT("SerializeDiffAssetsInfomation"));
 	FString SerializeDiffInfo;
 	TSharedPtr<FJsonObject> RootJsonObject;
 	if (UFlibPatchParserHelper::SerializeDiffAssetsInfomationToJsonObject(InAddAsset, InModifyAsset, InDeleteAsset, RootJsonObject))
@@ -604,12 +676,16 @@ bool UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToJsonObject(
 	TSharedPtr<FJsonObject>& OutJsonObject)
 {
 	if(!OutJsonObject.IsValid())
+	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
+	}
 	auto ParserFilesWithDescribleLambda = [&OutJsonObject](const TArray<FExternAssetFileInfo>& InFiles, const FString& InDescrible)
 	{
 		TArray<TSharedPtr<FJsonValue>> FileJsonValueList;
 		for (const auto& File : InFiles)
 		{
+			HOTPATCHER_TRACE_COUNT(JsonAllocations);
 			FileJsonValueList.Add(MakeShareable(new FJsonValueString(File.MountPath)));
 		}
 		OutJsonObject->SetArrayField(InDescrible, FileJsonValueList);
@@ -627,6 +703,7 @@ FString UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToString(
 	const TArray<FExternAssetFileInfo>& InModifyFiles,
 	const TArray<FExternAssetFileInfo>& InDeleteFiles)
 {
+	HOTPATCHER_SCOPED_TIMER(TEXT("SerializeDiffExternalFilesInfomation"));
 	FString SerializeDiffInfo;
 	TSharedPtr<FJsonObject> RootJsonObject;
 	if (UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToJsonObject(InAddFiles, InModifyFiles, InDeleteFiles,RootJsonObject))
@@ -639,7 +716,9 @@ FString UFlibPatchParserHelper::SerializeDiffExternalFilesInfomationToString(
 }
 bool UFlibPatchParserHelper::GetPakFileInfo(const FString& InFile, FPakFileInfo& OutFileInfo)
 {
+	HOTPATCHER_TRACE_SCOPE(GetPakFileInfo);
 	bool bRunStatus = false;
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if (FPaths::FileExists(InFile))
 	{
 		FString PathPart;
@@ -648,24 +727,324 @@ bool UFlibPatchParserHelper::GetPakFileInfo(const FString& InFile, FPakFileInfo&
 
 		FPaths::Split(InFile, PathPart, FileNamePart, ExtensionPart);
 
-		FMD5Hash CurrentPakHash = FMD5Hash::HashFile(*InFile);
+		// hash the file and chunks in one pass
 		OutFileInfo.FileName = FString::Printf(TEXT("%s.%s"),*FileNamePart,*ExtensionPart);
-		OutFileInfo.Hash = LexToString(CurrentPakHash);
+		OutFileInfo.HashChunkSize = FHotPatcherFileHasher::DefaultChunkSize;
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		OutFileInfo.FileSize = IFileManager::Get().FileSize(*InFile);
-		bRunStatus = true;
+		bRunStatus = FHotPatcherFileHasher::HashFile(InFile, OutFileInfo.Hash, OutFileInfo.ChunkHashes, OutFileInfo.HashChunkSize);
 	}
 	return bRunStatus;
 }
 
+TMap<FString, FString> UFlibPatchParserHelper::GetFilesHash(const TArray<FString>& InFiles)
+{
+	HOTPATCHER_TRACE_SCOPE(GetFilesHash);
+	HOTPATCHER_SCOPED_TIMER(TEXT("GetFilesHash"));
+	TArray<FString> FilesHash;
+	FilesHash.SetNum(InFiles.Num());
+	ParallelFor(InFiles.Num(), [&InFiles, &FilesHash](int32 Index)
+	{
+		FMD5Hash FileHash = FMD5Hash::HashFile(*InFiles[Index]);
+		if (FileHash.IsValid())
+		{
+			FilesHash[Index] = LexToString(FileHash);
+		}
+		if (FHotPatcherProfiler::IsProfiling())
+		{
+			FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::FilesHashed);
+			FHotPatcherProfiler::IncrementCounter(EHotPatcherCounter::BytesRead, FMath::Max<int64>(IFileManager::Get().FileSize(*InFiles[Index]), 0));
+		}
+	});
+
+	TMap<FString, FString> Resault;
+	for (int32 Index = 0; Index < InFiles.Num(); ++Index)
+	{
+		if (!FilesHash[Index].IsEmpty())
+		{
+			Resault.Add(InFiles[Index], FilesHash[Index]);
+		}
+	}
+	return Resault;
+}
+
+bool UFlibPatchParserHelper::SplitSharedPakCommands(TMap<FString, TArray<FString>>& InOutPlatformPakCommands, TArray<FString>& OutSharedPakCommands)
+{
+	HOTPATCHER_TRACE_SCOPE(SplitSharedPakCommands);
+	if (InOutPlatformPakCommands.Num() < 2)
+		return false;
+
+	// mount path to source file of each platform
+	TArray<FString> PlatformNames;
+	InOutPlatformPakCommands.GetKeys(PlatformNames);
+	TArray<TMap<FString, FString>> PlatformMountFiles;
+	PlatformMountFiles.SetNum(PlatformNames.Num());
+	for (int32 PlatformIndex = 0; PlatformIndex < PlatformNames.Num(); ++PlatformIndex)
+	{
+		for (const auto& PakCommand : *InOutPlatformPakCommands.Find(PlatformNames[PlatformIndex]))
+		{
+			FPakWriteEntry Entry;
+			if (FHotPatcherPakWriter::ParsePakCommand(PakCommand, Entry))
+			{
+				PlatformMountFiles[PlatformIndex].Add(Entry.DestFile, Entry.SourceFile);
+			}
+		}
+	}
+
+	// only hash the files exist in all platforms and have the same size
+	TArray<FString> CandidateMountPaths;
+	TArray<FString> CandidateFiles;
+	for (const auto& MountFile : PlatformMountFiles[0])
+	{
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
+		int64 FileSize = IFileManager::Get().FileSize(*MountFile.Value);
+		bool bCandidate = FileSize >= 0;
+		for (int32 PlatformIndex = 1; bCandidate && PlatformIndex < PlatformNames.Num(); ++PlatformIndex)
+		{
+			const FString* SourceFile = PlatformMountFiles[PlatformIndex].Find(MountFile.Key);
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
+			bCandidate = SourceFile && IFileManager::Get().FileSize(**SourceFile) == FileSize;
+		}
+		if (!bCandidate)
+			continue;
+
+		CandidateMountPaths.Add(MountFile.Key);
+		for (const auto& MountFiles : PlatformMountFiles)
+		{
+			CandidateFiles.AddUnique(*MountFiles.Find(MountFile.Key));
+		}
+	}
+
+	TMap<FString, FString> FilesHash = UFlibPatchParserHelper::GetFilesHash(CandidateFiles);
+	TSet<FString> SharedMountPaths;
+	for (const auto& MountPath : CandidateMountPaths)
+	{
+		const FString* BaseHash = FilesHash.Find(*PlatformMountFiles[0].Find(MountPath));
+		bool bShared = !!BaseHash;
+		for (int32 PlatformIndex = 1; bShared && PlatformIndex < PlatformNames.Num(); ++PlatformIndex)
+		{
+			const FString* PlatformHash = FilesHash.Find(*PlatformMountFiles[PlatformIndex].Find(MountPath));
+			bShared = PlatformHash && PlatformHash->Equals(*BaseHash);
+		}
+		if (bShared)
+		{
+			SharedMountPaths.Add(MountPath);
+		}
+	}
+
+	if (!SharedMountPaths.Num())
+		return false;
+
+	// the shared commands use the command of the first platform
+	TSet<FString> AddedSharedMountPaths;
+	for (int32 PlatformIndex = 0; PlatformIndex < PlatformNames.Num(); ++PlatformIndex)
+	{
+		TArray<FString>& PakCommands = *InOutPlatformPakCommands.Find(PlatformNames[PlatformIndex]);
+		PakCommands.RemoveAll([&](const FString& InPakCommand)->bool
+		{
+			FPakWriteEntry Entry;
+			if (!FHotPatcherPakWriter::ParsePakCommand(InPakCommand, Entry) || !SharedMountPaths.Contains(Entry.DestFile))
+				return false;
+			if (!PlatformIndex && !AddedSharedMountPaths.Contains(Entry.DestFile))
+			{
+				AddedSharedMountPaths.Add(Entry.DestFile);
+				OutSharedPakCommands.Add(InPakCommand);
+			}
+			return true;
+		});
+	}
+	UE_LOG(LogTemp, Log, TEXT("%d files are identical in all platforms,move to the shared pak."), SharedMountPaths.Num());
+	return true;
+}
+
+FString UFlibPatchParserHelper::GetPakFingerprint(const TArray<FString>& InPakCommands, const TMap<FString, FString>& InFilesHash, const TArray<FString>& InExtraInputs)
+{
+	HOTPATCHER_TRACE_SCOPE(GetPakFingerprint);
+	FSHA1 Fingerprint;
+	auto UpdateString = [&Fingerprint](const FString& InString)
+	{
+		FTCHARToUTF8 Converter(*InString);
+		Fingerprint.Update((const uint8*)Converter.Get(), Converter.Length());
+		// separator
+		Fingerprint.Update((const uint8*)"\n", 1);
+	};
+
+	for (const auto& ExtraInput : InExtraInputs)
+	{
+		UpdateString(ExtraInput);
+	}
+	// the order of the commands is the layout of pak,so don't sort it
+	for (const auto& PakCommand : InPakCommands)
+	{
+		UpdateString(PakCommand);
+		FPakWriteEntry Entry;
+		if (FHotPatcherPakWriter::ParsePakCommand(PakCommand, Entry))
+		{
+			const FString* FileHash = InFilesHash.Find(Entry.SourceFile);
+			UpdateString(FileHash ? *FileHash : TEXT("None"));
+		}
+	}
+
+	Fingerprint.Final();
+	uint8 Digest[20];
+	Fingerprint.GetHash(Digest);
+	return BytesToHex(Digest, sizeof(Digest));
+}
+
+void UFlibPatchParserHelper::SplitPakCommandsBySize(const TArray<FString>& InPakCommands, int64 InMaxChunkSize, TArray<TArray<FString>>& OutChunks)
+{
+	HOTPATCHER_TRACE_SCOPE(SplitPakCommandsBySize);
+	if (InMaxChunkSize <= 0)
+	{
+		OutChunks.Add(InPakCommands);
+		return;
+	}
+
+	int64 CurrentChunkSize = 0;
+	FString LastPackagePath;
+	for (const auto& PakCommand : InPakCommands)
+	{
+		FPakWriteEntry Entry;
+		FString PackagePath;
+		int64 FileSize = 0;
+		if (FHotPatcherPakWriter::ParsePakCommand(PakCommand, Entry))
+		{
+			PackagePath = FPaths::GetBaseFilename(Entry.DestFile, false);
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
+			FileSize = FMath::Max<int64>(IFileManager::Get().FileSize(*Entry.SourceFile), 0);
+		}
+
+		// .uasset/.uexp/.ubulk of a package are adjacent in the pak commands,don't split them
+		bool bSamePackage = !PackagePath.IsEmpty() && PackagePath == LastPackagePath;
+		if (!OutChunks.Num() || (!bSamePackage && OutChunks.Last().Num() && CurrentChunkSize + FileSize > InMaxChunkSize))
+		{
+			OutChunks.AddDefaulted();
+			CurrentChunkSize = 0;
+		}
+		OutChunks.Last().Add(PakCommand);
+		CurrentChunkSize += FileSize;
+		LastPackagePath = PackagePath;
+	}
+}
+
+bool UFlibPatchParserHelper::LoadPakOrderFile(const FString& InOrderFile, TMap<FString, int32>& OutOrderMap)
+{
+	TArray<FString> OrderLines;
+	if (!FFileHelper::LoadFileToStringArray(OrderLines, *InOrderFile))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Can't load pak order file %s."), *InOrderFile);
+		return false;
+	}
+
+	for (int32 LineIndex = 0; LineIndex < OrderLines.Num(); ++LineIndex)
+	{
+		const TCHAR* LineStream = *OrderLines[LineIndex];
+		FString MountPath;
+		if (!FParse::Token(LineStream, MountPath, false))
+			continue;
+
+		// "path" order,use the line number if there is no order
+		FString OrderStr;
+		int32 Order = FParse::Token(LineStream, OrderStr, false) && OrderStr.IsNumeric() ? FCString::Atoi(*OrderStr) : LineIndex;
+
+		FPaths::NormalizeFilename(MountPath);
+		MountPath.ToLowerInline();
+		if (!OutOrderMap.Contains(MountPath))
+		{
+			OutOrderMap.Add(MountPath, Order);
+		}
+	}
+	return true;
+}
+
+void UFlibPatchParserHelper::SortPakCommandsByOrder(TArray<FString>& InOutPakCommands, const TMap<FString, int32>& InOrderMap)
+{
+	HOTPATCHER_TRACE_SCOPE(SortPakCommandsByOrder);
+	if (!InOrderMap.Num())
+		return;
+
+	struct FOrderedCommand
+	{
+		int32 Order;
+		int32 Index;
+	};
+	TArray<FOrderedCommand> OrderedCommands;
+	OrderedCommands.Reserve(InOutPakCommands.Num());
+	for (int32 Index = 0; Index < InOutPakCommands.Num(); ++Index)
+	{
+		int32 Order = MAX_int32;
+		FPakWriteEntry Entry;
+		if (FHotPatcherPakWriter::ParsePakCommand(InOutPakCommands[Index], Entry))
+		{
+			FString MountPath = Entry.DestFile.ToLower();
+			const int32* FoundOrder = InOrderMap.Find(MountPath);
+			// the .uexp/.ubulk of a package follow the package
+			if (!FoundOrder)
+			{
+				FoundOrder = InOrderMap.Find(FPaths::GetBaseFilename(MountPath, false));
+			}
+			if (FoundOrder)
+			{
+				Order = *FoundOrder;
+			}
+		}
+		OrderedCommands.Add(FOrderedCommand{ Order, Index });
+	}
+
+	OrderedCommands.Sort([](const FOrderedCommand& A, const FOrderedCommand& B)
+	{
+		return A.Order != B.Order ? A.Order < B.Order : A.Index < B.Index;
+	});
+
+	TArray<FString> SortedCommands;
+	SortedCommands.Reserve(InOutPakCommands.Num());
+	for (const auto& OrderedCommand : OrderedCommands)
+	{
+		SortedCommands.Add(MoveTemp(InOutPakCommands[OrderedCommand.Index]));
+	}
+	InOutPakCommands = MoveTemp(SortedCommands);
+}
+
+bool UFlibPatchParserHelper::SavePakListFile(const TArray<FString>& InPakCommands, const FString& InPakListFile)
+{
+	HOTPATCHER_TRACE_SCOPE(SavePakListFile);
+	HOTPATCHER_SCOPED_TIMER(FString::Printf(TEXT("SavePakListFile %s"), *FPaths::GetBaseFilename(InPakListFile)));
+	FHotPatcherPakListWriter PakListWriter(InPakListFile);
+	if (!PakListWriter.IsValid())
+		return false;
+	for (const auto& PakCommand : InPakCommands)
+	{
+		PakListWriter.AddLine(PakCommand);
+	}
+	return PakListWriter.Close();
+}
+
+bool UFlibPatchParserHelper::SavePakOrderFile(const TArray<FString>& InPakCommands, const FString& InOrderFile)
+{
+	TArray<FString> OrderLines;
+	OrderLines.Reserve(InPakCommands.Num());
+	for (const auto& PakCommand : InPakCommands)
+	{
+		FPakWriteEntry Entry;
+		if (FHotPatcherPakWriter::ParsePakCommand(PakCommand, Entry))
+		{
+			OrderLines.Add(FString::Printf(TEXT("\"%s\" %d"), *Entry.DestFile, OrderLines.Num() + 1));
+		}
+	}
+	return FFileHelper::SaveStringArrayToFile(OrderLines, *InOrderFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
 TArray<FString> UFlibPatchParserHelper::GetCookedGlobalShaderCacheFiles(const FString& InProjectDir, const FString& InPlatformName)
 {
 	TArray<FString> Resault;
 	if (UFLibAssetManageHelperEx::IsValidPlatform(InPlatformName))
 	{
 		FString CookedEngineFolder = FPaths::Combine(InProjectDir,TEXT("Saved/Cooked"),InPlatformName,TEXT("Engine"));
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		if (FPaths::DirectoryExists(CookedEngineFolder))
 		{
 			TArray<FString> FoundGlobalShaderCacheFiles;
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 			IFileManager::Get().FindFiles(FoundGlobalShaderCacheFiles, *CookedEngineFolder, TEXT("bin"));
 
 			for (const auto& GlobalShaderCache : FoundGlobalShaderCacheFiles)
@@ -684,6 +1063,7 @@ bool UFlibPatchParserHelper::GetCookedAssetRegistryFiles(const FString& InProjec
 	if (UFLibAssetManageHelperEx::IsValidPlatform(InPlatformName))
 	{
 		FString CookedPAssetRegistryFile = FPaths::Combine(InProjectAbsDir, TEXT("Saved/Cooked"), InPlatformName, InProjectName,TEXT("AssetRegistry.bin"));
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		if (FPaths::FileExists(CookedPAssetRegistryFile))
 		{
 			bRunStatus = true;
@@ -703,9 +1083,11 @@ bool UFlibPatchParserHelper::GetCookedShaderBytecodeFiles(const FString& InProje
 	{
 		FString CookedContentDir = FPaths::Combine(InProjectAbsDir, TEXT("Saved/Cooked"), InPlatformName, InProjectName, TEXT("Content"));
 
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		if (FPaths::DirectoryExists(CookedContentDir))
 		{
 			TArray<FString> ShaderbytecodeFiles;
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 			IFileManager::Get().FindFiles(ShaderbytecodeFiles, *CookedContentDir, TEXT("ushaderbytecode"));
 
 			for (const auto& ShaderByteCodeFile : ShaderbytecodeFiles)
@@ -731,9 +1113,11 @@ TArray<FString> UFlibPatchParserHelper::GetProjectIniFiles(const FString& InProj
 {
 	TArray<FString> Resault;
 	FString ConfigFolder = FPaths::Combine(InProjectDir, TEXT("Config"));
+	HOTPATCHER_TRACE_COUNT_BY(FileSystemProbes, 2);
 	if (FPaths::DirectoryExists(InProjectDir) && FPaths::DirectoryExists(ConfigFolder))
 	{
 		TArray<FString> FoundAllIniFiles;
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		IFileManager::Get().FindFiles(FoundAllIniFiles, *ConfigFolder, TEXT("ini"));
 		
 		for (const auto& IniFile:FoundAllIniFiles)
@@ -747,11 +1131,14 @@ TArray<FString> UFlibPatchParserHelper::GetProjectIniFiles(const FString& InProj
 
 bool UFlibPatchParserHelper::ConvIniFilesToCookCommands(const FString& InEngineAbsDir,const FString& InProjectAbsDir,const FString& InProjectName, const TArray<FString>& InIniFiles, TArray<FString>& OutCommands)
 {
+	HOTPATCHER_TRACE_SCOPE(ConvIniFilesToCookCommands);
 	OutCommands.Reset();
 	bool bRunStatus = false;
+	HOTPATCHER_TRACE_COUNT_BY(FileSystemProbes, 2);
 	if (!FPaths::DirectoryExists(InProjectAbsDir) || !FPaths::DirectoryExists(InEngineAbsDir))
 		return false;
 	FString UProjectFile = FPaths::Combine(InProjectAbsDir, InProjectName + TEXT(".uproject"));
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if (!FPaths::FileExists(UProjectFile))
 		return false;
 
@@ -808,6 +1195,7 @@ bool UFlibPatchParserHelper::ConvIniFilesToCookCommands(const FString& InEngineA
 bool UFlibPatchParserHelper::ConvNotAssetFileToCookCommand(const FString& InProjectDir, const FString& InPlatformName, const FString& InCookedFile, FString& OutCommand)
 {
 	bool bRunStatus = false;
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if (FPaths::FileExists(InCookedFile))
 	{
 		FString CookPlatformAbsPath = FPaths::Combine(InProjectDir, TEXT("Saved/Cooked"), InPlatformName);
@@ -838,13 +1226,16 @@ FString UFlibPatchParserHelper::HashStringWithSHA1(const FString &InString)
 
 TArray<FString> UFlibPatchParserHelper::GetEngineConfigs(const FString& InPlatformName)
 {
+	HOTPATCHER_TRACE_SCOPE(GetEngineConfigs);
 	TArray<FString> Result;
 	const FString EngineConfigAbsDir = FPaths::ConvertRelativePathToFull(FPaths::EngineConfigDir());
 
+	HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 	if (FPaths::DirectoryExists(EngineConfigAbsDir))
 	{
 		FFillArrayDirectoryVisitor Visitor;
 		
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		IFileManager::Get().IterateDirectory(*EngineConfigAbsDir, Visitor);
 
 		for (const auto& IniFile : Visitor.Files)
@@ -862,6 +1253,7 @@ TArray<FString> UFlibPatchParserHelper::GetEngineConfigs(const FString& InPlatfo
 			{
 				FFillArrayDirectoryVisitor PlatformVisitor;
 
+				HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 				IFileManager::Get().IterateDirectory(*PlatformIniDirectory, PlatformVisitor);
 				
 				for (const auto& PlatformIni : PlatformVisitor.Files)
@@ -876,6 +1268,7 @@ TArray<FString> UFlibPatchParserHelper::GetEngineConfigs(const FString& InPlatfo
 
 TArray<FString> UFlibPatchParserHelper::GetEnabledPluginConfigs(const FString& InPlatformName)
 {
+	HOTPATCHER_TRACE_SCOPE(GetEnabledPluginConfigs);
 	TArray<FString> result;
 	TArray<TSharedRef<IPlugin>> AllEnablePlugins = IPluginManager::Get().GetEnabledPlugins();
 
@@ -886,9 +1279,11 @@ TArray<FString> UFlibPatchParserHelper::GetEnabledPluginConfigs(const FString& I
 		{
 			FString PluginIniPath = FPaths::Combine(PluginAbsPath, TEXT("Config"));
 			
+			HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 			if (FPaths::DirectoryExists(PluginIniPath))
 			{
 				FFillArrayDirectoryVisitor PluginIniVisitor;
+				HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 				IFileManager::Get().IterateDirectory(*PluginIniPath, PluginIniVisitor);
 
 				for (const auto& IniFile : PluginIniVisitor.Files)
@@ -903,6 +1298,7 @@ TArray<FString> UFlibPatchParserHelper::GetEnabledPluginConfigs(const FString& I
 					if (InPlatformName.Contains(ChildFolderName))
 					{
 						FFillArrayDirectoryVisitor PluginChildIniVisitor;
+						HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 						IFileManager::Get().IterateDirectoryRecursively(*IniDir, PluginChildIniVisitor);
 						
 						for (const auto& IniFile : PluginChildIniVisitor.Files)
@@ -925,6 +1321,7 @@ TArray<FString> UFlibPatchParserHelper::GetEnabledPluginConfigs(const FString& I
 
 TArray<FExternAssetFileInfo> UFlibPatchParserHelper::ParserExDirectoryAsExFiles(const TArray<FExternDirectoryInfo>& InExternDirectorys)
 {
+	HOTPATCHER_TRACE_SCOPE(ParserExDirectoryAsExFiles);
 	TArray<FExternAssetFileInfo> result;
 
 	if (!InExternDirectorys.Num())
@@ -934,6 +1331,7 @@ TArray<FExternAssetFileInfo> UFlibPatchParserHelper::ParserExDirectoryAsExFiles(
 	{
 		FString DirAbsPath = FPaths::ConvertRelativePathToFull(DirectoryItem.DirectoryPath.Path);
 		FPaths::MakeStandardFilename(DirAbsPath);
+		HOTPATCHER_TRACE_COUNT(FileSystemProbes);
 		if (!DirAbsPath.IsEmpty() && FPaths::DirectoryExists(DirAbsPath))
 		{
 			TArray<FString> DirectoryAllFiles;
@@ -984,6 +1382,7 @@ bool UFlibPatchParserHelper::SerializeExAssetFileInfoToJsonObject(const FExternA
 
 	if (!OutJsonObject.IsValid())
 	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
 	}
 	FString FileAbsPath = FPaths::ConvertRelativePathToFull(InExFileInfo.FilePath.FilePath);
@@ -1002,6 +1401,7 @@ bool UFlibPatchParserHelper::SerializeExDirectoryInfoToJsonObject(const FExternD
 
 	if (!OutJsonObject.IsValid())
 	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
 	}
 	FString DirectoryAbsPath = FPaths::ConvertRelativePathToFull(InExDirectoryInfo.DirectoryPath.Path);
@@ -1018,6 +1418,7 @@ bool UFlibPatchParserHelper::SerializeSpecifyAssetInfoToJsonObject(const FPatche
 
 	if (!OutJsonObject.IsValid())
 	{
+		HOTPATCHER_TRACE_COUNT(JsonAllocations);
 		OutJsonObject = MakeShareable(new FJsonObject);
 	}
 	OutJsonObject->SetStringField(TEXT("Asset"), InSpecifyAsset.Asset.GetLongPackageName());
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+
+/**
+ * Binary delta between two versions of a file,e.g. the pak of the last release and the new one.
+ * The delta is a list of copy(from the base file) and add(new bytes) operations,blocks are matched by rolling hash.
+ *
+ * Delta file:
+ *	Magic,Version,BlockSize,BaseSize,BaseHash(SHA1),NewSize,NewHash(SHA1)
+ *	Copy: EDeltaOp::Copy,int64 BaseOffset,int64 Size
+ *	Add: EDeltaOp::Add,int32 Size,bytes
+ *	EDeltaOp::End
+ */
+class HOTPATCHERRUNTIME_API FHotPatcherDelta
+{
+public:
+	static bool CreateDelta(const FString& InBaseFile, const FString& InNewFile, const FString& InDeltaFile, int32 InBlockSize = DefaultBlockSize);
+	// rebuild the new file by the base file and the delta,read and write with bounded memory
+	static bool ApplyDelta(const FString& InBaseFile, const FString& InDeltaFile, const FString& InOutputFile);
+	static bool IsDeltaFile(const FString& InFile);
+
+	static const uint32 DeltaMagic = 0x54445048; // "HPDT"
+	static const int32 DeltaVersion = 1;
+	static const int32 DefaultBlockSize = 16 * 1024;
+
+protected:
+	enum class EDeltaOp : uint8
+	{
+		Copy = 0,
+		Add = 1,
+		End = 2
+	};
+
+	struct FDeltaHeader
+	{
+		uint32 Magic = DeltaMagic;
+		int32 Version = DeltaVersion;
+		int32 BlockSize = DefaultBlockSize;
+		int64 BaseSize = 0;
+		uint8 BaseHash[20] = { 0 };
+		int64 NewSize = 0;
+		uint8 NewHash[20] = { 0 };
+
+		void Serialize(FArchive& Ar);
+	};
+};
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+
+/**
+ * MD5 of the whole file and of every fixed size chunk,updated by the data in order.
+ * So the file can be hashed while writing,and the downloader can verify and resume by chunk.
+ */
+class HOTPATCHERRUNTIME_API FHotPatcherFileHasher
+{
+public:
+	explicit FHotPatcherFileHasher(int32 InChunkSize = DefaultChunkSize);
+
+	void Update(const uint8* InData, int64 InSize);
+	// the hash string is same as LexToString(FMD5Hash::HashFile)
+	void Final(FString& OutFileHash, TArray<FString>& OutChunkHashes);
+
+	FORCEINLINE int32 GetChunkSize()const { return ChunkSize; }
+	FORCEINLINE int64 GetTotalSize()const { return TotalSize; }
+
+	// read the file once,hashing is overlapped with reading
+	static bool HashFile(const FString& InFile, FString& OutFileHash, TArray<FString>& OutChunkHashes, int32 InChunkSize = DefaultChunkSize);
+
+	static const int32 DefaultChunkSize = 64 * 1024 * 1024;
+
+private:
+	FMD5 FileMd5;
+	FMD5 ChunkMd5;
+	int32 ChunkSize;
+	int64 ChunkOffset;
+	int64 TotalSize;
+	TArray<FString> ChunkHashes;
+};
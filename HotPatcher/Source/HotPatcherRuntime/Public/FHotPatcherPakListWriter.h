@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+/**
+ * Write the pak list(UnrealPak response file) line by line as UTF-8,the lines are not kept in memory.
+ * The command prefixes of cooked files are precomputed,so the line is written by pieces without building a FString.
+ */
+class HOTPATCHERRUNTIME_API FHotPatcherPakListWriter
+{
+public:
+	explicit FHotPatcherPakListWriter(const FString& InPakListFile);
+	~FHotPatcherPakListWriter();
+
+	FORCEINLINE bool IsValid()const { return Writer.IsValid(); }
+	FORCEINLINE int32 GetLineNum()const { return LineNum; }
+
+	// "CookedRootDir/ and " "../../../,used by AddCookedFile
+	void SetCookedRootDir(const FString& InCookedRootDir);
+	// InCookedRelativeFile is relative to the cooked root dir,e.g. PROJECT_NAME/Content/BP_Actor.uasset
+	void AddCookedFile(const FString& InCookedRelativeFile);
+	// "AbsPath" "MountPath"
+	void AddPakCommand(const FString& InAbsPath, const FString& InMountPath);
+	void AddLine(const FString& InLine);
+
+	bool Close();
+
+	static const int32 BufferSize = 1024 * 1024;
+
+protected:
+	void Append(const TCHAR* InStr, int32 InLen);
+	FORCEINLINE void Append(const FString& InStr) { Append(*InStr, InStr.Len()); }
+	void EndLine();
+	void Flush();
+
+private:
+	FString PakListFile;
+	TUniquePtr<FArchive> Writer;
+	TArray<ANSICHAR> Buffer;
+	FString CookedAbsPathPrefix;
+	int32 LineNum;
+};
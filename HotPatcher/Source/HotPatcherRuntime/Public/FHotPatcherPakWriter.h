@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// engine header
+#include "CoreMinimal.h"
+#include "IPlatformFilePak.h"
+
+// a resolved file add to pak
+struct FPakWriteEntry
+{
+	FPakWriteEntry() = default;
+	FPakWriteEntry(const FString& InSourceFile, const FString& InDestFile)
+		: SourceFile(InSourceFile), DestFile(InDestFile) {}
+
+	// absolute path on disk
+	FString SourceFile;
+	// path in pak,e.g ../../../PROJECT_NAME/Content/BP_Actor.uasset
+	FString DestFile;
+};
+
+struct FPakWriterOptions
+{
+	bool bCompress = false;
+	FName CompressionFormat = NAME_Zlib;
+	int32 CompressionBlockSize = FPakInfo::MaxChunkDataSize;
+	// max bytes of source files read and compressed at the same time
+	int64 MaxBatchSize = 256 * 1024 * 1024;
+	// the compressed blocks of files are cached in the directory and reused by later builds,empty is disabled
+	FString BlockCacheDir;
+};
+
+/**
+ * Write the resolved file list to a .pak,the format version is same as the UnrealPak of the engine.
+ * Compression blocks of a batch of files are compressed on the worker pool,and written to disk in order.
+ */
+class HOTPATCHERRUNTIME_API FHotPatcherPakWriter
+{
+public:
+	FHotPatcherPakWriter(const FString& InPakFile, const FPakWriterOptions& InOptions);
+
+	bool Write(const TArray<FPakWriteEntry>& InEntries);
+
+	// hashes of the written pak,computed while writing,valid after Write successed
+	FORCEINLINE const FString& GetPakHash()const { return PakHash; }
+	FORCEINLINE const TArray<FString>& GetChunkHashes()const { return ChunkHashes; }
+	FORCEINLINE int32 GetHashChunkSize()const { return HashChunkSize; }
+	FORCEINLINE int64 GetWrittenSize()const { return WrittenSize; }
+
+	// parse UnrealPak options,e.g. -compress -compressionformats=Oodle
+	// return false if any option isn't supported,e.g. -encrypt -sign,the pak must be created by UnrealPak
+	static bool ParseUnrealPakOptions(const TArray<FString>& InOptions, FPakWriterOptions& OutOptions);
+	// parse "AbsPath" "MountPath" pak command lines
+	static bool ParsePakCommand(const FString& InPakCommand, FPakWriteEntry& OutEntry);
+	static bool ParsePakCommands(const TArray<FString>& InPakCommands, TArray<FPakWriteEntry>& OutEntries);
+	static FString GetCommonMountPoint(const TArray<FPakWriteEntry>& InEntries);
+
+	// Saved/HotPatcher/PakCache
+	static FString GetDefaultBlockCacheDir();
+	// small files are fast to compress,not cached
+	static const int32 MinCachedFileSize = 64 * 1024;
+	static const uint32 BlockCacheMagic = 0x43425048; // "HPBC"
+
+protected:
+	struct FEntryPayload
+	{
+		const FPakWriteEntry* Entry = nullptr;
+		TArray<uint8> UncompressedData;
+		TArray<TArray<uint8>> CompressedBlocks;
+		bool bReadSuccessed = false;
+		bool bCompressed = false;
+		// SHA1 of the file and the compression settings
+		FString CacheKey;
+		bool bCacheHit = false;
+	};
+
+	bool LoadAndCompressBatch(TArray<FEntryPayload>& InOutBatch)const;
+	FString GetBlockCacheFile(const FString& InCacheKey)const;
+	bool LoadCachedBlocks(FEntryPayload& InOutPayload)const;
+	bool SaveCachedBlocks(const FEntryPayload& InPayload)const;
+	bool WritePayload(FArchive& InPakWriter, FEntryPayload& InPayload, FPakEntry& OutEntry);
+
+private:
+	FString PakFile;
+	FPakWriterOptions Options;
+	FPakInfo Info;
+	FString PakHash;
+	TArray<FString> ChunkHashes;
+	int32 HashChunkSize = 0;
+	int64 WrittenSize = 0;
+};
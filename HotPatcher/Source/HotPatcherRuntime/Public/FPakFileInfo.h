@@ -20,4 +20,9 @@ public:
 	int32 FileSize;
 	UPROPERTY(EditAnywhere,BlueprintReadWrite)
 	FPakVersion PakVersion;
+	// md5 of every HashChunkSize bytes,for verify and resume download by chunk
+	UPROPERTY(EditAnywhere,BlueprintReadWrite)
+	int32 HashChunkSize = 0;
+	UPROPERTY(EditAnywhere,BlueprintReadWrite)
+	TArray<FString> ChunkHashes;
 };
\ No newline at end of file
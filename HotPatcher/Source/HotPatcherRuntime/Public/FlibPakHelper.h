@@ -2,6 +2,7 @@
 #pragma once
 
 #include "FPakVersion.h"
+#include "FPakFileInfo.h"
 
 // Engine Header
 #include "CoreMinimal.h"
@@ -60,4 +61,15 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|Pak")
 		static TArray<FString> GetAllMountedPaks();
+
+	// create pak in process,InPakCommands is same as the UnrealPak response file,e.g. "AbsPath" "MountPath"
+	// the compressed blocks are reused from InBlockCacheDir if not empty
+	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|Pak", meta = (AdvancedDisplay = "InBlockCacheDir"))
+		static bool CreatePakFile(const FString& InPakFile, const TArray<FString>& InPakCommands, const TArray<FString>& InUnrealPakOptions, const FString& InBlockCacheDir = TEXT(""));
+	// same as CreatePakFile,the pak is hashed while writing so it needn't read again
+	static bool CreatePakFileWithInfo(const FString& InPakFile, const TArray<FString>& InPakCommands, const TArray<FString>& InUnrealPakOptions, const FString& InBlockCacheDir, FPakFileInfo& OutPakFileInfo);
+
+	// rebuild the new pak by the local pak and the downloaded delta file
+	UFUNCTION(BlueprintCallable, Category = "GWorld|Flib|Pak")
+		static bool ApplyDeltaFile(const FString& InBaseFile, const FString& InDeltaFile, const FString& InOutputFile);
 };
@@ -65,8 +65,9 @@ public:
 
 		static bool SerializePakFileInfoListToJsonObject(const TArray<FPakFileInfo>& InFileInfoList, TSharedPtr<FJsonObject>& OutJsonObject);
 		
-		static bool SerializePlatformPakInfoToString(const TMap<FString, FPakFileInfo>& InPakFilesMap, FString& OutString);
-		static bool SerializePlatformPakInfoToJsonObject(const TMap<FString, FPakFileInfo>& InPakFilesMap, TSharedPtr<FJsonObject>& OutJsonObject);
+		static bool SerializePlatformPakInfoToString(const TMap<FString, TArray<FPakFileInfo>>& InPakFilesMap, FString& OutString);
+		// the single pak of platform is an object,the chunk paks are in the "Chunks" of the first pak
+		static bool SerializePlatformPakInfoToJsonObject(const TMap<FString, TArray<FPakFileInfo>>& InPakFilesMap, TSharedPtr<FJsonObject>& OutJsonObject);
 
 		static bool SerializeDiffAssetsInfomationToJsonObject(const FAssetDependenciesInfo& InAddAsset,
 				const FAssetDependenciesInfo& InModifyAsset,
@@ -93,6 +94,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "HotPatcher|Flib")
 		static bool GetPakFileInfo(const FString& InFile,FPakFileInfo& OutFileInfo);
 
+	// MD5 of the files,key is the file path,hash on all cores
+	UFUNCTION(BlueprintCallable, Category = "HotPatcher|Flib")
+		static TMap<FString, FString> GetFilesHash(const TArray<FString>& InFiles);
+	// move the files have same mount path and same content in all platforms to OutSharedPakCommands
+	static bool SplitSharedPakCommands(TMap<FString, TArray<FString>>& InOutPlatformPakCommands, TArray<FString>& OutSharedPakCommands);
+	// SHA1 of the pak commands,the content hash of every source file and the extra inputs,e.g. UnrealPak options
+	static FString GetPakFingerprint(const TArray<FString>& InPakCommands, const TMap<FString, FString>& InFilesHash, const TArray<FString>& InExtraInputs);
+
+	// split the pak commands by the total size of the source files,the files of a package are kept in the same chunk,InMaxChunkSize <= 0 is no limit
+	static void SplitPakCommandsBySize(const TArray<FString>& InPakCommands, int64 InMaxChunkSize, TArray<TArray<FString>>& OutChunks);
+	// load the open order file,e.g. GameOpenOrder.log generated by -fileopenlog,key is the lower mount path
+	static bool LoadPakOrderFile(const FString& InOrderFile, TMap<FString, int32>& OutOrderMap);
+	// files not in the order map are placed at the end and keep the original order
+	static void SortPakCommandsByOrder(TArray<FString>& InOutPakCommands, const TMap<FString, int32>& InOrderMap);
+	// save the order of the pak commands as the UnrealPak -order file
+	static bool SavePakOrderFile(const TArray<FString>& InPakCommands, const FString& InOrderFile);
+	// write the pak commands as UTF-8 lines,without joining them to one string
+	static bool SavePakListFile(const TArray<FString>& InPakCommands, const FString& InPakListFile);
+
 	// Cooked/PLATFORM_NAME/Engine/GlobalShaderCache-*.bin
 	UFUNCTION(BlueprintCallable, Category = "HotPatcher|Flib")
 		static TArray<FString> GetCookedGlobalShaderCacheFiles(const FString& InProjectDir,const FString& InPlatformName);